@@ -0,0 +1,257 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <eddsa_comb/eddsa_comb.h>
+#include <monocypher/monocypher.h>
+#include <stdint.h>
+#include <tkey/assert.h>
+#include <tkey/io.h>
+#include <tkey/led.h>
+#include <tkey/lib.h>
+#include <tkey/tk1_mem.h>
+
+// Cycle count benchmark of the Curve25519 functions in Monocypher.
+//
+// Press any key on CDC to run. It prints the cycles used by
+// crypto_eddsa_sign(), crypto_eddsa_check() and crypto_x25519(), and
+// whether the signature checked out. Build tkey-libs with and without
+// TKEY_FE_RV32=1 to compare the field arithmetic.
+//
+// Then it prints the cycles used by checking N = 1, 8 and 32
+// signatures one by one and with crypto_eddsa_check_batch(), and
+// whether the batch found the one signature made invalid.
+//
+// With tkey-libs built with TKEY_EDDSA_COMB=1 it then sets up the
+// wide comb table, generated on the first run and read from the app's
+// flash storage area on later ones, prints the cycles of that and of
+// signing with the table, and checks that the signature is the same.
+
+// clang-format off
+static volatile uint32_t *timer           = (volatile uint32_t *)TK1_MMIO_TIMER_TIMER;
+static volatile uint32_t *timer_prescaler = (volatile uint32_t *)TK1_MMIO_TIMER_PRESCALER;
+static volatile uint32_t *timer_ctrl      = (volatile uint32_t *)TK1_MMIO_TIMER_CTRL;
+static volatile uint32_t *trng_status     = (volatile uint32_t *)TK1_MMIO_TRNG_STATUS;
+static volatile uint32_t *trng_entropy    = (volatile uint32_t *)TK1_MMIO_TRNG_ENTROPY;
+// clang-format on
+
+#define BATCH_MAX 32
+
+static uint8_t message[128];
+static uint8_t secret_key[64];
+static uint8_t public_key[32];
+static uint8_t signature[64];
+static uint8_t comb_signature[64];
+static crypto_eddsa_comb comb;
+
+static uint8_t batch_messages[BATCH_MAX][sizeof(message)];
+static uint8_t batch_signatures[BATCH_MAX][64];
+static const uint8_t *signatures[BATCH_MAX];
+static const uint8_t *public_keys[BATCH_MAX];
+static const uint8_t *messages[BATCH_MAX];
+static size_t message_sizes[BATCH_MAX];
+static int status[BATCH_MAX];
+
+static void timer_start(void)
+{
+	*timer_ctrl = (1 << TK1_MMIO_TIMER_CTRL_STOP_BIT);
+	*timer_prescaler = 1;
+	*timer = 0xffffffff;
+	*timer_ctrl = (1 << TK1_MMIO_TIMER_CTRL_START_BIT);
+}
+
+static void putdec(uint32_t n)
+{
+	char buf[11] = {0};
+	int i = sizeof(buf) - 1;
+
+	do {
+		buf[--i] = '0' + n % 10;
+		n /= 10;
+	} while (n > 0);
+
+	puts(IO_CDC, &buf[i]);
+}
+
+static void result(const char *name, uint32_t cycles)
+{
+	puts(IO_CDC, name);
+	puts(IO_CDC, ": ");
+	putdec(cycles);
+	puts(IO_CDC, "\r\n");
+}
+
+static uint32_t bench_sign(uint8_t sig[64])
+{
+	uint32_t start = *timer;
+
+	crypto_eddsa_sign(sig, secret_key, message, sizeof(message));
+
+	return start - *timer;
+}
+
+static uint32_t bench_comb_setup(int *ok)
+{
+	uint32_t start = *timer;
+
+	*ok = eddsa_comb_setup(&comb, 0) == 0;
+
+	return start - *timer;
+}
+
+static uint32_t bench_check(int *ok)
+{
+	uint32_t start = *timer;
+
+	*ok = crypto_eddsa_check(signature, public_key, message,
+				 sizeof(message)) == 0;
+
+	return start - *timer;
+}
+
+static void trng_read(uint8_t *buf, size_t len)
+{
+	for (size_t i = 0; i < len; i += 4) {
+		while ((*trng_status & (1 << TK1_MMIO_TRNG_STATUS_READY_BIT)) ==
+		       0) {
+		}
+		uint32_t rnd = *trng_entropy;
+		memcpy(&buf[i], &rnd, 4);
+	}
+}
+
+static uint32_t bench_check_each(size_t n)
+{
+	uint32_t start = *timer;
+
+	for (size_t i = 0; i < n; i++) {
+		status[i] = crypto_eddsa_check(signatures[i], public_keys[i],
+					       messages[i], message_sizes[i]);
+	}
+
+	return start - *timer;
+}
+
+static uint32_t bench_check_batch(size_t n, int *ok)
+{
+	uint8_t random[32];
+	uint32_t start;
+
+	trng_read(random, sizeof(random));
+	start = *timer;
+
+	*ok = crypto_eddsa_check_batch(status, signatures, public_keys,
+				       messages, message_sizes, n,
+				       random) == 0;
+
+	return start - *timer;
+}
+
+static void run_batch(void)
+{
+	static const size_t sizes[] = {1, 8, BATCH_MAX};
+	int ok = 0;
+	int failed = 0;
+
+	for (size_t i = 0; i < BATCH_MAX; i++) {
+		memcpy(batch_messages[i], message, sizeof(message));
+		batch_messages[i][0] = (uint8_t)i;
+		crypto_eddsa_sign(batch_signatures[i], secret_key,
+				  batch_messages[i], sizeof(message));
+		signatures[i] = batch_signatures[i];
+		public_keys[i] = public_key;
+		messages[i] = batch_messages[i];
+		message_sizes[i] = sizeof(message);
+	}
+
+	puts(IO_CDC, "eddsa check N: each batch (cycles)\r\n");
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		puts(IO_CDC, "N = ");
+		putdec(sizes[i]);
+		puts(IO_CDC, ": ");
+		putdec(bench_check_each(sizes[i]));
+		putchar(IO_CDC, ' ');
+		putdec(bench_check_batch(sizes[i], &ok));
+		puts(IO_CDC, ok ? "\r\n" : " FAIL\r\n");
+	}
+
+	// The batch has to fail, and tell which one
+	batch_messages[5][1] ^= 1;
+	(void)bench_check_batch(BATCH_MAX, &ok);
+	batch_messages[5][1] ^= 1;
+	failed = ok;
+	for (size_t i = 0; i < BATCH_MAX; i++) {
+		failed |= status[i] != (i == 5 ? -1 : 0);
+	}
+
+	puts(IO_CDC, "check batch: ");
+	puts(IO_CDC, failed ? "FAIL" : "ok");
+	puts(IO_CDC, "\r\n");
+}
+
+static uint32_t bench_x25519(void)
+{
+	static const uint8_t secret[32] = {3};
+	uint8_t shared[32] = {0};
+	uint32_t start = *timer;
+
+	crypto_x25519(shared, secret, public_key);
+
+	return start - *timer;
+}
+
+static void run(void)
+{
+	uint8_t seed[32] = {0};
+	int ok = 0;
+
+	for (size_t i = 0; i < sizeof(message); i++) {
+		message[i] = (uint8_t)i;
+	}
+	seed[0] = 1;
+	crypto_eddsa_key_pair(secret_key, public_key, seed);
+
+	timer_start();
+
+	puts(IO_CDC, "\r\nbench: cycles\r\n");
+	result("eddsa sign 128 bytes ", bench_sign(signature));
+	result("eddsa check 128 bytes", bench_check(&ok));
+	result("x25519               ", bench_x25519());
+
+	puts(IO_CDC, "check: ");
+	puts(IO_CDC, ok ? "ok" : "FAIL");
+	puts(IO_CDC, "\r\n");
+
+	run_batch();
+
+	result("eddsa comb setup     ", bench_comb_setup(&ok));
+	if (!ok) {
+		puts(IO_CDC, "eddsa comb: needs TKEY_EDDSA_COMB=1\r\n");
+		return;
+	}
+	result("eddsa sign comb      ", bench_sign(comb_signature));
+	eddsa_comb_stop();
+
+	puts(IO_CDC, "check comb: ");
+	puts(IO_CDC,
+	     memeq(comb_signature, signature, sizeof(signature)) ? "ok"
+								 : "FAIL");
+	puts(IO_CDC, "\r\n");
+}
+
+int main(void)
+{
+	uint8_t in = 0;
+
+	config_endpoints(IO_CDC);
+
+	for (;;) {
+		led_set(LED_BLUE);
+
+		if (readfull(IO_CDC, &in, 1, 1) < 0) {
+			assert(1 == 2);
+		}
+
+		led_set(LED_GREEN);
+		run();
+	}
+}
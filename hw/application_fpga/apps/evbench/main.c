@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tkey/assert.h>
+#include <tkey/event.h>
+#include <tkey/io.h>
+#include <tkey/led.h>
+#include <tkey/lib.h>
+
+// Event loop benchmark, used with +evbench in the Verilator model, see
+// "Verilator simulation" in the firmware README.
+//
+// A FIDO request is a single byte: 'y' to do the long work while
+// yielding to other events, 'n' to do it without yielding. We answer
+// with 'd' when done. Anything on CDC is echoed back immediately.
+// The client measures the CDC round trip while FIDO requests are
+// being served.
+#define WORK_CHUNKS 64
+#define WORK_LOOPS 2000
+
+static void work(uint32_t n)
+{
+	for (volatile uint32_t i = 0; i < n; i++)
+		;
+}
+
+static void fido(enum ioend endpoint, uint8_t len, void *arg)
+{
+	const uint8_t *req = NULL;
+	bool yield = false;
+
+	if (readview(endpoint, &req, &len) != 0) {
+		assert(1 == 2);
+	}
+	yield = req[0] == 'y';
+	release();
+
+	// Pretend to sign something
+	for (int i = 0; i < WORK_CHUNKS; i++) {
+		work(WORK_LOOPS);
+		if (yield) {
+			ev_yield();
+		}
+	}
+
+	write(IO_FIDO, (const uint8_t *)"d", 1);
+}
+
+static void cdc(enum ioend endpoint, uint8_t len, void *arg)
+{
+	const uint8_t *data = NULL;
+
+	if (readview(endpoint, &data, &len) != 0) {
+		assert(1 == 2);
+	}
+	write(IO_CDC, data, len);
+	release();
+}
+
+static void blink(void *arg)
+{
+	static bool on = false;
+
+	on = !on;
+	led_set(on ? LED_GREEN : LED_BLACK);
+}
+
+int main(void)
+{
+	struct ev_timer led_timer;
+
+	config_endpoints(IO_CDC | IO_FIDO);
+
+	ev_init();
+
+	if (ev_io(IO_FIDO, fido, NULL) != 0 || ev_io(IO_CDC, cdc, NULL) != 0) {
+		assert(1 == 2);
+	}
+	ev_timer_start(&led_timer, 500, 500, blink, NULL);
+
+	ev_run();
+
+	assert(1 == 2);
+}
@@ -8,7 +8,6 @@
 #include <tkey/led.h>
 #include <tkey/lib.h>
 
-#define BUFSIZE 256
 #define HEADER_SIZE 2
 #define HID_PACKET_SIZE 64
 #define MAX_PAYLOAD_SIZE 64
@@ -20,10 +19,23 @@ void sleep(uint32_t n)
 		;
 }
 
+// Send what came on endpoint src to the debug endpoint, prefixed
+// with src and the length.
+static void loopback(enum ioend src, const uint8_t *packet, uint8_t len)
+{
+	uint8_t hdr[2] = {src, len};
+	struct iovec iov[2] = {
+	    {hdr, sizeof(hdr)},
+	    {packet, len},
+	};
+
+	writev(IO_DEBUG, iov, 2);
+}
+
 int main(void)
 {
 	uint8_t available = 0;
-	uint8_t cmdbuf[BUFSIZE] = {0};
+	const uint8_t *packet = NULL;
 	enum ioend endpoint = IO_NONE;
 	bool waiting_for_more_data = false;
 	uint8_t dest_endpoint = IO_NONE;
@@ -49,36 +61,27 @@ int main(void)
 
 		switch (endpoint) {
 		case IO_CDC:
-			cmdbuf[0] = IO_CDC;
-			cmdbuf[1] = available;
-			if (read(IO_CDC, cmdbuf + 2, BUFSIZE - 2, available) <
-			    0) {
+			if (readview(IO_CDC, &packet, &available) != 0) {
 				assert(1 == 2);
 			}
-			write(IO_DEBUG, cmdbuf, available + 2);
-			memset(cmdbuf, 0, BUFSIZE);
+			loopback(IO_CDC, packet, available);
+			release();
 			break;
 
 		case IO_FIDO:
-			cmdbuf[0] = IO_FIDO;
-			cmdbuf[1] = available;
-			if (read(IO_FIDO, cmdbuf + 2, BUFSIZE - 2, available) <
-			    0) {
+			if (readview(IO_FIDO, &packet, &available) != 0) {
 				assert(1 == 2);
 			}
-			write(IO_DEBUG, cmdbuf, available + 2);
-			memset(cmdbuf, 0, BUFSIZE);
+			loopback(IO_FIDO, packet, available);
+			release();
 			break;
 
 		case IO_CCID:
-			cmdbuf[0] = IO_CCID;
-			cmdbuf[1] = available;
-			if (read(IO_CCID, cmdbuf + 2, BUFSIZE - 2, available) <
-			    0) {
+			if (readview(IO_CCID, &packet, &available) != 0) {
 				assert(1 == 2);
 			}
-			write(IO_DEBUG, cmdbuf, available + 2);
-			memset(cmdbuf, 0, BUFSIZE);
+			loopback(IO_CCID, packet, available);
+			release();
 			break;
 
 		case IO_DEBUG:
@@ -88,13 +91,15 @@ int main(void)
 					;
 			}
 
-			if (read(IO_DEBUG, cmdbuf, BUFSIZE, available) < 0) {
+			// Look at the packet where it is instead of
+			// reading it into a buffer of our own.
+			if (readview(IO_DEBUG, &packet, &available) != 0) {
 				assert(1 == 2);
 			}
 
 			if (!waiting_for_more_data) {
-				dest_endpoint = cmdbuf[0];
-				payload_length = cmdbuf[1];
+				dest_endpoint = packet[0];
+				payload_length = packet[1];
 
 				// Check that destination endpoint is ok
 				if (dest_endpoint != IO_CDC &&
@@ -114,26 +119,25 @@ int main(void)
 
 				// Complete payload fits in this packet
 				if (payload_length <= first_packet_len) {
-					write(dest_endpoint, cmdbuf + 2,
+					write(dest_endpoint, packet + 2,
 					      payload_length);
-					memset(cmdbuf, 0, BUFSIZE);
 				} else { // More payload will come in next
 					 // packet
-					memcpy(payloadbuf, cmdbuf + 2,
+					memcpy(payloadbuf, packet + 2,
 					       first_packet_len);
 					payload_left =
 					    payload_length - first_packet_len;
 					waiting_for_more_data = true;
 				}
 			} else {
-				memcpy(payloadbuf + first_packet_len, cmdbuf,
+				memcpy(payloadbuf + first_packet_len, packet,
 				       payload_left);
 				write(dest_endpoint, payloadbuf,
 				      payload_length);
 				memset(payloadbuf, 0, MAX_PAYLOAD_SIZE);
-				memset(cmdbuf, 0, BUFSIZE);
 				waiting_for_more_data = false;
 			}
+			release();
 			break;
 
 		default:
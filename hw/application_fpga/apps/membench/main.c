@@ -0,0 +1,213 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <stdint.h>
+#include <tkey/assert.h>
+#include <tkey/io.h>
+#include <tkey/led.h>
+#include <tkey/lib.h>
+#include <tkey/tk1_mem.h>
+
+// Cycle count benchmark of memcpy(), memset(), memeq() and wordcpy()
+// in libcommon, compared to plain byte loops.
+//
+// Press any key on CDC to run. For every size and alignment of
+// destination and source it prints the cycles used by the libcommon
+// function and by the byte loop doing the same thing.
+
+// clang-format off
+static volatile uint32_t *timer           = (volatile uint32_t *)TK1_MMIO_TIMER_TIMER;
+static volatile uint32_t *timer_prescaler = (volatile uint32_t *)TK1_MMIO_TIMER_PRESCALER;
+static volatile uint32_t *timer_ctrl      = (volatile uint32_t *)TK1_MMIO_TIMER_CTRL;
+// clang-format on
+
+#define MAXSIZE 4096
+
+static const uint32_t sizes[] = {4, 16, 32, 64, 128, 184, 512, MAXSIZE};
+
+// Offsets of destination and source from a word boundary
+static const uint8_t aligns[][2] = {{0, 0}, {1, 1}, {1, 0}, {2, 0}, {3, 0}};
+
+enum prim {
+	PRIM_MEMCPY,
+	PRIM_MEMSET,
+	PRIM_MEMEQ,
+	PRIM_WORDCPY,
+	PRIMS,
+};
+
+static const char *names[PRIMS] = {"memcpy ", "memset ", "memeq  ",
+				   "wordcpy"};
+
+static uint32_t dst_buf[MAXSIZE / 4 + 1];
+static uint32_t src_buf[MAXSIZE / 4 + 1];
+
+// The byte loops to compare with. The empty asm keeps the compiler
+// from turning them into calls to the functions we compare with.
+static void bytecpy(uint8_t *dest, const uint8_t *src, uint32_t n)
+{
+	for (uint32_t i = 0; i < n; i++) {
+		dest[i] = src[i];
+		asm volatile("" ::: "memory");
+	}
+}
+
+static void byteset(uint8_t *dest, uint8_t c, uint32_t n)
+{
+	for (uint32_t i = 0; i < n; i++) {
+		dest[i] = c;
+		asm volatile("" ::: "memory");
+	}
+}
+
+static int byteeq(const uint8_t *dest, const uint8_t *src, uint32_t n)
+{
+	int res = -1;
+
+	for (uint32_t i = 0; i < n; i++) {
+		if (dest[i] != src[i]) {
+			res = 0;
+		}
+		asm volatile("" ::: "memory");
+	}
+
+	return res;
+}
+
+static void timer_start(void)
+{
+	*timer_ctrl = (1 << TK1_MMIO_TIMER_CTRL_STOP_BIT);
+	*timer_prescaler = 1;
+	*timer = 0xffffffff;
+	*timer_ctrl = (1 << TK1_MMIO_TIMER_CTRL_START_BIT);
+}
+
+// Cycles to run prim over n bytes, with the library function if lib
+// is set, otherwise the byte loop.
+static uint32_t measure(enum prim prim, int lib, uint8_t *dest,
+			const uint8_t *src, uint32_t n)
+{
+	uint32_t start = *timer;
+
+	switch (prim) {
+	case PRIM_MEMCPY:
+		if (lib) {
+			(void)memcpy(dest, src, n);
+		} else {
+			bytecpy(dest, src, n);
+		}
+		break;
+
+	case PRIM_MEMSET:
+		if (lib) {
+			(void)memset(dest, 0xa5, n);
+		} else {
+			byteset(dest, 0xa5, n);
+		}
+		break;
+
+	case PRIM_MEMEQ:
+		if (lib) {
+			(void)memeq(dest, src, n);
+		} else {
+			(void)byteeq(dest, src, n);
+		}
+		break;
+
+	case PRIM_WORDCPY:
+		if (lib) {
+			(void)wordcpy(dest, src, n / 4);
+		} else {
+			bytecpy(dest, src, n);
+		}
+		break;
+
+	default:
+		assert(1 == 2);
+	}
+
+	return start - *timer;
+}
+
+static void putdec(uint32_t n)
+{
+	char buf[11] = {0};
+	int i = sizeof(buf) - 1;
+
+	do {
+		buf[--i] = '0' + n % 10;
+		n /= 10;
+	} while (n > 0);
+
+	puts(IO_CDC, &buf[i]);
+}
+
+static void run(void)
+{
+	uint32_t overhead = 0;
+
+	timer_start();
+
+	// What the timer reads and the call cost by themselves
+	overhead = measure(PRIM_MEMCPY, 1, (uint8_t *)dst_buf,
+			   (const uint8_t *)src_buf, 0);
+
+	puts(IO_CDC, "\r\nprim    size dst src: lib bytes (cycles)\r\n");
+
+	for (int p = 0; p < PRIMS; p++) {
+		for (int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+			for (int a = 0; a < sizeof(aligns) / sizeof(aligns[0]);
+			     a++) {
+				uint8_t *dest = (uint8_t *)dst_buf + aligns[a][0];
+				const uint8_t *src =
+				    (const uint8_t *)src_buf + aligns[a][1];
+				uint32_t lib = 0;
+				uint32_t bytes = 0;
+
+				if (p == PRIM_WORDCPY && a != 0) {
+					// Only defined for words
+					continue;
+				}
+
+				(void)memcpy(dest, src, sizes[s]);
+				lib = measure(p, 1, dest, src, sizes[s]);
+				bytes = measure(p, 0, dest, src, sizes[s]);
+
+				puts(IO_CDC, names[p]);
+				putchar(IO_CDC, ' ');
+				putdec(sizes[s]);
+				puts(IO_CDC, " +");
+				putdec(aligns[a][0]);
+				puts(IO_CDC, " +");
+				putdec(aligns[a][1]);
+				puts(IO_CDC, ": ");
+				putdec(lib - overhead);
+				putchar(IO_CDC, ' ');
+				putdec(bytes - overhead);
+				puts(IO_CDC, "\r\n");
+			}
+		}
+	}
+}
+
+int main(void)
+{
+	uint8_t in = 0;
+
+	config_endpoints(IO_CDC);
+
+	for (int i = 0; i < sizeof(src_buf) / sizeof(src_buf[0]); i++) {
+		src_buf[i] = 0x01234567 * (i + 1);
+	}
+
+	for (;;) {
+		led_set(LED_BLUE);
+
+		if (readfull(IO_CDC, &in, 1, 1) < 0) {
+			assert(1 == 2);
+		}
+
+		led_set(LED_GREEN);
+		run();
+	}
+}
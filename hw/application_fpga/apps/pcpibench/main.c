@@ -0,0 +1,245 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <monocypher/monocypher.h>
+#include <stdint.h>
+#include <tkey/assert.h>
+#include <tkey/io.h>
+#include <tkey/led.h>
+#include <tkey/lib.h>
+#include <tkey/pcpi.h>
+#include <tkey/tk1_mem.h>
+
+// Checks and cycle count benchmark of the pcpi_ext co-processor.
+//
+// Press any key on CDC to run. It first checks the results of the
+// rotate and multiply-accumulate instructions against plain C, then
+// prints the cycles used by the instructions and by the plain C doing
+// the same thing. Last it prints the cycles of ChaCha20 and X25519 in
+// Monocypher. Build tkey-libs with and without TKEY_PCPI=1 to compare
+// those.
+//
+// Needs TK1 version 8 or later.
+
+// clang-format off
+static volatile uint32_t *timer           = (volatile uint32_t *)TK1_MMIO_TIMER_TIMER;
+static volatile uint32_t *timer_prescaler = (volatile uint32_t *)TK1_MMIO_TIMER_PRESCALER;
+static volatile uint32_t *timer_ctrl      = (volatile uint32_t *)TK1_MMIO_TIMER_CTRL;
+static volatile uint32_t *version         = (volatile uint32_t *)TK1_MMIO_TK1_VERSION;
+// clang-format on
+
+#define ROUNDS 256
+#define TERMS 10
+
+static const uint32_t samples[] = {0x00000000, 0x00000001, 0x80000000,
+				   0x7fffffff, 0xffffffff, 0x01234567,
+				   0x89abcdef, 0xdeadbeef};
+
+static int32_t dot_a[TERMS];
+static int32_t dot_b[TERMS];
+static int64_t dot_sum;
+
+static uint8_t data[1024];
+
+static uint32_t c_ror(uint32_t x, uint32_t n)
+{
+	n &= 31;
+
+	return n == 0 ? x : (x >> n) | (x << (32 - n));
+}
+
+static uint32_t c_rol(uint32_t x, uint32_t n)
+{
+	return c_ror(x, 32 - (n & 31));
+}
+
+static void timer_start(void)
+{
+	*timer_ctrl = (1 << TK1_MMIO_TIMER_CTRL_STOP_BIT);
+	*timer_prescaler = 1;
+	*timer = 0xffffffff;
+	*timer_ctrl = (1 << TK1_MMIO_TIMER_CTRL_START_BIT);
+}
+
+static void putdec(uint32_t n)
+{
+	char buf[11] = {0};
+	int i = sizeof(buf) - 1;
+
+	do {
+		buf[--i] = '0' + n % 10;
+		n /= 10;
+	} while (n > 0);
+
+	puts(IO_CDC, &buf[i]);
+}
+
+static void result(const char *name, uint32_t pcpi, uint32_t c)
+{
+	puts(IO_CDC, name);
+	puts(IO_CDC, ": ");
+	putdec(pcpi);
+	putchar(IO_CDC, ' ');
+	putdec(c);
+	puts(IO_CDC, "\r\n");
+}
+
+// Compare every instruction with plain C, returns the number of
+// mismatches.
+static int check(void)
+{
+	int errors = 0;
+	int n = sizeof(samples) / sizeof(samples[0]);
+
+	for (int i = 0; i < n; i++) {
+		uint32_t x = samples[i];
+
+		for (uint32_t s = 0; s < 40; s++) {
+			errors += pcpi_ror(x, s) != c_ror(x, s);
+			errors += pcpi_rol(x, s) != c_rol(x, s);
+		}
+
+		errors += pcpi_rori(x, 0) != x;
+		errors += pcpi_rori(x, 7) != c_ror(x, 7);
+		errors += pcpi_rori(x, 16) != c_ror(x, 16);
+		errors += pcpi_rori(x, 31) != c_ror(x, 31);
+		errors += pcpi_roli(x, 8) != c_rol(x, 8);
+		errors += pcpi_roli(x, 25) != c_rol(x, 25);
+	}
+
+	for (int i = 0; i < n; i++) {
+		int64_t sacc = (int64_t)0x0123456789abcdef;
+		uint64_t uacc = 0xfedcba9876543210;
+
+		pcpi_mac_set(sacc);
+		for (int j = 0; j < n; j++) {
+			pcpi_mac(samples[i], samples[j]);
+			sacc += (int64_t)(int32_t)samples[i] *
+				(int32_t)samples[j];
+		}
+		errors += pcpi_mac_get() != sacc;
+
+		pcpi_mac_set((int64_t)uacc);
+		for (int j = 0; j < n; j++) {
+			pcpi_macu(samples[i], samples[j]);
+			uacc += (uint64_t)samples[i] * samples[j];
+		}
+		errors += (uint64_t)pcpi_mac_get() != uacc;
+	}
+
+	return errors;
+}
+
+// The empty asms keep the compiler from computing the loops at
+// compile time or moving the work out of the measurement.
+static uint32_t bench_rotate(int pcpi)
+{
+	uint32_t x = 0x01234567;
+	uint32_t start = *timer;
+
+	for (uint32_t i = 0; i < ROUNDS; i++) {
+		if (pcpi) {
+			x = pcpi_rori(x ^ i, 7) + pcpi_ror(x, i);
+		} else {
+			x = c_ror(x ^ i, 7) + c_ror(x, i);
+		}
+		asm volatile("" : "+r"(x));
+	}
+
+	return start - *timer;
+}
+
+static uint32_t bench_dot(int pcpi)
+{
+	int64_t sum = 0;
+	uint32_t start = *timer;
+
+	for (uint32_t i = 0; i < ROUNDS / TERMS; i++) {
+		if (pcpi) {
+			pcpi_mac_set(sum);
+			for (int j = 0; j < TERMS; j++) {
+				pcpi_mac(dot_a[j], dot_b[j]);
+			}
+			sum = pcpi_mac_get();
+		} else {
+			for (int j = 0; j < TERMS; j++) {
+				sum += (int64_t)dot_a[j] * dot_b[j];
+			}
+		}
+		asm volatile("" ::: "memory");
+	}
+	dot_sum = sum;
+
+	return start - *timer;
+}
+
+static uint32_t bench_chacha20(void)
+{
+	static const uint8_t key[32] = {1};
+	static const uint8_t nonce[8] = {2};
+	uint32_t start = *timer;
+
+	(void)crypto_chacha20_djb(data, data, sizeof(data), key, nonce, 0);
+
+	return start - *timer;
+}
+
+static uint32_t bench_x25519(void)
+{
+	static const uint8_t secret[32] = {3};
+	uint8_t public_key[32] = {0};
+	uint32_t start = *timer;
+
+	crypto_x25519_public_key(public_key, secret);
+
+	return start - *timer;
+}
+
+static void run(void)
+{
+	timer_start();
+
+	puts(IO_CDC, "\r\ncheck: ");
+	puts(IO_CDC, check() == 0 ? "ok" : "FAIL");
+	puts(IO_CDC, "\r\n");
+
+	puts(IO_CDC, "bench: pcpi c (cycles)\r\n");
+	result("rotate x256", bench_rotate(1), bench_rotate(0));
+	result("dot10 x25  ", bench_dot(1), bench_dot(0));
+
+	puts(IO_CDC, "bench: cycles\r\n");
+	puts(IO_CDC, "chacha20 1 KiB: ");
+	putdec(bench_chacha20());
+	puts(IO_CDC, "\r\nx25519 public key: ");
+	putdec(bench_x25519());
+	puts(IO_CDC, "\r\n");
+}
+
+int main(void)
+{
+	uint8_t in = 0;
+
+	config_endpoints(IO_CDC);
+
+	for (int i = 0; i < TERMS; i++) {
+		dot_a[i] = (int32_t)(samples[i % 8] + i);
+		dot_b[i] = (int32_t)(samples[(i + 3) % 8] - i);
+	}
+
+	for (;;) {
+		led_set(LED_BLUE);
+
+		if (readfull(IO_CDC, &in, 1, 1) < 0) {
+			assert(1 == 2);
+		}
+
+		if (*version < 8) {
+			puts(IO_CDC, "\r\nneeds TK1 version 8\r\n");
+			led_set(LED_RED);
+			continue;
+		}
+
+		led_set(LED_GREEN);
+		run();
+	}
+}
@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: 2022 Tillitis AB <tillitis.se>
 // SPDX-License-Identifier: BSD-2-Clause
 
+#include <fw/tk1/boot_trace.h>
 #include <fw/tk1/proto.h>
 #include <fw/tk1/reset.h>
 #include <fw/tk1/syscall_num.h>
@@ -42,6 +43,61 @@ int hex_string_to_bytes(uint8_t *hex_str, uint8_t *out_bytes, size_t out_len)
 
 #define BUFSIZE 32
 
+// Left in next_app_data by the benchmark, followed by the reset type.
+#define BENCH_MAGIC "reset_test bench"
+#define BENCH_MAGIC_LEN (sizeof(BENCH_MAGIC) - 1)
+
+// Reset with type after leaving a note to ourselves in next_app_data.
+static void bench_reset(struct reset *rst, enum reset_start type)
+{
+	memset(rst, 0, sizeof(*rst));
+	rst->type = type;
+	memcpy(rst->next_app_data, BENCH_MAGIC, BENCH_MAGIC_LEN);
+	rst->next_app_data[BENCH_MAGIC_LEN] = type;
+
+	// The client can time from this line to the report below.
+	puts(IO_CDC, "reset_test: bench: resetting\r\n");
+	syscall(TK1_SYSCALL_RESET, (uint32_t)rst, BENCH_MAGIC_LEN + 1, 0);
+}
+
+// If we were started by bench_reset(), report how long the firmware
+// took from reset to starting us.
+static void bench_report(void)
+{
+	uint8_t data[RESET_DATA_SIZE] = {0};
+	struct boot_trace trace = {0};
+
+	if (syscall(TK1_SYSCALL_GET_APP_DATA, (uint32_t)data, 0, 0) != 0) {
+		return;
+	}
+
+	if (!memeq(data, BENCH_MAGIC, BENCH_MAGIC_LEN)) {
+		return;
+	}
+
+	puts(IO_CDC, "reset_test: bench: started after reset type ");
+	puthex(IO_CDC, data[BENCH_MAGIC_LEN]);
+	puts(IO_CDC, "\r\n");
+
+	if (syscall(TK1_SYSCALL_GET_BOOT_TRACE, (uint32_t)&trace,
+		    sizeof(trace), 0) != 0) {
+		puts(IO_CDC, "reset_test: bench: no boot trace, build "
+			     "firmware with BOOT_TRACE\r\n");
+		return;
+	}
+
+	// Cycles since the start of firmware main()
+	puts(IO_CDC, "  scrambled:       ");
+	putinthex(IO_CDC, trace.scrambled);
+	puts(IO_CDC, "\r\n  part_table_read: ");
+	putinthex(IO_CDC, trace.part_table_read);
+	puts(IO_CDC, "\r\n  cdi_done:        ");
+	putinthex(IO_CDC, trace.cdi_done);
+	puts(IO_CDC, "\r\n  jump:            ");
+	putinthex(IO_CDC, trace.jump);
+	puts(IO_CDC, "\r\n");
+}
+
 int main(void)
 {
 	uint8_t available = 0;
@@ -50,6 +106,8 @@ int main(void)
 	led_set(LED_BLUE);
 	struct reset rst = {0};
 
+	bench_report();
+
 	while (1) {
 
 		puts(IO_CDC, "reset_test: Waiting for command\r\n");
@@ -151,6 +209,31 @@ int main(void)
 			syscall(TK1_SYSCALL_RESET, (uint32_t)&rst, 0, 0);
 		} break;
 
+		case 'b': {
+			// Benchmark: reset with the type given next and
+			// report the time to start on the next boot.
+			//
+			// Only reported if this app is what starts
+			// next: loaded by the client or from slot 1.
+
+			puts(IO_CDC, "reset_test: bench: reset type 0-6?\r\n");
+
+			if (readselect(IO_CDC, &endpoint, &available) < 0) {
+				assert(1 == 2);
+			}
+
+			memset(cmdbuf, 0, BUFSIZE);
+			if (read(IO_CDC, cmdbuf, BUFSIZE, available) < 0) {
+				assert(1 == 2);
+			}
+
+			if (cmdbuf[0] < '0' || cmdbuf[0] > '6') {
+				break;
+			}
+
+			bench_reset(&rst, cmdbuf[0] - '0');
+		} break;
+
 		default:
 			break;
 		}
@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <fw/tk1/syscall_num.h>
+#include <stdint.h>
+#include <syscall.h>
+#include <tkey/assert.h>
+#include <tkey/io.h>
+#include <tkey/led.h>
+#include <tkey/lib.h>
+
+// Receive throughput benchmark, used with +rxbench in the Verilator
+// model, see "Verilator simulation" in the firmware README.
+//
+// The client sends a 5 byte command on CDC: 'p' to poll the UART,
+// 'i' to use the UART receive interrupt or 'f' to use the interrupt
+// and let the ring fill up before every block, followed by the number
+// of bytes to come as a 32 bit little-endian integer. Then the bytes,
+// in USB Mode Protocol packets of at most 64 bytes.
+//
+// We read them in blocks of BLOCK_SIZE bytes and do WORK_ROUNDS of
+// computation after each, like an app signing every block would.
+// When everything is read we answer with the 32 bit sum of all bytes
+// followed by the 32 bit result of the computation.
+//
+// The computation keeps all its state in registers while the receive
+// interrupt fires, so the client can tell if firmware clobbered any
+// of them. The client does the same computation, see work() in
+// application_fpga_verilator.cc.
+#define BLOCK_SIZE 1024
+#define WORK_ROUNDS 20000
+
+static struct uart_rx_ring ring;
+
+#define ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static uint32_t work(uint32_t seed, uint32_t n)
+{
+	uint32_t a = seed, b = ~seed, c = seed ^ 0x9e3779b9, d = 1;
+	uint32_t e = 2, f = 3, g = 5, h = 7;
+
+	for (uint32_t i = 0; i < n; i++) {
+		a += b;
+		b = ROTL(b ^ c, 7);
+		c += d ^ i;
+		d = ROTL(d + e, 13);
+		e ^= f + a;
+		f = ROTL(f ^ g, 17);
+		g += h ^ b;
+		h = ROTL(h + a, 3);
+	}
+
+	return a ^ b ^ c ^ d ^ e ^ f ^ g ^ h;
+}
+
+// Waits until the receive ring is full, or has at least what is left
+// to read, so firmware has turned the receive interrupt off before we
+// read from a full ring.
+static void wait_ring(uint32_t left)
+{
+	uint32_t want = left < UART_RX_RING_SIZE ? left : UART_RX_RING_SIZE;
+
+	while (ring.head - ring.tail < want)
+		;
+}
+
+int main(void)
+{
+	uint8_t cmd[5] = {0};
+	uint8_t block[BLOCK_SIZE] = {0};
+	uint8_t rsp[8] = {0};
+	uint32_t left = 0;
+	uint32_t sum = 0;
+	uint32_t check = 0;
+
+	led_set(LED_BLUE);
+
+	if (readfull(IO_CDC, cmd, sizeof(cmd), sizeof(cmd)) < 0) {
+		assert(1 == 2);
+	}
+
+	if (cmd[0] == 'i' || cmd[0] == 'f') {
+		if (syscall(TK1_SYSCALL_UART_RX_RING, (uint32_t)&ring,
+			    sizeof(ring.buf), 0) != 0) {
+			led_set(LED_RED);
+			assert(1 == 2);
+		}
+		uart_rx_irq_enable(&ring);
+	}
+
+	left = cmd[1] | cmd[2] << 8 | cmd[3] << 16 | cmd[4] << 24;
+
+	while (left > 0) {
+		uint32_t n = left < BLOCK_SIZE ? left : BLOCK_SIZE;
+
+		if (cmd[0] == 'f') {
+			wait_ring(left);
+		}
+
+		if (readfull(IO_CDC, block, sizeof(block), n) < 0) {
+			assert(1 == 2);
+		}
+
+		for (uint32_t i = 0; i < n; i++) {
+			sum += block[i];
+		}
+
+		left -= n;
+		check = work(check ^ sum, WORK_ROUNDS);
+	}
+
+	rsp[0] = sum;
+	rsp[1] = sum >> 8;
+	rsp[2] = sum >> 16;
+	rsp[3] = sum >> 24;
+	rsp[4] = check;
+	rsp[5] = check >> 8;
+	rsp[6] = check >> 16;
+	rsp[7] = check >> 24;
+	write(IO_CDC, rsp, sizeof(rsp));
+
+	led_set(LED_GREEN);
+
+	for (;;)
+		;
+}
@@ -0,0 +1,260 @@
+//======================================================================
+//
+// blake2s.v
+// ---------
+// Top level wrapper for the blake2s core.
+//
+//
+// Author: Joachim Strombergson
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+//
+//======================================================================
+
+`default_nettype none
+
+module blake2s (
+    input wire clk,
+    input wire reset_n,
+
+    input wire cs,
+    input wire we,
+
+    input  wire [ 7 : 0] address,
+    input  wire [31 : 0] write_data,
+    output wire [31 : 0] read_data,
+    output wire          ready
+);
+
+
+  //----------------------------------------------------------------
+  // Internal constant and parameter definitions.
+  //----------------------------------------------------------------
+  localparam ADDR_NAME0 = 8'h00;
+  localparam ADDR_NAME1 = 8'h01;
+  localparam ADDR_VERSION = 8'h02;
+
+  localparam ADDR_CTRL = 8'h08;
+  localparam CTRL_NEXT_BIT = 0;
+  localparam CTRL_LAST_BIT = 1;
+  localparam CTRL_CLEAR_BIT = 2;
+
+  localparam ADDR_STATUS = 8'h09;
+  localparam STATUS_READY_BIT = 0;
+
+  localparam ADDR_T0 = 8'h10;
+  localparam ADDR_T1 = 8'h11;
+
+  localparam ADDR_H0 = 8'h20;
+  localparam ADDR_H7 = 8'h27;
+
+  localparam ADDR_BLOCK0 = 8'h40;
+  localparam ADDR_BLOCK15 = 8'h4f;
+
+  localparam CORE_NAME0 = 32'h626c616b;  // "blak"
+  localparam CORE_NAME1 = 32'h65327320;  // "e2s "
+  localparam CORE_VERSION = 32'h00000001;
+
+
+  //----------------------------------------------------------------
+  // Registers including update variables and write enable.
+  //----------------------------------------------------------------
+  reg  [ 31 : 0] h_mem     [0 : 7];
+  reg            h_mem_we;
+
+  reg  [ 31 : 0] block_mem [0 : 15];
+  reg            block_mem_we;
+
+  reg  [ 31 : 0] t0_reg;
+  reg            t0_we;
+
+  reg  [ 31 : 0] t1_reg;
+  reg            t1_we;
+
+  reg            next_reg;
+  reg            next_new;
+
+  reg            last_reg;
+  reg            last_new;
+
+  reg            clear_reg;
+  reg            clear_new;
+
+
+  //----------------------------------------------------------------
+  // Wires.
+  //----------------------------------------------------------------
+  reg  [ 31 : 0] tmp_read_data;
+  reg            tmp_ready;
+
+  wire [255 : 0] core_h;
+  wire [511 : 0] core_block;
+  wire [255 : 0] core_h_new;
+  wire           core_done;
+  wire           core_ready;
+
+
+  //----------------------------------------------------------------
+  // Concurrent connectivity for ports etc.
+  //----------------------------------------------------------------
+  assign read_data = tmp_read_data;
+  assign ready = tmp_ready;
+
+  assign core_h = {h_mem[7], h_mem[6], h_mem[5], h_mem[4],
+                   h_mem[3], h_mem[2], h_mem[1], h_mem[0]};
+
+  assign core_block = {block_mem[15], block_mem[14], block_mem[13], block_mem[12],
+                       block_mem[11], block_mem[10], block_mem[9], block_mem[8],
+                       block_mem[7], block_mem[6], block_mem[5], block_mem[4],
+                       block_mem[3], block_mem[2], block_mem[1], block_mem[0]};
+
+
+  //----------------------------------------------------------------
+  // core instantiation.
+  //----------------------------------------------------------------
+  blake2s_core core (
+      .clk(clk),
+      .reset_n(reset_n),
+
+      .next (next_reg),
+      .last (last_reg),
+      .clear(clear_reg),
+
+      .h(core_h),
+      .t({t1_reg, t0_reg}),
+      .block(core_block),
+
+      .h_new(core_h_new),
+      .done (core_done),
+      .ready(core_ready)
+  );
+
+
+  //----------------------------------------------------------------
+  // reg_update
+  //----------------------------------------------------------------
+  always @(posedge clk) begin : reg_update
+    integer i;
+
+    if (!reset_n || clear_reg) begin
+      for (i = 0; i < 8; i = i + 1) begin
+        h_mem[i] <= 32'h0;
+      end
+
+      for (i = 0; i < 16; i = i + 1) begin
+        block_mem[i] <= 32'h0;
+      end
+
+      t0_reg    <= 32'h0;
+      t1_reg    <= 32'h0;
+      next_reg  <= 1'h0;
+      last_reg  <= 1'h0;
+      clear_reg <= 1'h0;
+    end
+    else begin
+      next_reg  <= next_new;
+      last_reg  <= last_new;
+      clear_reg <= clear_new;
+
+      if (core_done) begin
+        for (i = 0; i < 8; i = i + 1) begin
+          h_mem[i] <= core_h_new[i*32+:32];
+        end
+      end
+
+      if (h_mem_we) begin
+        h_mem[address[2 : 0]] <= write_data;
+      end
+
+      if (block_mem_we) begin
+        block_mem[address[3 : 0]] <= write_data;
+      end
+
+      if (t0_we) begin
+        t0_reg <= write_data;
+      end
+
+      if (t1_we) begin
+        t1_reg <= write_data;
+      end
+    end
+  end  // reg_update
+
+
+  //----------------------------------------------------------------
+  // api
+  //
+  // The interface command decoding logic.
+  //----------------------------------------------------------------
+  always @* begin : api
+    next_new      = 1'h0;
+    last_new      = 1'h0;
+    clear_new     = 1'h0;
+    h_mem_we      = 1'h0;
+    block_mem_we  = 1'h0;
+    t0_we         = 1'h0;
+    t1_we         = 1'h0;
+    tmp_read_data = 32'h0;
+    tmp_ready     = 1'h0;
+
+    if (cs) begin
+      tmp_ready = 1'h1;
+
+      if (we) begin
+        if (address == ADDR_CTRL) begin
+          clear_new = write_data[CTRL_CLEAR_BIT];
+
+          if (core_ready && !next_reg) begin
+            next_new = write_data[CTRL_NEXT_BIT] | write_data[CTRL_LAST_BIT];
+            last_new = write_data[CTRL_LAST_BIT];
+          end
+        end
+
+        // Inputs can't change during compression.
+        if (core_ready && !next_reg) begin
+          if (address == ADDR_T0) begin
+            t0_we = 1'h1;
+          end
+
+          if (address == ADDR_T1) begin
+            t1_we = 1'h1;
+          end
+
+          if ((address >= ADDR_H0) && (address <= ADDR_H7)) begin
+            h_mem_we = 1'h1;
+          end
+
+          if ((address >= ADDR_BLOCK0) && (address <= ADDR_BLOCK15)) begin
+            block_mem_we = 1'h1;
+          end
+        end
+      end
+
+      else begin
+        if (address == ADDR_NAME0) begin
+          tmp_read_data = CORE_NAME0;
+        end
+
+        if (address == ADDR_NAME1) begin
+          tmp_read_data = CORE_NAME1;
+        end
+
+        if (address == ADDR_VERSION) begin
+          tmp_read_data = CORE_VERSION;
+        end
+
+        if (address == ADDR_STATUS) begin
+          tmp_read_data[STATUS_READY_BIT] = core_ready & ~next_reg;
+        end
+
+        if ((address >= ADDR_H0) && (address <= ADDR_H7)) begin
+          tmp_read_data = h_mem[address[2 : 0]];
+        end
+      end
+    end
+  end  // api
+endmodule  // blake2s
+
+//======================================================================
+// EOF blake2s.v
+//======================================================================
@@ -0,0 +1,329 @@
+//======================================================================
+//
+// blake2s_core.v
+// --------------
+// The BLAKE2s compression function. Compresses one block given the
+// chained state, the byte counter and the last block flag, and
+// outputs the new chained state.
+//
+// To save area half a G function is computed per cycle, always on
+// the first column of the work variables. The columns are rotated
+// after every G, and the rows are rotated to and from the diagonal
+// layout before and after the diagonal G functions. This takes 182
+// cycles per block.
+//
+//
+// Author: Joachim Strombergson
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+//
+//======================================================================
+
+`default_nettype none
+
+module blake2s_core (
+    input wire clk,
+    input wire reset_n,
+
+    input wire next,
+    input wire last,
+    input wire clear,
+
+    input wire [255 : 0] h,
+    input wire [ 63 : 0] t,
+    input wire [511 : 0] block,
+
+    output wire [255 : 0] h_new,
+    output wire           done,
+    output wire           ready
+);
+
+
+  //----------------------------------------------------------------
+  // Internal constant and parameter definitions.
+  //----------------------------------------------------------------
+  localparam NUM_ROUNDS = 4'h9;
+
+  localparam CTRL_IDLE = 3'h0;
+  localparam CTRL_G = 3'h1;
+  localparam CTRL_DIAG = 3'h2;
+  localparam CTRL_UNDIAG = 3'h3;
+  localparam CTRL_DONE = 3'h4;
+
+  localparam IV0 = 32'h6a09e667;
+  localparam IV1 = 32'hbb67ae85;
+  localparam IV2 = 32'h3c6ef372;
+  localparam IV3 = 32'ha54ff53a;
+  localparam IV4 = 32'h510e527f;
+  localparam IV5 = 32'h9b05688c;
+  localparam IV6 = 32'h1f83d9ab;
+  localparam IV7 = 32'h5be0cd19;
+
+
+  //----------------------------------------------------------------
+  // Functions.
+  //----------------------------------------------------------------
+  // The message schedule for a round, word index i in bits
+  // (4 * i + 3) : (4 * i).
+  function [63 : 0] sigma(input [3 : 0] round);
+    begin
+      case (round)
+        4'h0: sigma = 64'hfedcba9876543210;
+        4'h1: sigma = 64'h357b20c16df984ae;
+        4'h2: sigma = 64'h491763eadf250c8b;
+        4'h3: sigma = 64'h8f04a562ebcd1397;
+        4'h4: sigma = 64'hd386cb1efa427509;
+        4'h5: sigma = 64'h91ef57d438b0a6c2;
+        4'h6: sigma = 64'hb8293670a4def15c;
+        4'h7: sigma = 64'ha2684f05931ce7bd;
+        4'h8: sigma = 64'h5a417d2c803b9ef6;
+        4'h9: sigma = 64'h0dc3e9bf5167482a;
+        default: sigma = 64'h0;
+      endcase
+    end
+  endfunction
+
+
+  //----------------------------------------------------------------
+  // Registers including update variables and write enable.
+  //----------------------------------------------------------------
+  // Work variables, v[i] in bits (32 * i + 31) : (32 * i). Row r,
+  // column c is v[4 * r + c].
+  reg [511 : 0] v_reg;
+  reg [511 : 0] v_new;
+  reg           v_we;
+
+  reg [  3 : 0] round_ctr_reg;
+  reg [  3 : 0] round_ctr_new;
+  reg           round_ctr_we;
+
+  // Half G functions done in the round, bit 0 selects the half.
+  reg [  3 : 0] step_ctr_reg;
+  reg [  3 : 0] step_ctr_new;
+  reg           step_ctr_we;
+
+  reg [  2 : 0] ctrl_reg;
+  reg [  2 : 0] ctrl_new;
+  reg           ctrl_we;
+
+
+  //----------------------------------------------------------------
+  // Wires.
+  //----------------------------------------------------------------
+  reg           tmp_done;
+  reg           tmp_ready;
+
+  reg [ 31 : 0] g_a;
+  reg [ 31 : 0] g_b;
+  reg [ 31 : 0] g_c;
+  reg [ 31 : 0] g_d;
+
+
+  //----------------------------------------------------------------
+  // Concurrent connectivity for ports etc.
+  //----------------------------------------------------------------
+  assign h_new = h ^ v_reg[255 : 0] ^ v_reg[511 : 256];
+  assign done  = tmp_done;
+  assign ready = tmp_ready;
+
+
+  //----------------------------------------------------------------
+  // reg_update
+  //----------------------------------------------------------------
+  always @(posedge clk) begin : reg_update
+    if (!reset_n) begin
+      v_reg         <= 512'h0;
+      round_ctr_reg <= 4'h0;
+      step_ctr_reg  <= 4'h0;
+      ctrl_reg      <= CTRL_IDLE;
+    end
+    else begin
+      if (v_we) begin
+        v_reg <= v_new;
+      end
+
+      if (round_ctr_we) begin
+        round_ctr_reg <= round_ctr_new;
+      end
+
+      if (step_ctr_we) begin
+        step_ctr_reg <= step_ctr_new;
+      end
+
+      if (ctrl_we) begin
+        ctrl_reg <= ctrl_new;
+      end
+    end
+  end  // reg_update
+
+
+  //----------------------------------------------------------------
+  // g_half
+  //
+  // Half a G function on the first column, with the message word
+  // picked by the schedule for the current round and step.
+  //----------------------------------------------------------------
+  always @* begin : g_half
+    reg [63 : 0] schedule;
+    reg [ 3 : 0] m_idx;
+    reg [31 : 0] x;
+    reg [31 : 0] d0;
+    reg [31 : 0] b0;
+
+    schedule = sigma(round_ctr_reg);
+    m_idx    = schedule[step_ctr_reg*4+:4];
+    x        = block[m_idx*32+:32];
+
+    g_a      = v_reg[0*32+:32] + v_reg[4*32+:32] + x;
+    d0       = v_reg[12*32+:32] ^ g_a;
+
+    if (step_ctr_reg[0]) begin
+      g_d = {d0[7 : 0], d0[31 : 8]};
+      g_c = v_reg[8*32+:32] + g_d;
+      b0  = v_reg[4*32+:32] ^ g_c;
+      g_b = {b0[6 : 0], b0[31 : 7]};
+    end
+    else begin
+      g_d = {d0[15 : 0], d0[31 : 16]};
+      g_c = v_reg[8*32+:32] + g_d;
+      b0  = v_reg[4*32+:32] ^ g_c;
+      g_b = {b0[11 : 0], b0[31 : 12]};
+    end
+  end  // g_half
+
+
+  //----------------------------------------------------------------
+  // blake2s_ctrl
+  //----------------------------------------------------------------
+  always @* begin : blake2s_ctrl
+    integer r;
+    integer c;
+
+    v_new         = v_reg;
+    v_we          = 1'h0;
+    round_ctr_new = 4'h0;
+    round_ctr_we  = 1'h0;
+    step_ctr_new  = step_ctr_reg + 1'h1;
+    step_ctr_we   = 1'h0;
+    ctrl_new      = CTRL_IDLE;
+    ctrl_we       = 1'h0;
+    tmp_done      = 1'h0;
+    tmp_ready     = 1'h0;
+
+    if (clear) begin
+      v_new         = 512'h0;
+      v_we          = 1'h1;
+      round_ctr_we  = 1'h1;
+      step_ctr_new  = 4'h0;
+      step_ctr_we   = 1'h1;
+      ctrl_new      = CTRL_IDLE;
+      ctrl_we       = 1'h1;
+    end
+
+    else begin
+      case (ctrl_reg)
+        CTRL_IDLE: begin
+          tmp_ready = 1'h1;
+
+          if (next) begin
+            v_new[255 : 0]   = h;
+            v_new[287 : 256] = IV0;
+            v_new[319 : 288] = IV1;
+            v_new[351 : 320] = IV2;
+            v_new[383 : 352] = IV3;
+            v_new[415 : 384] = IV4 ^ t[31 : 0];
+            v_new[447 : 416] = IV5 ^ t[63 : 32];
+            v_new[479 : 448] = last ? ~IV6 : IV6;
+            v_new[511 : 480] = IV7;
+            v_we             = 1'h1;
+            round_ctr_we     = 1'h1;
+            step_ctr_new     = 4'h0;
+            step_ctr_we      = 1'h1;
+            ctrl_new         = CTRL_G;
+            ctrl_we          = 1'h1;
+          end
+        end
+
+        CTRL_G: begin
+          if (step_ctr_reg[0]) begin
+            // Second half. Rotate the columns so the next G is
+            // done on the first column again.
+            for (r = 0; r < 4; r = r + 1) begin
+              for (c = 0; c < 3; c = c + 1) begin
+                v_new[(4*r+c)*32+:32] = v_reg[(4*r+c+1)*32+:32];
+              end
+            end
+            v_new[3*32+:32]  = g_a;
+            v_new[7*32+:32]  = g_b;
+            v_new[11*32+:32] = g_c;
+            v_new[15*32+:32] = g_d;
+          end
+          else begin
+            v_new[0*32+:32]  = g_a;
+            v_new[4*32+:32]  = g_b;
+            v_new[8*32+:32]  = g_c;
+            v_new[12*32+:32] = g_d;
+          end
+          v_we        = 1'h1;
+          step_ctr_we = 1'h1;
+
+          if (step_ctr_reg == 4'h7) begin
+            ctrl_new = CTRL_DIAG;
+            ctrl_we  = 1'h1;
+          end
+
+          if (step_ctr_reg == 4'hf) begin
+            ctrl_new = CTRL_UNDIAG;
+            ctrl_we  = 1'h1;
+          end
+        end
+
+        CTRL_DIAG: begin
+          // Rotate row r left by r.
+          for (r = 0; r < 4; r = r + 1) begin
+            for (c = 0; c < 4; c = c + 1) begin
+              v_new[(4*r+c)*32+:32] = v_reg[(4*r+((c+r)&3))*32+:32];
+            end
+          end
+          v_we     = 1'h1;
+          ctrl_new = CTRL_G;
+          ctrl_we  = 1'h1;
+        end
+
+        CTRL_UNDIAG: begin
+          // Rotate row r right by r.
+          for (r = 0; r < 4; r = r + 1) begin
+            for (c = 0; c < 4; c = c + 1) begin
+              v_new[(4*r+c)*32+:32] = v_reg[(4*r+((c-r)&3))*32+:32];
+            end
+          end
+          v_we = 1'h1;
+
+          if (round_ctr_reg == NUM_ROUNDS) begin
+            ctrl_new = CTRL_DONE;
+            ctrl_we  = 1'h1;
+          end
+          else begin
+            round_ctr_new = round_ctr_reg + 1'h1;
+            round_ctr_we  = 1'h1;
+            ctrl_new      = CTRL_G;
+            ctrl_we       = 1'h1;
+          end
+        end
+
+        CTRL_DONE: begin
+          tmp_done = 1'h1;
+          ctrl_new = CTRL_IDLE;
+          ctrl_we  = 1'h1;
+        end
+
+        default: begin
+        end
+      endcase  // case (ctrl_reg)
+    end
+  end  // blake2s_ctrl
+endmodule  // blake2s_core
+
+//======================================================================
+// EOF blake2s_core.v
+//======================================================================
@@ -0,0 +1,505 @@
+//======================================================================
+//
+// tb_blake2s.v
+// ------------
+// Testbench for the blake2s top level wrapper.
+//
+//
+// Author: Joachim Strombergson
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+//
+//======================================================================
+
+`default_nettype none
+
+module tb_blake2s ();
+
+  //----------------------------------------------------------------
+  // Internal constant and parameter definitions.
+  //----------------------------------------------------------------
+  parameter DEBUG = 0;
+  parameter DUMP_WAIT = 0;
+
+  parameter CLK_HALF_PERIOD = 1;
+  parameter CLK_PERIOD = 2 * CLK_HALF_PERIOD;
+
+  localparam ADDR_NAME0 = 8'h00;
+  localparam ADDR_NAME1 = 8'h01;
+
+  localparam ADDR_CTRL = 8'h08;
+  localparam CTRL_NEXT_BIT = 0;
+  localparam CTRL_LAST_BIT = 1;
+  localparam CTRL_CLEAR_BIT = 2;
+
+  localparam ADDR_STATUS = 8'h09;
+  localparam STATUS_READY_BIT = 0;
+
+  localparam ADDR_T0 = 8'h10;
+  localparam ADDR_T1 = 8'h11;
+
+  localparam ADDR_H0 = 8'h20;
+  localparam ADDR_BLOCK0 = 8'h40;
+
+  // The 64 byte message 0x00..0x3f.
+  localparam MSG64 = 512'h3f3e3d3c3b3a393837363534333231302f2e2d2c2b2a292827262524232221201f1e1d1c1b1a191817161514131211100f0e0d0c0b0a09080706050403020100;
+
+  // IV with the parameter block for a 32 byte digest without key.
+  localparam H_INIT = 256'h5be0cd191f83d9ab9b05688c510e527fa54ff53a3c6ef372bb67ae856b08e647;
+
+
+  //----------------------------------------------------------------
+  // Register and Wire declarations.
+  //----------------------------------------------------------------
+  reg  [31 : 0] cycle_ctr;
+  reg  [31 : 0] error_ctr;
+  reg  [31 : 0] tc_ctr;
+  reg           tb_monitor;
+
+  reg           tb_clk;
+  reg           tb_reset_n;
+  reg           tb_cs;
+  reg           tb_we;
+  reg  [ 7 : 0] tb_address;
+  reg  [31 : 0] tb_write_data;
+  wire [31 : 0] tb_read_data;
+  wire          tb_ready;
+
+  reg  [ 31 : 0] read_data;
+  reg  [255 : 0] digest;
+
+
+  //----------------------------------------------------------------
+  // Device Under Test.
+  //----------------------------------------------------------------
+  blake2s dut (
+      .clk(tb_clk),
+      .reset_n(tb_reset_n),
+
+      .cs(tb_cs),
+      .we(tb_we),
+
+      .address(tb_address),
+      .write_data(tb_write_data),
+      .read_data(tb_read_data),
+      .ready(tb_ready)
+  );
+
+
+  //----------------------------------------------------------------
+  // clk_gen
+  //
+  // Always running clock generator process.
+  //----------------------------------------------------------------
+  always begin : clk_gen
+    #CLK_HALF_PERIOD;
+    tb_clk = !tb_clk;
+  end  // clk_gen
+
+
+  //----------------------------------------------------------------
+  // sys_monitor()
+  //
+  // An always running process that creates a cycle counter and
+  // conditionally displays information about the DUT.
+  //----------------------------------------------------------------
+  always begin : sys_monitor
+    cycle_ctr = cycle_ctr + 1;
+    #(CLK_PERIOD);
+    if (tb_monitor) begin
+      dump_dut_state();
+    end
+  end
+
+
+  //----------------------------------------------------------------
+  // dump_dut_state()
+  //
+  // Dump the state of the dump when needed.
+  //----------------------------------------------------------------
+  task dump_dut_state;
+    begin
+      $display("State of DUT");
+      $display("------------");
+      $display("Cycle: %08d", cycle_ctr);
+      $display("");
+      $display("Inputs and outputs:");
+      $display(
+          "cs: 0x%1x, we: 0x%1x, address: 0x%02x, write_data: 0x%08x, read_data: 0x%08x, ready: 0x%1x",
+          tb_cs, tb_we, tb_address, tb_write_data, tb_read_data, tb_ready);
+      $display("");
+      $display("Internal state:");
+      $display("next_reg: 0x%1x, last_reg: 0x%1x, clear_reg: 0x%1x", dut.next_reg,
+               dut.last_reg, dut.clear_reg);
+      $display("core ctrl_reg: 0x%1x, round_ctr_reg: 0x%1x, step_ctr_reg: 0x%1x",
+               dut.core.ctrl_reg, dut.core.round_ctr_reg, dut.core.step_ctr_reg);
+      $display("core v_reg: 0x%0128x", dut.core.v_reg);
+      $display("");
+      $display("");
+    end
+  endtask  // dump_dut_state
+
+
+  //----------------------------------------------------------------
+  // reset_dut()
+  //
+  // Toggle reset to put the DUT into a well known state.
+  //----------------------------------------------------------------
+  task reset_dut;
+    begin
+      $display("--- Toggle reset.");
+      tb_reset_n = 0;
+      #(2 * CLK_PERIOD);
+      tb_reset_n = 1;
+    end
+  endtask  // reset_dut
+
+
+  //----------------------------------------------------------------
+  // display_test_result()
+  //
+  // Display the accumulated test results.
+  //----------------------------------------------------------------
+  task display_test_result;
+    begin
+      if (error_ctr == 0) begin
+        $display("--- All %02d test cases completed successfully", tc_ctr);
+      end
+      else begin
+        $display("--- %02d tests completed - %02d test cases did not complete successfully.",
+                 tc_ctr, error_ctr);
+      end
+    end
+  endtask  // display_test_result
+
+
+  //----------------------------------------------------------------
+  // init_sim()
+  //
+  // Initialize all counters and testbed functionality as well
+  // as setting the DUT inputs to defined values.
+  //----------------------------------------------------------------
+  task init_sim;
+    begin
+      cycle_ctr     = 0;
+      error_ctr     = 0;
+      tc_ctr        = 0;
+      tb_monitor    = 0;
+
+      tb_clk        = 1'h0;
+      tb_reset_n    = 1'h1;
+      tb_cs         = 1'h0;
+      tb_we         = 1'h0;
+      tb_address    = 8'h0;
+      tb_write_data = 32'h0;
+    end
+  endtask  // init_sim
+
+
+  //----------------------------------------------------------------
+  // write_word()
+  //
+  // Write the given word to the DUT using the DUT interface.
+  //----------------------------------------------------------------
+  task write_word(input [11 : 0] address, input [31 : 0] word);
+    begin
+      if (DEBUG) begin
+        $display("--- Writing 0x%08x to 0x%02x.", word, address);
+        $display("");
+      end
+
+      tb_address = address;
+      tb_write_data = word;
+      tb_cs = 1;
+      tb_we = 1;
+      #(CLK_PERIOD);
+      tb_cs = 0;
+      tb_we = 0;
+    end
+  endtask  // write_word
+
+
+  //----------------------------------------------------------------
+  // read_word()
+  //
+  // Read a data word from the given address in the DUT.
+  // the word read will be available in the global variable
+  // read_data.
+  //----------------------------------------------------------------
+  task read_word(input [11 : 0] address);
+    begin
+      tb_address = address;
+      tb_cs = 1;
+      tb_we = 0;
+      #(CLK_PERIOD);
+      read_data = tb_read_data;
+      tb_cs = 0;
+
+      if (DEBUG) begin
+        $display("--- Reading 0x%08x from 0x%02x.", read_data, address);
+        $display("");
+      end
+    end
+  endtask  // read_word
+
+
+  //----------------------------------------------------------------
+  // wait_ready()
+  //
+  // Wait for the ready flag to be set in dut.
+  //----------------------------------------------------------------
+  task wait_ready;
+    begin : wready
+      read_word(ADDR_STATUS);
+      while (read_data[STATUS_READY_BIT] == 0) read_word(ADDR_STATUS);
+    end
+  endtask  // wait_ready
+
+
+  //----------------------------------------------------------------
+  // compress()
+  //
+  // Compress block with byte counter t, writing the chained state
+  // h first if write_h is set. The new chained state is read into
+  // the global variable digest.
+  //----------------------------------------------------------------
+  task compress(input write_h, input [255 : 0] h, input [63 : 0] t, input last,
+                input [511 : 0] block);
+    begin : compress
+      integer i;
+
+      if (write_h) begin
+        for (i = 0; i < 8; i = i + 1) begin
+          write_word(ADDR_H0 + i, h[i*32+:32]);
+        end
+      end
+
+      write_word(ADDR_T0, t[31 : 0]);
+      write_word(ADDR_T1, t[63 : 32]);
+
+      for (i = 0; i < 16; i = i + 1) begin
+        write_word(ADDR_BLOCK0 + i, block[i*32+:32]);
+      end
+
+      if (last) begin
+        write_word(ADDR_CTRL, 32'h1 << CTRL_LAST_BIT);
+      end
+      else begin
+        write_word(ADDR_CTRL, 32'h1 << CTRL_NEXT_BIT);
+      end
+
+      wait_ready();
+
+      for (i = 0; i < 8; i = i + 1) begin
+        read_word(ADDR_H0 + i);
+        digest[i*32+:32] = read_data;
+      end
+    end
+  endtask  // compress
+
+
+  //----------------------------------------------------------------
+  // check_digest()
+  //----------------------------------------------------------------
+  task check_digest(input [255 : 0] expected);
+    begin
+      if (digest == expected) begin
+        $display("--- Correct digest received.");
+      end
+      else begin
+        $display("--- Error: Incorrect digest received.");
+        $display("--- Expected: 0x%064x", expected);
+        $display("--- Got:      0x%064x", digest);
+        error_ctr = error_ctr + 1;
+      end
+    end
+  endtask  // check_digest
+
+
+  //----------------------------------------------------------------
+  // test_name()
+  // Check that the name of the core can be read.
+  //----------------------------------------------------------------
+  task test_name;
+    begin
+      tc_ctr = tc_ctr + 1;
+
+      $display("");
+      $display("--- test_name: started.");
+
+      read_word(ADDR_NAME0);
+      if (read_data != 32'h626c616b) begin
+        $display("--- Error: Incorrect name0: 0x%08x", read_data);
+        error_ctr = error_ctr + 1;
+      end
+
+      read_word(ADDR_NAME1);
+      if (read_data != 32'h65327320) begin
+        $display("--- Error: Incorrect name1: 0x%08x", read_data);
+        error_ctr = error_ctr + 1;
+      end
+
+      $display("--- test_name: completed.");
+      $display("");
+    end
+  endtask  // test_name
+
+
+  //----------------------------------------------------------------
+  // test_zero_length()
+  // The zero length message, a single last block of zeroes. The
+  // vectors are the ones from blake2s_test.c in tkey-libs.
+  //----------------------------------------------------------------
+  task test_zero_length;
+    begin
+      tc_ctr = tc_ctr + 1;
+
+      $display("");
+      $display("--- test_zero_length: started.");
+
+      compress(1, H_INIT, 64'h0, 1, 512'h0);
+      check_digest(256'hf9eed01efd0d251b1ea5a12c48b6551f7c4a3542d02111e194809079307a2169);
+
+      $display("--- test_zero_length: completed.");
+      $display("");
+    end
+  endtask  // test_zero_length
+
+
+  //----------------------------------------------------------------
+  // test_abc_message()
+  // The RFC 7693 three byte 'abc' message.
+  //----------------------------------------------------------------
+  task test_abc_message;
+    begin
+      tc_ctr = tc_ctr + 1;
+
+      $display("");
+      $display("--- test_abc_message: started.");
+
+      compress(1, H_INIT, 64'h3, 1, 512'h00636261);
+      check_digest(256'h825967864c9b994d293ad69e208b45372f45eb4ea32ba7e1e2147c328c5e8c50);
+
+      $display("--- test_abc_message: completed.");
+      $display("");
+    end
+  endtask  // test_abc_message
+
+
+  //----------------------------------------------------------------
+  // test_one_block_message()
+  // A 64 byte message 0x00..0x3f, filling one block.
+  //----------------------------------------------------------------
+  task test_one_block_message;
+    begin
+      tc_ctr = tc_ctr + 1;
+
+      $display("");
+      $display("--- test_one_block_message: started.");
+
+      compress(1, H_INIT, 64'h40, 1, MSG64);
+      check_digest(256'h3eaaeab83392de1dcf34f6001bcf6a08519dc8d0524bf2c1907e55968b4ef356);
+
+      $display("--- test_one_block_message: completed.");
+      $display("");
+    end
+  endtask  // test_one_block_message
+
+
+  //----------------------------------------------------------------
+  // test_one_block_one_byte_message()
+  // A 65 byte message 0x00..0x40. The second block is compressed
+  // with the chained state left in the core by the first.
+  //----------------------------------------------------------------
+  task test_one_block_one_byte_message;
+    begin
+      tc_ctr = tc_ctr + 1;
+
+      $display("");
+      $display("--- test_one_block_one_byte_message: started.");
+
+      compress(1, H_INIT, 64'h40, 0, MSG64);
+      compress(0, 256'h0, 64'h41, 1, 512'h40);
+      check_digest(256'h7244970e09b439160b5af9df0ea4d061067f2c35de489d154b4ef3aa94ee531b);
+
+      $display("--- test_one_block_one_byte_message: completed.");
+      $display("");
+    end
+  endtask  // test_one_block_one_byte_message
+
+
+  //----------------------------------------------------------------
+  // test_clear()
+  // Clearing the core zeroes the chained state.
+  //----------------------------------------------------------------
+  task test_clear;
+    begin : test_clear
+      integer i;
+
+      tc_ctr = tc_ctr + 1;
+
+      $display("");
+      $display("--- test_clear: started.");
+
+      write_word(ADDR_CTRL, 32'h1 << CTRL_CLEAR_BIT);
+      #(CLK_PERIOD);
+
+      for (i = 0; i < 8; i = i + 1) begin
+        read_word(ADDR_H0 + i);
+        digest[i*32+:32] = read_data;
+      end
+      check_digest(256'h0);
+
+      $display("--- test_clear: completed.");
+      $display("");
+    end
+  endtask  // test_clear
+
+
+  //----------------------------------------------------------------
+  // exit_with_error_code()
+  //
+  // Exit with the right error code
+  //----------------------------------------------------------------
+  task exit_with_error_code;
+    begin
+      if (error_ctr == 0) begin
+        $finish(0);
+      end
+      else begin
+        $fatal(1);
+      end
+    end
+  endtask  // exit_with_error_code
+
+
+  //----------------------------------------------------------------
+  // blake2s_test
+  //----------------------------------------------------------------
+  initial begin : blake2s_test
+    $display("");
+    $display("   -= Testbench for blake2s started =-");
+    $display("     ===============================");
+    $display("");
+
+    init_sim();
+    reset_dut();
+    test_name();
+    test_zero_length();
+    test_abc_message();
+    test_one_block_message();
+    test_one_block_one_byte_message();
+    test_clear();
+
+    display_test_result();
+    $display("");
+    $display("   -= Testbench for blake2s completed =-");
+    $display("     =================================");
+    $display("");
+    exit_with_error_code();
+  end  // blake2s_test
+endmodule  // tb_blake2s
+
+//======================================================================
+// EOF tb_blake2s.v
+//======================================================================
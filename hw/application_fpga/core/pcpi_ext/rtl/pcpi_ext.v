@@ -0,0 +1,336 @@
+//======================================================================
+//
+// pcpi_ext.v
+// ----------
+// PicoRV32 co-processor with rotate instructions and a 32x32->64 bit
+// multiplier used for both the M extension multiplications and
+// multiply-accumulate.
+//
+//
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+//
+//======================================================================
+
+`default_nettype none
+
+module pcpi_ext (
+    input wire clk,
+    input wire reset_n,
+
+    input  wire          pcpi_valid,
+    input  wire [31 : 0] pcpi_insn,
+    input  wire [31 : 0] pcpi_rs1,
+    input  wire [31 : 0] pcpi_rs2,
+    output wire          pcpi_wr,
+    output wire [31 : 0] pcpi_rd,
+    output wire          pcpi_wait,
+    output wire          pcpi_ready
+);
+
+
+  //----------------------------------------------------------------
+  // Internal constant and parameter definitions.
+  //----------------------------------------------------------------
+  localparam OPCODE_OP = 7'b0110011;
+  localparam OPCODE_OP_IMM = 7'b0010011;
+  localparam OPCODE_CUSTOM1 = 7'b0101011;
+
+  // ror, rol and rori as in the Zbb and Zbkb extensions.
+  localparam FUNCT7_ROT = 7'b0110000;
+  localparam FUNCT3_ROL = 3'b001;
+  localparam FUNCT3_ROR = 3'b101;
+
+  // mul, mulh, mulhsu and mulhu from the M extension.
+  localparam FUNCT7_MUL = 7'b0000001;
+  localparam FUNCT3_MUL = 3'b000;
+  localparam FUNCT3_MULH = 3'b001;
+  localparam FUNCT3_MULHSU = 3'b010;
+  localparam FUNCT3_MULHU = 3'b011;
+
+  // Multiply-accumulate on custom-1.
+  localparam FUNCT7_MAC = 7'b0000000;
+  localparam FUNCT3_MAC = 3'b000;
+  localparam FUNCT3_MACU = 3'b001;
+  localparam FUNCT3_MACSET = 3'b010;
+  localparam FUNCT3_MACLO = 3'b100;
+  localparam FUNCT3_MACHI = 3'b101;
+
+
+  //----------------------------------------------------------------
+  // Registers including update variables and write enable.
+  //----------------------------------------------------------------
+  reg          ready_reg;
+  reg          ready_new;
+
+  reg          wr_reg;
+  reg          wr_new;
+
+  reg [31 : 0] rd_reg;
+  reg [31 : 0] rd_new;
+
+  reg [32 : 0] mul_a_reg;
+  reg [32 : 0] mul_b_reg;
+  reg [32 : 0] mul_a_new;
+  reg [32 : 0] mul_b_new;
+  reg          mul_rd_reg;
+  reg          mul_rd_new;
+  reg          mul_hi_reg;
+  reg          mul_hi_new;
+  reg          mul_we;
+  reg          mul_valid_reg;
+
+  reg [63 : 0] prod_reg;
+  reg          prod_valid_reg;
+
+  reg [63 : 0] acc_reg;
+  reg [63 : 0] acc_new;
+  reg          acc_we;
+
+
+  //----------------------------------------------------------------
+  // Wires.
+  //----------------------------------------------------------------
+  wire [ 6 : 0] opcode;
+  wire [ 2 : 0] funct3;
+  wire [ 6 : 0] funct7;
+  wire          mac_busy;
+
+  reg  [ 4 : 0] rot_amount;
+  reg  [63 : 0] rot_double;
+
+
+  //----------------------------------------------------------------
+  // Concurrent connectivity for ports etc.
+  //----------------------------------------------------------------
+  assign opcode     = pcpi_insn[6 : 0];
+  assign funct3     = pcpi_insn[14 : 12];
+  assign funct7     = pcpi_insn[31 : 25];
+
+  assign mac_busy   = mul_valid_reg | prod_valid_reg;
+
+  assign pcpi_wr    = wr_reg;
+  assign pcpi_rd    = rd_reg;
+  assign pcpi_wait  = mac_busy & mul_rd_reg;
+  assign pcpi_ready = ready_reg;
+
+
+  //----------------------------------------------------------------
+  // reg_update
+  //----------------------------------------------------------------
+  always @(posedge clk) begin : reg_update
+    if (!reset_n) begin
+      ready_reg      <= 1'h0;
+      wr_reg         <= 1'h0;
+      rd_reg         <= 32'h0;
+      mul_a_reg      <= 33'h0;
+      mul_b_reg      <= 33'h0;
+      mul_rd_reg     <= 1'h0;
+      mul_hi_reg     <= 1'h0;
+      mul_valid_reg  <= 1'h0;
+      prod_reg       <= 64'h0;
+      prod_valid_reg <= 1'h0;
+      acc_reg        <= 64'h0;
+    end
+
+    else begin
+      ready_reg      <= ready_new;
+      wr_reg         <= wr_new;
+      rd_reg         <= rd_new;
+
+      mul_valid_reg  <= mul_we;
+      prod_valid_reg <= mul_valid_reg;
+
+      if (mul_we) begin
+        mul_a_reg  <= mul_a_new;
+        mul_b_reg  <= mul_b_new;
+        mul_rd_reg <= mul_rd_new;
+        mul_hi_reg <= mul_hi_new;
+      end
+
+      if (mul_valid_reg) begin
+        prod_reg <= $signed(mul_a_reg) * $signed(mul_b_reg);
+      end
+
+      if (acc_we) begin
+        acc_reg <= acc_new;
+      end
+    end
+  end  // reg_update
+
+
+  //----------------------------------------------------------------
+  // rotate
+  //
+  // Rotations are done as a shift of the operand concatenated
+  // with itself.
+  //----------------------------------------------------------------
+  always @* begin : rotate
+    if (opcode == OPCODE_OP_IMM) begin
+      rot_amount = pcpi_insn[24 : 20];
+    end
+    else begin
+      rot_amount = pcpi_rs2[4 : 0];
+    end
+
+    if (funct3 == FUNCT3_ROL) begin
+      rot_double = {pcpi_rs1, pcpi_rs1} << rot_amount;
+    end
+    else begin
+      rot_double = {pcpi_rs1, pcpi_rs1} >> rot_amount;
+    end
+  end  // rotate
+
+
+  //----------------------------------------------------------------
+  // accumulate
+  //
+  // The product of a multiply-accumulate is added to the
+  // accumulator two cycles after the instruction is acknowledged.
+  // Products of the M extension instructions go to rd instead.
+  //----------------------------------------------------------------
+  always @* begin : accumulate
+    acc_we  = 1'h0;
+    acc_new = acc_reg + prod_reg;
+
+    if (prod_valid_reg && !mul_rd_reg) begin
+      acc_we = 1'h1;
+    end
+
+    if (pcpi_valid && !ready_reg && !mac_busy && (opcode == OPCODE_CUSTOM1) &&
+        (funct7 == FUNCT7_MAC) && (funct3 == FUNCT3_MACSET)) begin
+      acc_we  = 1'h1;
+      acc_new = {pcpi_rs2, pcpi_rs1};
+    end
+  end  // accumulate
+
+
+  //----------------------------------------------------------------
+  // decode
+  //
+  // Instruction decoding. Instructions not decoded here are left
+  // for the rest of the co-processors or to trap. An instruction
+  // is acknowledged in the cycle after it is presented, since the
+  // CPU holds pcpi_valid in the cycle pcpi_ready is set it is not
+  // executed again. Multiply-accumulate instructions wait until the
+  // previous product has been accumulated.
+  //
+  // The M extension multiplications use the same multiplier, so the
+  // CPU is built without one of its own. They are acknowledged when
+  // the product is ready, with pcpi_wait set meanwhile.
+  //----------------------------------------------------------------
+  always @* begin : decode
+    ready_new  = 1'h0;
+    wr_new     = 1'h0;
+    rd_new     = 32'h0;
+    mul_we     = 1'h0;
+    mul_a_new  = {pcpi_rs1[31], pcpi_rs1};
+    mul_b_new  = {pcpi_rs2[31], pcpi_rs2};
+    mul_rd_new = 1'h0;
+    mul_hi_new = 1'h0;
+
+    if (pcpi_valid && !ready_reg) begin
+      if (prod_valid_reg && mul_rd_reg) begin
+        ready_new = 1'h1;
+        wr_new    = 1'h1;
+        if (mul_hi_reg) begin
+          rd_new = prod_reg[63 : 32];
+        end
+        else begin
+          rd_new = prod_reg[31 : 0];
+        end
+      end
+
+      if ((opcode == OPCODE_OP) && (funct7 == FUNCT7_MUL) && !mac_busy) begin
+        case (funct3)
+          FUNCT3_MUL: begin
+            mul_we     = 1'h1;
+            mul_rd_new = 1'h1;
+          end
+
+          FUNCT3_MULH: begin
+            mul_we     = 1'h1;
+            mul_rd_new = 1'h1;
+            mul_hi_new = 1'h1;
+          end
+
+          FUNCT3_MULHSU: begin
+            mul_we     = 1'h1;
+            mul_rd_new = 1'h1;
+            mul_hi_new = 1'h1;
+            mul_b_new  = {1'h0, pcpi_rs2};
+          end
+
+          FUNCT3_MULHU: begin
+            mul_we     = 1'h1;
+            mul_rd_new = 1'h1;
+            mul_hi_new = 1'h1;
+            mul_a_new  = {1'h0, pcpi_rs1};
+            mul_b_new  = {1'h0, pcpi_rs2};
+          end
+
+          default: begin
+          end
+        endcase
+      end
+
+      if ((opcode == OPCODE_OP) && (funct7 == FUNCT7_ROT) && (funct3 == FUNCT3_ROL)) begin
+        ready_new = 1'h1;
+        wr_new    = 1'h1;
+        rd_new    = rot_double[63 : 32];
+      end
+
+      if ((opcode == OPCODE_OP) && (funct7 == FUNCT7_ROT) && (funct3 == FUNCT3_ROR)) begin
+        ready_new = 1'h1;
+        wr_new    = 1'h1;
+        rd_new    = rot_double[31 : 0];
+      end
+
+      if ((opcode == OPCODE_OP_IMM) && (funct7 == FUNCT7_ROT) && (funct3 == FUNCT3_ROR)) begin
+        ready_new = 1'h1;
+        wr_new    = 1'h1;
+        rd_new    = rot_double[31 : 0];
+      end
+
+      if ((opcode == OPCODE_CUSTOM1) && (funct7 == FUNCT7_MAC) && !mac_busy) begin
+        case (funct3)
+          FUNCT3_MAC: begin
+            ready_new = 1'h1;
+            mul_we    = 1'h1;
+          end
+
+          FUNCT3_MACU: begin
+            ready_new = 1'h1;
+            mul_we    = 1'h1;
+            mul_a_new = {1'h0, pcpi_rs1};
+            mul_b_new = {1'h0, pcpi_rs2};
+          end
+
+          FUNCT3_MACSET: begin
+            ready_new = 1'h1;
+          end
+
+          FUNCT3_MACLO: begin
+            ready_new = 1'h1;
+            wr_new    = 1'h1;
+            rd_new    = acc_reg[31 : 0];
+          end
+
+          FUNCT3_MACHI: begin
+            ready_new = 1'h1;
+            wr_new    = 1'h1;
+            rd_new    = acc_reg[63 : 32];
+          end
+
+          default: begin
+          end
+        endcase
+      end
+    end
+  end  // decode
+
+endmodule  // pcpi_ext
+
+//======================================================================
+// EOF pcpi_ext.v
+//======================================================================
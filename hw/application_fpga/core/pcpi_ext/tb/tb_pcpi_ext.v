@@ -0,0 +1,478 @@
+//======================================================================
+//
+// tb_pcpi_ext.v
+// -------------
+// Testbench for the pcpi_ext co-processor.
+//
+//
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+//
+//======================================================================
+
+`default_nettype none
+
+module tb_pcpi_ext ();
+
+  //----------------------------------------------------------------
+  // Internal constant and parameter definitions.
+  //----------------------------------------------------------------
+  parameter DEBUG = 0;
+  parameter DUMP_WAIT = 0;
+
+  parameter CLK_HALF_PERIOD = 1;
+  parameter CLK_PERIOD = 2 * CLK_HALF_PERIOD;
+
+  localparam OPCODE_OP = 7'b0110011;
+  localparam OPCODE_OP_IMM = 7'b0010011;
+  localparam OPCODE_CUSTOM1 = 7'b0101011;
+
+  localparam FUNCT7_ROT = 7'b0110000;
+  localparam FUNCT7_MAC = 7'b0000000;
+  localparam FUNCT7_MUL = 7'b0000001;
+
+  localparam FUNCT3_ROL = 3'b001;
+  localparam FUNCT3_ROR = 3'b101;
+  localparam FUNCT3_MAC = 3'b000;
+  localparam FUNCT3_MACU = 3'b001;
+  localparam FUNCT3_MACSET = 3'b010;
+  localparam FUNCT3_MACLO = 3'b100;
+  localparam FUNCT3_MACHI = 3'b101;
+
+  // The CPU traps if an instruction isn't acknowledged in time.
+  localparam PCPI_TIMEOUT = 16;
+
+
+  //----------------------------------------------------------------
+  // Register and Wire declarations.
+  //----------------------------------------------------------------
+  reg  [31 : 0] cycle_ctr;
+  reg  [31 : 0] error_ctr;
+  reg  [31 : 0] tc_ctr;
+  reg           tb_monitor;
+
+  reg           tb_clk;
+  reg           tb_reset_n;
+  reg           tb_pcpi_valid;
+  reg  [31 : 0] tb_pcpi_insn;
+  reg  [31 : 0] tb_pcpi_rs1;
+  reg  [31 : 0] tb_pcpi_rs2;
+  wire          tb_pcpi_wr;
+  wire [31 : 0] tb_pcpi_rd;
+  wire          tb_pcpi_wait;
+  wire          tb_pcpi_ready;
+
+  reg           exec_ready;
+  reg           exec_wr;
+  reg  [31 : 0] exec_rd;
+
+
+  //----------------------------------------------------------------
+  // Device Under Test.
+  //----------------------------------------------------------------
+  pcpi_ext dut (
+      .clk(tb_clk),
+      .reset_n(tb_reset_n),
+
+      .pcpi_valid(tb_pcpi_valid),
+      .pcpi_insn(tb_pcpi_insn),
+      .pcpi_rs1(tb_pcpi_rs1),
+      .pcpi_rs2(tb_pcpi_rs2),
+      .pcpi_wr(tb_pcpi_wr),
+      .pcpi_rd(tb_pcpi_rd),
+      .pcpi_wait(tb_pcpi_wait),
+      .pcpi_ready(tb_pcpi_ready)
+  );
+
+
+  //----------------------------------------------------------------
+  // clk_gen
+  //
+  // Always running clock generator process.
+  //----------------------------------------------------------------
+  always begin : clk_gen
+    #CLK_HALF_PERIOD;
+    tb_clk = !tb_clk;
+  end  // clk_gen
+
+
+  //----------------------------------------------------------------
+  // sys_monitor()
+  //
+  // An always running process that creates a cycle counter and
+  // conditionally displays information about the DUT.
+  //----------------------------------------------------------------
+  always begin : sys_monitor
+    cycle_ctr = cycle_ctr + 1;
+    #(CLK_PERIOD);
+    if (tb_monitor) begin
+      dump_dut_state();
+    end
+  end
+
+
+  //----------------------------------------------------------------
+  // dump_dut_state()
+  //
+  // Dump the state of the dump when needed.
+  //----------------------------------------------------------------
+  task dump_dut_state;
+    begin
+      $display("State of DUT");
+      $display("------------");
+      $display("Cycle: %08d", cycle_ctr);
+      $display("");
+      $display("Inputs and outputs:");
+      $display("pcpi_valid: 0x%1x, pcpi_insn: 0x%08x, pcpi_rs1: 0x%08x, pcpi_rs2: 0x%08x",
+               tb_pcpi_valid, tb_pcpi_insn, tb_pcpi_rs1, tb_pcpi_rs2);
+      $display("pcpi_wr: 0x%1x, pcpi_rd: 0x%08x, pcpi_ready: 0x%1x", tb_pcpi_wr, tb_pcpi_rd,
+               tb_pcpi_ready);
+      $display("");
+      $display("Internal state:");
+      $display("mul_valid_reg: 0x%1x, prod_valid_reg: 0x%1x, prod_reg: 0x%016x",
+               dut.mul_valid_reg, dut.prod_valid_reg, dut.prod_reg);
+      $display("acc_reg: 0x%016x", dut.acc_reg);
+      $display("");
+      $display("");
+    end
+  endtask  // dump_dut_state
+
+
+  //----------------------------------------------------------------
+  // reset_dut()
+  //
+  // Toggle reset to put the DUT into a well known state.
+  //----------------------------------------------------------------
+  task reset_dut;
+    begin
+      $display("--- Toggle reset.");
+      tb_reset_n = 0;
+      #(2 * CLK_PERIOD);
+      tb_reset_n = 1;
+    end
+  endtask  // reset_dut
+
+
+  //----------------------------------------------------------------
+  // display_test_result()
+  //
+  // Display the accumulated test results.
+  //----------------------------------------------------------------
+  task display_test_result;
+    begin
+      if (error_ctr == 0) begin
+        $display("--- All %02d test cases completed successfully", tc_ctr);
+      end
+      else begin
+        $display("--- %02d tests completed - %02d test cases did not complete successfully.",
+                 tc_ctr, error_ctr);
+      end
+    end
+  endtask  // display_test_result
+
+
+  //----------------------------------------------------------------
+  // init_sim()
+  //
+  // Initialize all counters and testbed functionality as well
+  // as setting the DUT inputs to defined values.
+  //----------------------------------------------------------------
+  task init_sim;
+    begin
+      cycle_ctr     = 0;
+      error_ctr     = 0;
+      tc_ctr        = 0;
+      tb_monitor    = 0;
+
+      tb_clk        = 1'h0;
+      tb_reset_n    = 1'h1;
+      tb_pcpi_valid = 1'h0;
+      tb_pcpi_insn  = 32'h0;
+      tb_pcpi_rs1   = 32'h0;
+      tb_pcpi_rs2   = 32'h0;
+    end
+  endtask  // init_sim
+
+
+  //----------------------------------------------------------------
+  // r_insn()
+  //
+  // An R-type instruction with rd x3, rs1 x1 and rs2 x2.
+  //----------------------------------------------------------------
+  function [31 : 0] r_insn(input [6 : 0] funct7, input [2 : 0] funct3, input [6 : 0] opcode);
+    begin
+      r_insn = {funct7, 5'd2, 5'd1, funct3, 5'd3, opcode};
+    end
+  endfunction  // r_insn
+
+
+  //----------------------------------------------------------------
+  // exec()
+  //
+  // Present an instruction to the DUT like the CPU does. pcpi_valid
+  // is held until the cycle after pcpi_ready is seen, or until the
+  // CPU would have trapped. The result is available in exec_ready,
+  // exec_wr and exec_rd.
+  //----------------------------------------------------------------
+  task exec(input [31 : 0] insn, input [31 : 0] rs1, input [31 : 0] rs2);
+    begin : exec
+      integer cycles;
+
+      tb_pcpi_insn  = insn;
+      tb_pcpi_rs1   = rs1;
+      tb_pcpi_rs2   = rs2;
+      tb_pcpi_valid = 1'h1;
+
+      exec_ready    = 1'h0;
+      exec_wr       = 1'h0;
+      exec_rd       = 32'h0;
+      cycles        = 0;
+
+      while (!exec_ready && (cycles < PCPI_TIMEOUT)) begin
+        #(CLK_PERIOD);
+        cycles = cycles + 1;
+        if (tb_pcpi_ready) begin
+          exec_ready = 1'h1;
+          exec_wr    = tb_pcpi_wr;
+          exec_rd    = tb_pcpi_rd;
+        end
+      end
+
+      #(CLK_PERIOD);
+      tb_pcpi_valid = 1'h0;
+
+      if (DEBUG) begin
+        $display("--- insn 0x%08x rs1 0x%08x rs2 0x%08x: ready %1d wr %1d rd 0x%08x", insn, rs1,
+                 rs2, exec_ready, exec_wr, exec_rd);
+      end
+    end
+  endtask  // exec
+
+
+  //----------------------------------------------------------------
+  // check_rd()
+  //
+  // Execute the instruction and check that it was acknowledged
+  // with the expected result.
+  //----------------------------------------------------------------
+  task check_rd(input [31 : 0] insn, input [31 : 0] rs1, input [31 : 0] rs2,
+                input [31 : 0] expected);
+    begin
+      exec(insn, rs1, rs2);
+
+      if (!exec_ready || !exec_wr || (exec_rd != expected)) begin
+        $display("--- Error: insn 0x%08x rs1 0x%08x rs2 0x%08x", insn, rs1, rs2);
+        $display("--- Expected: 0x%08x, got ready %1d wr %1d rd 0x%08x", expected,
+                 exec_ready, exec_wr, exec_rd);
+        error_ctr = error_ctr + 1;
+      end
+    end
+  endtask  // check_rd
+
+
+  //----------------------------------------------------------------
+  // check_no_rd()
+  //
+  // Execute an instruction that should be acknowledged without
+  // writing rd.
+  //----------------------------------------------------------------
+  task check_no_rd(input [31 : 0] insn, input [31 : 0] rs1, input [31 : 0] rs2);
+    begin
+      exec(insn, rs1, rs2);
+
+      if (!exec_ready || exec_wr) begin
+        $display("--- Error: insn 0x%08x: ready %1d wr %1d", insn, exec_ready, exec_wr);
+        error_ctr = error_ctr + 1;
+      end
+    end
+  endtask  // check_no_rd
+
+
+  //----------------------------------------------------------------
+  // check_acc()
+  //
+  // Read out the accumulator and compare.
+  //----------------------------------------------------------------
+  task check_acc(input [63 : 0] expected);
+    begin
+      check_rd(r_insn(FUNCT7_MAC, FUNCT3_MACLO, OPCODE_CUSTOM1), 32'h0, 32'h0,
+               expected[31 : 0]);
+      check_rd(r_insn(FUNCT7_MAC, FUNCT3_MACHI, OPCODE_CUSTOM1), 32'h0, 32'h0,
+               expected[63 : 32]);
+    end
+  endtask  // check_acc
+
+
+  //----------------------------------------------------------------
+  // test_rotate()
+  // ror, rol and rori, with the rotate amount taken modulo 32.
+  //----------------------------------------------------------------
+  task test_rotate;
+    begin
+      tc_ctr = tc_ctr + 1;
+
+      $display("");
+      $display("--- test_rotate: started.");
+
+      check_rd(r_insn(FUNCT7_ROT, FUNCT3_ROR, OPCODE_OP), 32'h12345678, 32'd8, 32'h78123456);
+      check_rd(r_insn(FUNCT7_ROT, FUNCT3_ROL, OPCODE_OP), 32'h12345678, 32'd8, 32'h34567812);
+      check_rd(r_insn(FUNCT7_ROT, FUNCT3_ROR, OPCODE_OP), 32'h12345678, 32'd0, 32'h12345678);
+      check_rd(r_insn(FUNCT7_ROT, FUNCT3_ROR, OPCODE_OP), 32'h12345678, 32'd36, 32'h81234567);
+      check_rd(r_insn(FUNCT7_ROT, FUNCT3_ROL, OPCODE_OP), 32'h80000001, 32'd1, 32'h00000003);
+
+      // rori 7, the rotate amount is in the rs2 field.
+      check_rd({FUNCT7_ROT, 5'd7, 5'd1, FUNCT3_ROR, 5'd3, OPCODE_OP_IMM}, 32'h00000080,
+               32'hdeadbeef, 32'h00000001);
+      check_rd({FUNCT7_ROT, 5'd16, 5'd1, FUNCT3_ROR, 5'd3, OPCODE_OP_IMM}, 32'h12345678,
+               32'hdeadbeef, 32'h56781234);
+
+      $display("--- test_rotate: completed.");
+      $display("");
+    end
+  endtask  // test_rotate
+
+
+  //----------------------------------------------------------------
+  // test_mac()
+  // Signed and unsigned multiply-accumulate.
+  //----------------------------------------------------------------
+  task test_mac;
+    begin
+      tc_ctr = tc_ctr + 1;
+
+      $display("");
+      $display("--- test_mac: started.");
+
+      check_no_rd(r_insn(FUNCT7_MAC, FUNCT3_MACSET, OPCODE_CUSTOM1), 32'h89abcdef, 32'h01234567);
+      check_acc(64'h0123456789abcdef);
+
+      check_no_rd(r_insn(FUNCT7_MAC, FUNCT3_MACSET, OPCODE_CUSTOM1), 32'h0, 32'h0);
+      check_no_rd(r_insn(FUNCT7_MAC, FUNCT3_MAC, OPCODE_CUSTOM1), -32'sd3, 32'd5);
+      check_no_rd(r_insn(FUNCT7_MAC, FUNCT3_MAC, OPCODE_CUSTOM1), 32'h7fffffff, 32'h7fffffff);
+      check_acc(64'h3ffffffefffffff2);
+
+      check_no_rd(r_insn(FUNCT7_MAC, FUNCT3_MACSET, OPCODE_CUSTOM1), 32'h0, 32'h0);
+      check_no_rd(r_insn(FUNCT7_MAC, FUNCT3_MAC, OPCODE_CUSTOM1), 32'h80000000, 32'h80000000);
+      check_no_rd(r_insn(FUNCT7_MAC, FUNCT3_MAC, OPCODE_CUSTOM1), 32'hffffffff, 32'h00000001);
+      check_acc(64'h3fffffffffffffff);
+
+      check_no_rd(r_insn(FUNCT7_MAC, FUNCT3_MACSET, OPCODE_CUSTOM1), 32'h0, 32'h0);
+      check_no_rd(r_insn(FUNCT7_MAC, FUNCT3_MACU, OPCODE_CUSTOM1), 32'hffffffff, 32'h00000002);
+      check_acc(64'h00000001fffffffe);
+
+      $display("--- test_mac: completed.");
+      $display("");
+    end
+  endtask  // test_mac
+
+
+  //----------------------------------------------------------------
+  // test_mul()
+  // mul, mulh, mulhsu and mulhu, and that they don't touch the
+  // accumulator.
+  //----------------------------------------------------------------
+  task test_mul;
+    begin
+      tc_ctr = tc_ctr + 1;
+
+      $display("");
+      $display("--- test_mul: started.");
+
+      check_no_rd(r_insn(FUNCT7_MAC, FUNCT3_MACSET, OPCODE_CUSTOM1), 32'h89abcdef, 32'h01234567);
+
+      check_rd(r_insn(FUNCT7_MUL, 3'b000, OPCODE_OP), 32'd6, 32'd7, 32'd42);
+      check_rd(r_insn(FUNCT7_MUL, 3'b000, OPCODE_OP), -32'sd3, 32'd5, -32'sd15);
+      check_rd(r_insn(FUNCT7_MUL, 3'b000, OPCODE_OP), 32'h12345678, 32'h9abcdef0, 32'h242d2080);
+
+      check_rd(r_insn(FUNCT7_MUL, 3'b001, OPCODE_OP), 32'hffffffff, 32'hffffffff, 32'h00000000);
+      check_rd(r_insn(FUNCT7_MUL, 3'b001, OPCODE_OP), 32'h80000000, 32'h80000000, 32'h40000000);
+      check_rd(r_insn(FUNCT7_MUL, 3'b001, OPCODE_OP), 32'h80000000, 32'h00000002, 32'hffffffff);
+
+      check_rd(r_insn(FUNCT7_MUL, 3'b010, OPCODE_OP), 32'hffffffff, 32'hffffffff, 32'hffffffff);
+      check_rd(r_insn(FUNCT7_MUL, 3'b010, OPCODE_OP), 32'h00000002, 32'hffffffff, 32'h00000001);
+
+      check_rd(r_insn(FUNCT7_MUL, 3'b011, OPCODE_OP), 32'hffffffff, 32'hffffffff, 32'hfffffffe);
+      check_rd(r_insn(FUNCT7_MUL, 3'b011, OPCODE_OP), 32'h12345678, 32'h9abcdef0, 32'h0b00ea4e);
+
+      check_acc(64'h0123456789abcdef);
+
+      $display("--- test_mul: completed.");
+      $display("");
+    end
+  endtask  // test_mul
+
+
+  //----------------------------------------------------------------
+  // test_other_insn()
+  // Instructions for other co-processors are not acknowledged.
+  //----------------------------------------------------------------
+  task test_other_insn;
+    begin
+      tc_ctr = tc_ctr + 1;
+
+      $display("");
+      $display("--- test_other_insn: started.");
+
+      exec(r_insn(FUNCT7_MUL, 3'b100, OPCODE_OP), 32'h6, 32'h3);
+      if (exec_ready) begin
+        $display("--- Error: div was acknowledged.");
+        error_ctr = error_ctr + 1;
+      end
+
+      exec(r_insn(FUNCT7_MAC, 3'b111, OPCODE_CUSTOM1), 32'h2, 32'h3);
+      if (exec_ready) begin
+        $display("--- Error: unused custom-1 instruction was acknowledged.");
+        error_ctr = error_ctr + 1;
+      end
+
+      $display("--- test_other_insn: completed.");
+      $display("");
+    end
+  endtask  // test_other_insn
+
+
+  //----------------------------------------------------------------
+  // exit_with_error_code()
+  //
+  // Exit with the right error code
+  //----------------------------------------------------------------
+  task exit_with_error_code;
+    begin
+      if (error_ctr == 0) begin
+        $finish(0);
+      end
+      else begin
+        $fatal(1);
+      end
+    end
+  endtask  // exit_with_error_code
+
+
+  //----------------------------------------------------------------
+  // pcpi_ext_test
+  //----------------------------------------------------------------
+  initial begin : pcpi_ext_test
+    $display("");
+    $display("   -= Testbench for pcpi_ext started =-");
+    $display("     ================================");
+    $display("");
+
+    init_sim();
+    reset_dut();
+    test_rotate();
+    test_mac();
+    test_mul();
+    test_other_insn();
+
+    display_test_result();
+    $display("");
+    $display("   -= Testbench for pcpi_ext completed =-");
+    $display("     ==================================");
+    $display("");
+    exit_with_error_code();
+  end  // pcpi_ext_test
+endmodule  // tb_pcpi_ext
+
+//======================================================================
+// EOF tb_pcpi_ext.v
+//======================================================================
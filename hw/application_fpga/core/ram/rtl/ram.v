@@ -9,6 +9,10 @@
 // The block also implements data and address scrambling controlled
 // by the ram_addr_rand and ram_data_rand seeds.
 //
+// The block can also fill the whole memory with a pseudo random
+// stream, generated by an xorwow generator. During the fill, which
+// takes one cycle per word, accesses are held until the fill is done.
+//
 //
 // Author: Joachim Strombergson
 // SPDX-FileCopyrightText: 2022 Tillitis AB <tillitis.se>
@@ -25,6 +29,11 @@ module ram (
     input wire [14 : 0] ram_addr_rand,
     input wire [31 : 0] ram_data_rand,
 
+    input  wire          fill_start,
+    input  wire [31 : 0] fill_seed,
+    input  wire [31 : 0] fill_acc,
+    output wire          fill_busy,
+
     input  wire          cs,
     input  wire [ 3 : 0] we,
     input  wire [15 : 0] address,
@@ -39,6 +48,18 @@ module ram (
   //----------------------------------------------------------------
   reg          ready_reg;
 
+  reg [31 : 0] fill_state_reg;
+  reg [31 : 0] fill_state_new;
+  reg          fill_state_we;
+
+  reg [14 : 0] fill_ctr_reg;
+  reg [14 : 0] fill_ctr_new;
+  reg          fill_ctr_we;
+
+  reg          fill_busy_reg;
+  reg          fill_busy_new;
+  reg          fill_busy_we;
+
   reg          cs0;
   reg          cs1;
   reg [31 : 0] read_data0;
@@ -49,22 +70,28 @@ module ram (
   reg [31 : 0] scrambled_write_data;
   reg [31 : 0] descrambled_read_data;
 
+  reg [14 : 0] spram_addr;
+  reg [31 : 0] spram_write_data;
+  reg [ 3 : 0] spram_we;
+  reg          spram_cs;
+
 
   //----------------------------------------------------------------
   // Concurrent assignment of ports.
   //----------------------------------------------------------------
   assign read_data = descrambled_read_data;
   assign ready     = ready_reg;
+  assign fill_busy = fill_busy_reg;
 
 
   //----------------------------------------------------------------
   // SPRAM instances.
   //----------------------------------------------------------------
   SB_SPRAM256KA spram0 (
-      .ADDRESS(scrambled_ram_addr[13:0]),
-      .DATAIN(scrambled_write_data[15:0]),
-      .MASKWREN({we[1], we[1], we[0], we[0]}),
-      .WREN(we[1] | we[0]),
+      .ADDRESS(spram_addr[13:0]),
+      .DATAIN(spram_write_data[15:0]),
+      .MASKWREN({spram_we[1], spram_we[1], spram_we[0], spram_we[0]}),
+      .WREN(spram_we[1] | spram_we[0]),
       .CHIPSELECT(cs0),
       .CLOCK(clk),
       .STANDBY(1'b0),
@@ -74,10 +101,10 @@ module ram (
   );
 
   SB_SPRAM256KA spram1 (
-      .ADDRESS(scrambled_ram_addr[13:0]),
-      .DATAIN(scrambled_write_data[31:16]),
-      .MASKWREN({we[3], we[3], we[2], we[2]}),
-      .WREN(we[3] | we[2]),
+      .ADDRESS(spram_addr[13:0]),
+      .DATAIN(spram_write_data[31:16]),
+      .MASKWREN({spram_we[3], spram_we[3], spram_we[2], spram_we[2]}),
+      .WREN(spram_we[3] | spram_we[2]),
       .CHIPSELECT(cs0),
       .CLOCK(clk),
       .STANDBY(1'b0),
@@ -88,10 +115,10 @@ module ram (
 
 
   SB_SPRAM256KA spram2 (
-      .ADDRESS(scrambled_ram_addr[13:0]),
-      .DATAIN(scrambled_write_data[15:0]),
-      .MASKWREN({we[1], we[1], we[0], we[0]}),
-      .WREN(we[1] | we[0]),
+      .ADDRESS(spram_addr[13:0]),
+      .DATAIN(spram_write_data[15:0]),
+      .MASKWREN({spram_we[1], spram_we[1], spram_we[0], spram_we[0]}),
+      .WREN(spram_we[1] | spram_we[0]),
       .CHIPSELECT(cs1),
       .CLOCK(clk),
       .STANDBY(1'b0),
@@ -101,10 +128,10 @@ module ram (
   );
 
   SB_SPRAM256KA spram3 (
-      .ADDRESS(scrambled_ram_addr[13:0]),
-      .DATAIN(scrambled_write_data[31:16]),
-      .MASKWREN({we[3], we[3], we[2], we[2]}),
-      .WREN(we[3] | we[2]),
+      .ADDRESS(spram_addr[13:0]),
+      .DATAIN(spram_write_data[31:16]),
+      .MASKWREN({spram_we[3], spram_we[3], spram_we[2], spram_we[2]}),
+      .WREN(spram_we[3] | spram_we[2]),
       .CHIPSELECT(cs1),
       .CLOCK(clk),
       .STANDBY(1'b0),
@@ -118,15 +145,76 @@ module ram (
   // reg_update
   //
   // Posedge triggered with synchronous, active low reset.
-  // This simply creates a one cycle access latency to match
-  // the latency of the spram blocks.
+  // The ready register simply creates a one cycle access latency
+  // to match the latency of the spram blocks. No access is
+  // acknowledged during a fill.
   //----------------------------------------------------------------
   always @(posedge clk) begin : reg_update
     if (!reset_n) begin
-      ready_reg <= 1'h0;
+      ready_reg      <= 1'h0;
+      fill_state_reg <= 32'h0;
+      fill_ctr_reg   <= 15'h0;
+      fill_busy_reg  <= 1'h0;
     end
     else begin
-      ready_reg <= cs;
+      ready_reg <= cs & ~fill_busy_reg;
+
+      if (fill_state_we) begin
+        fill_state_reg <= fill_state_new;
+      end
+
+      if (fill_ctr_we) begin
+        fill_ctr_reg <= fill_ctr_new;
+      end
+
+      if (fill_busy_we) begin
+        fill_busy_reg <= fill_busy_new;
+      end
+    end
+  end
+
+
+  //----------------------------------------------------------------
+  // fill_logic
+  //
+  // Write the xorwow stream to every word, in physical address
+  // order, one word per cycle. The scrambling is bypassed so that
+  // every word is written exactly once even if the seeds change
+  // during the fill.
+  //----------------------------------------------------------------
+  always @* begin : fill_logic
+    reg [31 : 0] t0;
+    reg [31 : 0] t1;
+    reg [31 : 0] t2;
+
+    t0             = fill_state_reg ^ {fill_state_reg[18 : 0], 13'h0};
+    t1             = t0 ^ {17'h0, t0[31 : 17]};
+    t2             = t1 ^ {t1[26 : 0], 5'h0};
+
+    fill_state_new = t2 + fill_acc;
+    fill_state_we  = 1'h0;
+    fill_ctr_new   = fill_ctr_reg + 1'h1;
+    fill_ctr_we    = 1'h0;
+    fill_busy_new  = 1'h0;
+    fill_busy_we   = 1'h0;
+
+    if (fill_start) begin
+      fill_state_new = fill_seed;
+      fill_state_we  = 1'h1;
+      fill_ctr_new   = 15'h0;
+      fill_ctr_we    = 1'h1;
+      fill_busy_new  = 1'h1;
+      fill_busy_we   = 1'h1;
+    end
+
+    else if (fill_busy_reg) begin
+      fill_state_we = 1'h1;
+      fill_ctr_we   = 1'h1;
+
+      if (fill_ctr_reg == 15'h7fff) begin
+        fill_busy_new = 1'h0;
+        fill_busy_we  = 1'h1;
+      end
     end
   end
 
@@ -147,12 +235,25 @@ module ram (
   //----------------------------------------------------------------
   // mem_mux
   //
-  // Select which of the data read from the banks should be
-  // returned during a read access.
+  // Select the fill engine or the access, and which of the data
+  // read from the banks should be returned during a read access.
   //----------------------------------------------------------------
   always @* begin : mem_mux
-    cs0 = ~scrambled_ram_addr[14] & cs;
-    cs1 = scrambled_ram_addr[14] & cs;
+    if (fill_busy_reg) begin
+      spram_addr       = fill_ctr_reg;
+      spram_write_data = fill_state_reg;
+      spram_we         = 4'hf;
+      spram_cs         = 1'h1;
+    end
+    else begin
+      spram_addr       = scrambled_ram_addr;
+      spram_write_data = scrambled_write_data;
+      spram_we         = we;
+      spram_cs         = cs;
+    end
+
+    cs0 = ~spram_addr[14] & spram_cs;
+    cs1 = spram_addr[14] & spram_cs;
 
     if (scrambled_ram_addr[14]) begin
       muxed_read_data = read_data1;
@@ -0,0 +1,50 @@
+//======================================================================
+//
+// SB_SPRAM256KA.v
+// ---------------
+// Simulation model of the SB_SPRAM256KA macro used to build the sim
+// target. Only models what the ram core uses: read, and write with
+// nibble masks.
+//
+//
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+//
+//======================================================================
+
+`default_nettype none
+
+module SB_SPRAM256KA (
+    input  wire [13 : 0] ADDRESS,
+    input  wire [15 : 0] DATAIN,
+    input  wire [ 3 : 0] MASKWREN,
+    input  wire          WREN,
+    input  wire          CHIPSELECT,
+    input  wire          CLOCK,
+    input  wire          STANDBY,
+    input  wire          SLEEP,
+    input  wire          POWEROFF,
+    output reg  [15 : 0] DATAOUT
+);
+
+  reg [15 : 0] mem[0 : 16383];
+
+  always @(posedge CLOCK) begin
+    if (CHIPSELECT) begin
+      if (WREN) begin
+        if (MASKWREN[0]) mem[ADDRESS][3 : 0] <= DATAIN[3 : 0];
+        if (MASKWREN[1]) mem[ADDRESS][7 : 4] <= DATAIN[7 : 4];
+        if (MASKWREN[2]) mem[ADDRESS][11 : 8] <= DATAIN[11 : 8];
+        if (MASKWREN[3]) mem[ADDRESS][15 : 12] <= DATAIN[15 : 12];
+      end
+      else begin
+        DATAOUT <= mem[ADDRESS];
+      end
+    end
+  end
+
+endmodule  // SB_SPRAM256KA
+
+//======================================================================
+// EOF SB_SPRAM256KA.v
+//======================================================================
@@ -0,0 +1,405 @@
+//======================================================================
+//
+// tb_ram.v
+// --------
+// Testbench for the ram core.
+//
+//
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+//
+//======================================================================
+
+`default_nettype none
+
+module tb_ram ();
+
+  //----------------------------------------------------------------
+  // Internal constant and parameter definitions.
+  //----------------------------------------------------------------
+  parameter DEBUG = 0;
+
+  parameter CLK_HALF_PERIOD = 1;
+  parameter CLK_PERIOD = 2 * CLK_HALF_PERIOD;
+
+  localparam RAM_WORDS = 32768;
+
+  localparam ADDR_RAND = 15'h1234;
+  localparam DATA_RAND = 32'hdeadbeef;
+
+
+  //----------------------------------------------------------------
+  // Register and Wire declarations.
+  //----------------------------------------------------------------
+  reg  [31 : 0] cycle_ctr;
+  reg  [31 : 0] error_ctr;
+  reg  [31 : 0] tc_ctr;
+
+  reg           tb_clk;
+  reg           tb_reset_n;
+  reg  [14 : 0] tb_ram_addr_rand;
+  reg  [31 : 0] tb_ram_data_rand;
+  reg           tb_fill_start;
+  reg  [31 : 0] tb_fill_seed;
+  reg  [31 : 0] tb_fill_acc;
+  wire          tb_fill_busy;
+  reg           tb_cs;
+  reg  [ 3 : 0] tb_we;
+  reg  [15 : 0] tb_address;
+  reg  [31 : 0] tb_write_data;
+  wire [31 : 0] tb_read_data;
+  wire          tb_ready;
+
+  reg  [31 : 0] read_data;
+  reg  [31 : 0] access_cycles;
+
+  reg  [31 : 0] fill_mem         [0 : RAM_WORDS - 1];
+
+
+  //----------------------------------------------------------------
+  // Device Under Test.
+  //----------------------------------------------------------------
+  ram dut (
+      .clk(tb_clk),
+      .reset_n(tb_reset_n),
+
+      .ram_addr_rand(tb_ram_addr_rand),
+      .ram_data_rand(tb_ram_data_rand),
+
+      .fill_start(tb_fill_start),
+      .fill_seed(tb_fill_seed),
+      .fill_acc(tb_fill_acc),
+      .fill_busy(tb_fill_busy),
+
+      .cs(tb_cs),
+      .we(tb_we),
+      .address(tb_address),
+      .write_data(tb_write_data),
+      .read_data(tb_read_data),
+      .ready(tb_ready)
+  );
+
+
+  //----------------------------------------------------------------
+  // clk_gen
+  //
+  // Always running clock generator process.
+  //----------------------------------------------------------------
+  always begin : clk_gen
+    #CLK_HALF_PERIOD;
+    tb_clk = !tb_clk;
+  end  // clk_gen
+
+
+  //----------------------------------------------------------------
+  // sys_monitor()
+  //
+  // An always running process that creates a cycle counter.
+  //----------------------------------------------------------------
+  always begin : sys_monitor
+    cycle_ctr = cycle_ctr + 1;
+    #(CLK_PERIOD);
+  end
+
+
+  //----------------------------------------------------------------
+  // reset_dut()
+  //
+  // Toggle reset to put the DUT into a well known state.
+  //----------------------------------------------------------------
+  task reset_dut;
+    begin
+      $display("--- Toggle reset.");
+      tb_reset_n = 0;
+      #(2 * CLK_PERIOD);
+      tb_reset_n = 1;
+    end
+  endtask  // reset_dut
+
+
+  //----------------------------------------------------------------
+  // display_test_result()
+  //
+  // Display the accumulated test results.
+  //----------------------------------------------------------------
+  task display_test_result;
+    begin
+      if (error_ctr == 0) begin
+        $display("--- All %02d test cases completed successfully", tc_ctr);
+      end
+      else begin
+        $display("--- %02d tests completed - %02d test cases did not complete successfully.",
+                 tc_ctr, error_ctr);
+      end
+    end
+  endtask  // display_test_result
+
+
+  //----------------------------------------------------------------
+  // init_sim()
+  //
+  // Initialize all counters and testbed functionality as well
+  // as setting the DUT inputs to defined values.
+  //----------------------------------------------------------------
+  task init_sim;
+    begin
+      cycle_ctr        = 0;
+      error_ctr        = 0;
+      tc_ctr           = 0;
+
+      tb_clk           = 1'h0;
+      tb_reset_n       = 1'h1;
+      tb_ram_addr_rand = ADDR_RAND;
+      tb_ram_data_rand = DATA_RAND;
+      tb_fill_start    = 1'h0;
+      tb_fill_seed     = 32'h0;
+      tb_fill_acc      = 32'h0;
+      tb_cs            = 1'h0;
+      tb_we            = 4'h0;
+      tb_address       = 16'h0;
+      tb_write_data    = 32'h0;
+    end
+  endtask  // init_sim
+
+
+  //----------------------------------------------------------------
+  // access()
+  //
+  // Do an access like the CPU does: keep cs asserted until ready.
+  // A read gives the word in the global variable read_data. The
+  // number of cycles it took ends up in access_cycles.
+  //----------------------------------------------------------------
+  task access(input [3 : 0] we, input [15 : 0] address, input [31 : 0] word);
+    begin
+      tb_address    = address;
+      tb_write_data = word;
+      tb_we         = we;
+      tb_cs         = 1;
+      access_cycles = 1;
+      #(CLK_PERIOD);
+
+      while (!tb_ready) begin
+        access_cycles = access_cycles + 1;
+        #(CLK_PERIOD);
+      end
+
+      read_data = tb_read_data;
+      tb_cs     = 0;
+      tb_we     = 4'h0;
+
+      if (DEBUG) begin
+        $display("--- Access we 0x%1x at 0x%04x: 0x%08x, %0d cycles.", we, address,
+                 we ? word : read_data, access_cycles);
+      end
+    end
+  endtask  // access
+
+
+  //----------------------------------------------------------------
+  // start_fill()
+  //
+  // Pulse fill_start with the given seeds, like the tk1 core does,
+  // and compute what the fill writes to every physical word.
+  //----------------------------------------------------------------
+  task start_fill(input [31 : 0] seed, input [31 : 0] acc);
+    begin : start_fill
+      integer i;
+      reg [31 : 0] s;
+
+      s = seed;
+      for (i = 0; i < RAM_WORDS; i = i + 1) begin
+        fill_mem[i] = s;
+        s = s ^ (s << 13);
+        s = s ^ (s >> 17);
+        s = s ^ (s << 5);
+        s = s + acc;
+      end
+
+      tb_fill_seed  = seed;
+      tb_fill_acc   = acc;
+      tb_fill_start = 1;
+      #(CLK_PERIOD);
+      tb_fill_start = 0;
+    end
+  endtask  // start_fill
+
+
+  //----------------------------------------------------------------
+  // check_word()
+  //
+  // Read the word at the given CPU address and compare it with the
+  // expected word.
+  //----------------------------------------------------------------
+  task check_word(input [15 : 0] address, input [31 : 0] expected);
+    begin
+      access(4'h0, address, 32'h0);
+      if (read_data != expected) begin
+        $display("--- Error at 0x%04x: expected 0x%08x, got 0x%08x", address, expected,
+                 read_data);
+        error_ctr = error_ctr + 1;
+      end
+    end
+  endtask  // check_word
+
+
+  //----------------------------------------------------------------
+  // test1()
+  //
+  // Write words and bytes through the scrambling and read them back.
+  //----------------------------------------------------------------
+  task test1;
+    begin
+      tc_ctr = tc_ctr + 1;
+
+      $display("");
+      $display("--- test1: started.");
+
+      access(4'hf, 16'h0000, 32'h01234567);
+      access(4'hf, 16'h0001, 32'h89abcdef);
+      access(4'hf, 16'h4000, 32'hcafebabe);
+      access(4'hf, 16'h7fff, 32'hf00dfeed);
+      access(4'h2, 16'h0001, 32'h00005a00);
+
+      check_word(16'h0000, 32'h01234567);
+      check_word(16'h0001, 32'h89ab5aef);
+      check_word(16'h4000, 32'hcafebabe);
+      check_word(16'h7fff, 32'hf00dfeed);
+
+      if (access_cycles != 1) begin
+        $display("--- test1: Error, access took %0d cycles, expected 1.", access_cycles);
+        error_ctr = error_ctr + 1;
+      end
+
+      $display("--- test1: completed.");
+      $display("");
+    end
+  endtask  // test1
+
+
+  //----------------------------------------------------------------
+  // test2()
+  //
+  // Fill the whole RAM. A read started during the fill must be held
+  // until fill_busy clears, then every word must have the xorwow
+  // stream, descrambled.
+  //----------------------------------------------------------------
+  task test2;
+    begin : test2
+      integer i;
+      reg [31 : 0] start;
+      reg [31 : 0] fill_cycles;
+
+      tc_ctr = tc_ctr + 1;
+
+      $display("");
+      $display("--- test2: started.");
+
+      start_fill(32'h6a09e667, 32'hbb67ae85);
+      start = cycle_ctr;
+
+      if (!tb_fill_busy) begin
+        $display("--- test2: Error, fill_busy not set after fill_start.");
+        error_ctr = error_ctr + 1;
+      end
+
+      access(4'h0, 16'h0000, 32'h0);
+      $display("--- test2: Read held for %0d cycles.", access_cycles);
+
+      if (tb_fill_busy) begin
+        $display("--- test2: Error, read acknowledged during the fill.");
+        error_ctr = error_ctr + 1;
+      end
+
+      while (tb_fill_busy) #(CLK_PERIOD);
+      fill_cycles = cycle_ctr - start;
+      $display("--- test2: Fill took %0d cycles.", fill_cycles);
+
+      if (access_cycles < RAM_WORDS) begin
+        $display("--- test2: Error, read held for less than the fill.");
+        error_ctr = error_ctr + 1;
+      end
+
+      for (i = 0; i < RAM_WORDS; i = i + 1) begin
+        check_word(i, fill_mem[i[14 : 0] ^ ADDR_RAND] ^ DATA_RAND ^ {2{i[15 : 0]}});
+      end
+
+      $display("--- test2: completed.");
+      $display("");
+    end
+  endtask  // test2
+
+
+  //----------------------------------------------------------------
+  // test3()
+  //
+  // A write started during the fill must be held until fill_busy
+  // clears and then land on top of the filled RAM.
+  //----------------------------------------------------------------
+  task test3;
+    begin
+      tc_ctr = tc_ctr + 1;
+
+      $display("");
+      $display("--- test3: started.");
+
+      start_fill(32'h3c6ef372, 32'ha54ff53a);
+      access(4'hf, 16'h0100, 32'h55aa55aa);
+
+      if (tb_fill_busy) begin
+        $display("--- test3: Error, write acknowledged during the fill.");
+        error_ctr = error_ctr + 1;
+      end
+
+      check_word(16'h0100, 32'h55aa55aa);
+      check_word(16'h0101, fill_mem[15'h0101 ^ ADDR_RAND] ^ DATA_RAND ^ {2{16'h0101}});
+
+      $display("--- test3: completed.");
+      $display("");
+    end
+  endtask  // test3
+
+
+  //----------------------------------------------------------------
+  // exit_with_error_code()
+  //
+  // Exit with the right error code
+  //----------------------------------------------------------------
+  task exit_with_error_code;
+    begin
+      if (error_ctr == 0) begin
+        $finish(0);
+      end
+      else begin
+        $fatal(1);
+      end
+    end
+  endtask  // exit_with_error_code
+
+
+  //----------------------------------------------------------------
+  // ram_test
+  //----------------------------------------------------------------
+  initial begin : ram_test
+    $display("");
+    $display("   -= Testbench for ram started =-");
+    $display("     ===========================");
+    $display("");
+
+    init_sim();
+    reset_dut();
+    test1();
+    test2();
+    test3();
+
+    display_test_result();
+    $display("");
+    $display("   -= Testbench for ram completed =-");
+    $display("     =============================");
+    $display("");
+    exit_with_error_code();
+  end  // ram_test
+endmodule  // tb_ram
+
+//======================================================================
+// EOF tb_ram.v
+//======================================================================
@@ -32,6 +32,11 @@ module tk1 #(
     output wire [14 : 0] ram_addr_rand,
     output wire [31 : 0] ram_data_rand,
 
+    output wire          ram_fill_start,
+    output wire [31 : 0] ram_fill_seed,
+    output wire [31 : 0] ram_fill_acc,
+    input  wire          ram_fill_busy,
+
     output wire spi_ss,
     output wire spi_sck,
     output wire spi_mosi,
@@ -88,6 +93,8 @@ module tk1 #(
 
   localparam ADDR_RAM_ADDR_RAND = 8'h40;
   localparam ADDR_RAM_DATA_RAND = 8'h41;
+  localparam ADDR_RAM_FILL_ACC = 8'h42;
+  localparam ADDR_RAM_FILL = 8'h43;
 
   localparam ADDR_CPU_MON_CTRL = 8'h60;
   localparam ADDR_CPU_MON_FIRST = 8'h61;
@@ -101,7 +108,11 @@ module tk1 #(
 
   localparam TK1_NAME0 = 32'h746B3120;  // "tk1 "
   localparam TK1_NAME1 = 32'h6d6b6466;  // "mkdf"
-  localparam TK1_VERSION = 32'h00000006;
+`ifdef PCPI
+  localparam TK1_VERSION = 32'h00000008;
+`else
+  localparam TK1_VERSION = 32'h00000007;
+`endif
 
   localparam FW_RAM_FIRST = 32'hd0000000;
   localparam FW_RAM_LAST = 32'hd0000fff;  // 4 KB
@@ -144,6 +155,12 @@ module tk1 #(
   reg  [31 : 0] ram_data_rand_reg;
   reg           ram_data_rand_we;
 
+  reg  [31 : 0] ram_fill_acc_reg;
+  reg           ram_fill_acc_we;
+  reg  [31 : 0] ram_fill_seed_reg;
+  reg           ram_fill_seed_we;
+  reg           ram_fill_start_reg;
+
   reg           system_reset_reg;
   reg           system_reset_new;
 
@@ -195,6 +212,10 @@ module tk1 #(
   assign ram_addr_rand   = ram_addr_rand_reg;
   assign ram_data_rand   = ram_data_rand_reg;
 
+  assign ram_fill_start  = ram_fill_start_reg;
+  assign ram_fill_seed   = ram_fill_seed_reg;
+  assign ram_fill_acc    = ram_fill_acc_reg;
+
   assign system_reset    = system_reset_reg;
 
   //----------------------------------------------------------------
@@ -270,6 +291,9 @@ module tk1 #(
       cpu_mon_last_reg    <= 32'h0;
       ram_addr_rand_reg   <= 15'h0;
       ram_data_rand_reg   <= 32'h0;
+      ram_fill_acc_reg    <= 32'h0;
+      ram_fill_seed_reg   <= 32'h0;
+      ram_fill_start_reg  <= 1'h0;
       force_trap_reg      <= 1'h0;
       system_reset_reg    <= 1'h0;
     end
@@ -321,6 +345,17 @@ module tk1 #(
         ram_data_rand_reg <= write_data;
       end
 
+      // Start the fill the cycle after the seed has been stored.
+      ram_fill_start_reg <= ram_fill_seed_we;
+
+      if (ram_fill_acc_we) begin
+        ram_fill_acc_reg <= write_data;
+      end
+
+      if (ram_fill_seed_we) begin
+        ram_fill_seed_reg <= write_data;
+      end
+
       if (cpu_trap_led_we) begin
         cpu_trap_led_reg <= cpu_trap_led_new;
       end
@@ -432,8 +467,13 @@ module tk1 #(
           force_trap_set = 1'h1;
         end
 
+        // Outside BLAKE2S
+        if (cpu_addr[29 : 24] == 6'h05 & |cpu_addr[23 : 10]) begin
+          force_trap_set = 1'h1;
+        end
+
         // In unused space
-        if ((cpu_addr[29 : 24] > 6'h04) && (cpu_addr[29 : 24] < 6'h10)) begin
+        if ((cpu_addr[29 : 24] > 6'h05) && (cpu_addr[29 : 24] < 6'h10)) begin
           force_trap_set = 1'h1;
         end
 
@@ -510,6 +550,8 @@ module tk1 #(
     cdi_mem_we       = 1'h0;
     ram_addr_rand_we = 1'h0;
     ram_data_rand_we = 1'h0;
+    ram_fill_acc_we  = 1'h0;
+    ram_fill_seed_we = 1'h0;
     system_reset_new = 1'h0;
     cpu_mon_en_we    = 1'h0;
     cpu_mon_first_we = 1'h0;
@@ -572,6 +614,18 @@ module tk1 #(
           end
         end
 
+        if (address == ADDR_RAM_FILL_ACC) begin
+          if (!app_mode) begin
+            ram_fill_acc_we = 1'h1;
+          end
+        end
+
+        if (address == ADDR_RAM_FILL) begin
+          if (!app_mode) begin
+            ram_fill_seed_we = 1'h1;
+          end
+        end
+
         if (address == ADDR_CPU_MON_CTRL) begin
           cpu_mon_en_we = 1'h1;
         end
@@ -646,6 +700,10 @@ module tk1 #(
           end
         end
 
+        if (address == ADDR_RAM_FILL) begin
+          tmp_read_data[0] = ram_fill_busy;
+        end
+
         if (address == ADDR_SPI_XFER) begin
           if (!app_mode) begin
             tmp_read_data[0] = spi_ready;
@@ -51,6 +51,8 @@ module tb_tk1 ();
 
   localparam ADDR_RAM_ADDR_RAND = 8'h40;
   localparam ADDR_RAM_DATA_RAND = 8'h41;
+  localparam ADDR_RAM_FILL_ACC = 8'h42;
+  localparam ADDR_RAM_FILL = 8'h43;
 
   localparam ADDR_CPU_MON_CTRL = 8'h60;
   localparam ADDR_CPU_MON_FIRST = 8'h61;
@@ -91,6 +93,11 @@ module tb_tk1 ();
   wire [14 : 0] tb_ram_addr_rand;
   wire [31 : 0] tb_ram_data_rand;
 
+  wire          tb_ram_fill_start;
+  wire [31 : 0] tb_ram_fill_seed;
+  wire [31 : 0] tb_ram_fill_acc;
+  reg           tb_ram_fill_busy;
+
   wire          tb_led_r;
   wire          tb_led_g;
   wire          tb_led_b;
@@ -140,6 +147,11 @@ module tb_tk1 ();
       .ram_addr_rand(tb_ram_addr_rand),
       .ram_data_rand(tb_ram_data_rand),
 
+      .ram_fill_start(tb_ram_fill_start),
+      .ram_fill_seed(tb_ram_fill_seed),
+      .ram_fill_acc(tb_ram_fill_acc),
+      .ram_fill_busy(tb_ram_fill_busy),
+
       .led_r(tb_led_r),
       .led_g(tb_led_g),
       .led_b(tb_led_b),
@@ -288,6 +300,8 @@ module tb_tk1 ();
 
       tb_syscall = 1'h0;
 
+      tb_ram_fill_busy = 1'h0;
+
       tb_cs           = 1'h0;
       tb_we           = 1'h0;
       tb_address      = 8'h0;
@@ -533,7 +547,11 @@ module tb_tk1 ();
 
       read_check_word(ADDR_NAME0, 32'h746B3120);
       read_check_word(ADDR_NAME1, 32'h6d6b6466);
-      read_check_word(ADDR_VERSION, 32'h00000005);
+`ifdef PCPI
+      read_check_word(ADDR_VERSION, 32'h00000008);
+`else
+      read_check_word(ADDR_VERSION, 32'h00000007);
+`endif
 
       $display("--- test1: completed.");
       $display("");
@@ -1033,11 +1051,17 @@ module tb_tk1 ();
       cpu_read_check_range_should_trap(32'hc4000400, 32'hc400040f);
       cpu_read_check_range_should_trap(32'hc4fffff0, 32'hc4ffffff);
 
-      // Unused      trap range: 0xc5000000-0xcfffffff
-      $display("--- test11: Unused");
-      cpu_read_check_range_should_trap(32'hc5000000, 32'hc500000f);
+      // BLAKE2S     trap range: 0xc5000400-0xc5ffffff
+      $display("--- test11: BLAKE2S");
+      cpu_read_check_range_should_not_trap(32'hc5000000, 32'hc50003ff);
+      cpu_read_check_range_should_trap(32'hc5000400, 32'hc500040f);
       cpu_read_check_range_should_trap(32'hc5fffff0, 32'hc5ffffff);
 
+      // Unused      trap range: 0xc6000000-0xcfffffff
+      $display("--- test11: Unused");
+      cpu_read_check_range_should_trap(32'hc6000000, 32'hc600000f);
+      cpu_read_check_range_should_trap(32'hcffffff0, 32'hcfffffff);
+
       // FW_RAM      trap range: 0xd0000800-0xd0ffffff
       $display("--- test11: FW_RAM");
       cpu_read_check_range_should_not_trap(32'hd0000000, 32'hd0000fff);
@@ -1163,6 +1187,48 @@ module tb_tk1 ();
   endtask  // test13
 
 
+  //----------------------------------------------------------------
+  // test14()
+  // RAM fill control.
+  //----------------------------------------------------------------
+  task test14;
+    begin
+      tc_ctr = tc_ctr + 1;
+
+      $display("");
+      $display("--- test14: RAM fill started from fw mode.");
+      tb_syscall = 0;
+      reset_dut();
+
+      write_word(ADDR_RAM_FILL_ACC, 32'h13371337);
+      check_equal(tb_ram_fill_start, 0);
+      write_word(ADDR_RAM_FILL, 32'h47114711);
+      check_equal(tb_ram_fill_start, 1);
+      check_equal(tb_ram_fill_seed, 32'h47114711);
+      check_equal(tb_ram_fill_acc, 32'h13371337);
+      #(CLK_PERIOD);
+      check_equal(tb_ram_fill_start, 0);
+
+      $display("--- test14: Read RAM fill busy status.");
+      tb_ram_fill_busy = 1;
+      read_check_word(ADDR_RAM_FILL, 32'h1);
+      tb_ram_fill_busy = 0;
+      read_check_word(ADDR_RAM_FILL, 32'h0);
+
+      $display("--- test14: RAM fill not allowed from app mode.");
+      fetch_instruction(APP_RAM_START);
+      write_word(ADDR_RAM_FILL_ACC, 32'hdeadbeef);
+      write_word(ADDR_RAM_FILL, 32'hf00ff00f);
+      check_equal(tb_ram_fill_start, 0);
+      check_equal(tb_ram_fill_seed, 32'h47114711);
+      check_equal(tb_ram_fill_acc, 32'h13371337);
+
+      $display("--- test14: completed.");
+      $display("");
+    end
+  endtask  // test14
+
+
   //----------------------------------------------------------------
   // exit_with_error_code()
   //
@@ -1205,6 +1271,7 @@ module tb_tk1 ();
     test11();
     test12();
     test13();
+    test14();
 
     display_test_result();
     $display("");
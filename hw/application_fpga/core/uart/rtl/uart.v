@@ -65,7 +65,9 @@ module uart (
     input  wire [31 : 0] write_data,
     /* verilator lint_on UNUSED */
     output wire [31 : 0] read_data,
-    output wire          ready
+    output wire          ready,
+
+    output wire          rx_irq
 );
 
 
@@ -75,9 +77,11 @@ module uart (
   localparam ADDR_RX_STATUS = 8'h20;
   localparam ADDR_RX_DATA = 8'h21;
   localparam ADDR_RX_BYTES = 8'h22;
+  localparam ADDR_RX_IRQ = 8'h23;
 
   localparam ADDR_TX_STATUS = 8'h40;
   localparam ADDR_TX_DATA = 8'h41;
+  localparam ADDR_TX_FREE = 8'h42;
 
   // The default bit rate is based on target clock frequency
   // divided by the bit rate times in order to hit the
@@ -93,6 +97,9 @@ module uart (
   //----------------------------------------------------------------
   // Registers including update variables and write enable.
   //----------------------------------------------------------------
+  reg rx_irq_en_reg;
+  reg rx_irq_en_new;
+  reg rx_irq_en_we;
 
   //----------------------------------------------------------------
   // Wires.
@@ -110,6 +117,16 @@ module uart (
   reg           fifo_out_ack;
   wire [ 8 : 0] fifo_bytes;
 
+  reg           tx_fifo_in_syn;
+  /* verilator lint_off UNUSED */
+  wire          tx_fifo_in_ack;
+  wire          tx_fifo_cts;
+  /* verilator lint_on UNUSED */
+  wire          tx_fifo_out_syn;
+  wire [ 7 : 0] tx_fifo_out_data;
+  reg           tx_fifo_out_ack;
+  wire [ 8 : 0] tx_fifo_bytes;
+
   reg  [31 : 0] tmp_read_data;
   reg           tmp_ready;
 
@@ -121,6 +138,9 @@ module uart (
   assign read_data = tmp_read_data;
   assign ready     = tmp_ready;
 
+  // Level interrupt while enabled and there is data in the FIFO.
+  assign rx_irq    = rx_irq_en_reg & fifo_out_syn;
+
 
   //----------------------------------------------------------------
   // Module instantiations.
@@ -167,19 +187,60 @@ module uart (
       .fpga_cts(fpga_cts)
   );
 
+
+  uart_fifo tx_fifo (
+      .clk(clk),
+      .reset_n(reset_n),
+
+      .in_syn (tx_fifo_in_syn),
+      .in_data(write_data[7 : 0]),
+      .in_ack (tx_fifo_in_ack),
+
+      .fifo_bytes(tx_fifo_bytes),
+
+      .out_syn (tx_fifo_out_syn),
+      .out_data(tx_fifo_out_data),
+      .out_ack (tx_fifo_out_ack),
+
+      .fpga_cts(tx_fifo_cts)
+  );
+
   //----------------------------------------------------------------
   // reg_update
   //----------------------------------------------------------------
   always @(posedge clk) begin : reg_update
     if (!reset_n) begin
       ch552_cts_reg <= 2'h0;
+      rx_irq_en_reg <= 1'h0;
     end
     else begin
       ch552_cts_reg[0] <= ch552_cts;
       ch552_cts_reg[1] <= ch552_cts_reg[0];
+
+      if (rx_irq_en_we) begin
+        rx_irq_en_reg <= rx_irq_en_new;
+      end
     end
   end  // reg_update
 
+  //----------------------------------------------------------------
+  // tx_drain
+  //
+  // Feeds the transmitter from the tx FIFO as long as the CH552 is
+  // clear to send.
+  //----------------------------------------------------------------
+  always @* begin : tx_drain
+    core_txd_syn    = 1'h0;
+    tx_fifo_out_ack = 1'h0;
+    core_txd_data   = tx_fifo_out_data;
+
+    if (tx_fifo_out_syn && core_txd_ready && !ch552_cts_reg[1]) begin
+      core_txd_syn    = 1'h1;
+      tx_fifo_out_ack = 1'h1;
+    end
+  end  // tx_drain
+
+
   //----------------------------------------------------------------
   // api
   //
@@ -188,12 +249,12 @@ module uart (
   //----------------------------------------------------------------
   always @* begin : api
     // Default assignments.
-    core_txd_syn  = 1'h0;
-    fifo_out_ack  = 1'h0;
-    tmp_read_data = 32'h0;
-    tmp_ready     = 1'h0;
-
-    core_txd_data = write_data[7 : 0];
+    fifo_out_ack   = 1'h0;
+    tx_fifo_in_syn = 1'h0;
+    rx_irq_en_new  = write_data[0];
+    rx_irq_en_we   = 1'h0;
+    tmp_read_data  = 32'h0;
+    tmp_ready      = 1'h0;
 
     if (cs) begin
       tmp_ready = 1'h1;
@@ -201,9 +262,11 @@ module uart (
       if (we) begin
         case (address)
           ADDR_TX_DATA: begin
-            if (core_txd_ready) begin
-              core_txd_syn = 1'h1;
-            end
+            tx_fifo_in_syn = 1'h1;
+          end
+
+          ADDR_RX_IRQ: begin
+            rx_irq_en_we = 1'h1;
           end
 
           default: begin
@@ -226,8 +289,16 @@ module uart (
             tmp_read_data = {23'h0, fifo_bytes};
           end
 
+          ADDR_RX_IRQ: begin
+            tmp_read_data = {31'h0, rx_irq_en_reg};
+          end
+
           ADDR_TX_STATUS: begin
-            tmp_read_data = {31'h0, core_txd_ready & !ch552_cts_reg[1]};
+            tmp_read_data = {31'h0, tx_fifo_bytes != 9'h1ff};
+          end
+
+          ADDR_TX_FREE: begin
+            tmp_read_data = {23'h0, 9'h1ff - tx_fifo_bytes};
           end
 
           default: begin
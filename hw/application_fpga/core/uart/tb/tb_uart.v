@@ -60,12 +60,15 @@ module tb_uart ();
   reg           tb_reset_n;
   reg           tb_rxd;
   wire          tb_txd;
+  reg           tb_ch552_cts;
+  wire          tb_fpga_cts;
   reg           tb_cs;
   reg           tb_we;
   reg  [ 7 : 0] tb_address;
   reg  [31 : 0] tb_write_data;
   wire [31 : 0] tb_read_data;
   wire          tb_ready;
+  wire          tb_rx_irq;
 
   reg           txd_state;
 
@@ -80,13 +83,18 @@ module tb_uart ();
       .rxd(tb_rxd),
       .txd(tb_txd),
 
+      .ch552_cts(tb_ch552_cts),
+      .fpga_cts (tb_fpga_cts),
+
       // API interface.
       .cs(tb_cs),
       .we(tb_we),
       .address(tb_address),
       .write_data(tb_write_data),
       .read_data(tb_read_data),
-      .ready(tb_ready)
+      .ready(tb_ready),
+
+      .rx_irq(tb_rx_irq)
   );
 
 
@@ -226,6 +234,7 @@ module tb_uart ();
       tb_clk        = 0;
       tb_reset_n    = 1;
       tb_rxd        = 1;
+      tb_ch552_cts  = 0;
       tb_cs         = 0;
       tb_we         = 0;
       tb_address    = 8'h0;
@@ -391,6 +400,161 @@ module tb_uart ();
   endtask
 
 
+  //----------------------------------------------------------------
+  // write_word()
+  //
+  // Write the given word to the DUT using the API.
+  //----------------------------------------------------------------
+  task write_word(input [7 : 0] address, input [31 : 0] word);
+    begin
+      tb_address    = address;
+      tb_write_data = word;
+      tb_cs         = 1;
+      tb_we         = 1;
+      #(CLK_PERIOD);
+      tb_cs         = 0;
+      tb_we         = 0;
+    end
+  endtask  // write_word
+
+
+  //----------------------------------------------------------------
+  // read_word()
+  //
+  // Read a data word from the given address in the DUT.
+  //----------------------------------------------------------------
+  task read_word(input [7 : 0] address, output [31 : 0] word);
+    begin
+      tb_address = address;
+      tb_cs      = 1;
+      tb_we      = 0;
+      #(CLK_PERIOD / 2);
+      word = tb_read_data;
+      #(CLK_PERIOD / 2);
+      tb_cs = 0;
+    end
+  endtask  // read_word
+
+
+  //----------------------------------------------------------------
+  // test_rx_irq
+  //
+  // The rx_irq must only be set when enabled and there is data in
+  // the FIFO. The bytes from test_transmit are still there.
+  //----------------------------------------------------------------
+  task test_rx_irq;
+    reg [31 : 0] word;
+    begin
+      tc_ctr = tc_ctr + 1;
+
+      $display("*** Testing rx_irq.");
+
+      if (tb_rx_irq) begin
+        $display("*** rx_irq set while disabled.");
+        error_ctr = error_ctr + 1;
+      end
+
+      write_word(dut.ADDR_RX_IRQ, 32'h1);
+      #(CLK_PERIOD);
+
+      if (!tb_rx_irq) begin
+        $display("*** rx_irq not set with data in FIFO.");
+        error_ctr = error_ctr + 1;
+      end
+
+      // Drain the FIFO
+      read_word(dut.ADDR_RX_BYTES, word);
+      while (word != 0) begin
+        read_word(dut.ADDR_RX_DATA, word);
+        read_word(dut.ADDR_RX_BYTES, word);
+      end
+      #(CLK_PERIOD);
+
+      if (tb_rx_irq) begin
+        $display("*** rx_irq set with empty FIFO.");
+        error_ctr = error_ctr + 1;
+      end
+
+      transmit_byte(8'ha5, 0);
+      #(CLK_PERIOD);
+
+      if (!tb_rx_irq) begin
+        $display("*** rx_irq not set after receiving a byte.");
+        error_ctr = error_ctr + 1;
+      end
+
+      write_word(dut.ADDR_RX_IRQ, 32'h0);
+      #(CLK_PERIOD);
+
+      if (tb_rx_irq) begin
+        $display("*** rx_irq set after being disabled.");
+        error_ctr = error_ctr + 1;
+      end
+    end
+  endtask  // test_rx_irq
+
+
+  //----------------------------------------------------------------
+  // test_tx_free
+  //
+  // ADDR_TX_FREE must count down as bytes are written to the tx
+  // FIFO and back up as they are sent. Nothing may be sent while
+  // the CH552 is not clear to send.
+  //----------------------------------------------------------------
+  task test_tx_free;
+    reg [31 : 0] word;
+    begin
+      tc_ctr = tc_ctr + 1;
+
+      $display("*** Testing tx free count.");
+
+      read_word(dut.ADDR_TX_FREE, word);
+      if (word != 32'd511) begin
+        $display("*** Empty tx FIFO has %0d free, expected 511.", word);
+        error_ctr = error_ctr + 1;
+      end
+
+      // Active low, not clear to send.
+      tb_ch552_cts = 1;
+      #(4 * CLK_PERIOD);
+
+      write_word(dut.ADDR_TX_DATA, 32'h55);
+      #(CLK_PERIOD);
+      write_word(dut.ADDR_TX_DATA, 32'haa);
+      #(CLK_PERIOD);
+      write_word(dut.ADDR_TX_DATA, 32'h0f);
+      #(CLK_PERIOD);
+
+      read_word(dut.ADDR_TX_FREE, word);
+      if (word != 32'd508) begin
+        $display("*** tx FIFO has %0d free, expected 508.", word);
+        error_ctr = error_ctr + 1;
+      end
+
+      read_word(dut.ADDR_TX_STATUS, word);
+      if (word != 32'h1) begin
+        $display("*** tx status not ready with room in the FIFO.");
+        error_ctr = error_ctr + 1;
+      end
+
+      if (!tb_txd) begin
+        $display("*** txd active while not clear to send.");
+        error_ctr = error_ctr + 1;
+      end
+
+      tb_ch552_cts = 0;
+      #(2000 * CLK_PERIOD);
+
+      read_word(dut.ADDR_TX_FREE, word);
+      if (word != 32'd511) begin
+        $display("*** tx FIFO has %0d free after sending, expected 511.",
+                 word);
+        error_ctr = error_ctr + 1;
+      end
+    end
+  endtask  // test_tx_free
+
+
   //----------------------------------------------------------------
   // display_test_result()
   //
@@ -441,6 +605,10 @@ module tb_uart ();
 
     send_framing_error();
 
+    test_rx_irq();
+
+    test_tx_free();
+
     display_test_result();
     $display("*** Simulation done.");
     exit_with_error_code();
@@ -26,11 +26,19 @@ volatile uint32_t *timer_status     = (volatile uint32_t *)TK1_MMIO_TIMER_STATUS
 volatile uint32_t *timer_ctrl       = (volatile uint32_t *)TK1_MMIO_TIMER_CTRL;
 volatile uint32_t *trng_status      = (volatile uint32_t *)TK1_MMIO_TRNG_STATUS;
 volatile uint32_t *trng_entropy     = (volatile uint32_t *)TK1_MMIO_TRNG_ENTROPY;
+volatile uint32_t *blake2s_ctrl     = (volatile uint32_t *)TK1_MMIO_BLAKE2S_CTRL;
+volatile uint32_t *blake2s_status   = (volatile uint32_t *)TK1_MMIO_BLAKE2S_STATUS;
+volatile uint32_t *blake2s_t0       = (volatile uint32_t *)TK1_MMIO_BLAKE2S_T0;
+volatile uint32_t *blake2s_t1       = (volatile uint32_t *)TK1_MMIO_BLAKE2S_T1;
+volatile uint32_t *blake2s_h        = (volatile uint32_t *)TK1_MMIO_BLAKE2S_H_FIRST;
+volatile uint32_t *blake2s_block    = (volatile uint32_t *)TK1_MMIO_BLAKE2S_BLOCK_FIRST;
 // clang-format on
 
 #define UDS_WORDS 8
 #define UDI_WORDS 2
 #define CDI_WORDS 8
+#define BLAKE2S_H_WORDS 8
+#define BLAKE2S_BLOCK_WORDS 16
 
 void puthexn(uint8_t *p, int n)
 {
@@ -92,6 +100,45 @@ int check_fwram_zero_except(unsigned int offset, uint8_t expected_val)
 	return failed;
 }
 
+// Hash "abc" (RFC 7693, appendix B) with the BLAKE2s core. Returns
+// non-zero if the digest is wrong.
+int check_blake2s_abc(void)
+{
+	// clang-format off
+	const uint32_t h_init[BLAKE2S_H_WORDS] = {
+		0x6b08e647, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+		0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+	};
+	const uint32_t expected[BLAKE2S_H_WORDS] = {
+		0x8c5e8c50, 0xe2147c32, 0xa32ba7e1, 0x2f45eb4e,
+		0x208b4537, 0x293ad69e, 0x4c9b994d, 0x82596786,
+	};
+	// clang-format on
+	uint32_t digest[BLAKE2S_H_WORDS];
+
+	for (int i = 0; i < BLAKE2S_H_WORDS; i++) {
+		blake2s_h[i] = h_init[i];
+	}
+
+	*blake2s_t0 = 3;
+	*blake2s_t1 = 0;
+
+	blake2s_block[0] = 0x00636261;
+	for (int i = 1; i < BLAKE2S_BLOCK_WORDS; i++) {
+		blake2s_block[i] = 0;
+	}
+
+	*blake2s_ctrl = (1 << TK1_MMIO_BLAKE2S_CTRL_LAST_BIT);
+	while ((*blake2s_status & (1 << TK1_MMIO_BLAKE2S_STATUS_READY_BIT)) ==
+	       0) {
+	}
+
+	wordcpy_s(digest, BLAKE2S_H_WORDS, (void *)blake2s_h, BLAKE2S_H_WORDS);
+	*blake2s_ctrl = (1 << TK1_MMIO_BLAKE2S_CTRL_CLEAR_BIT);
+
+	return !memeq(digest, expected, BLAKE2S_H_WORDS * 4);
+}
+
 void failmsg(char *s)
 {
 	puts(IO_CDC, "FAIL: ");
@@ -249,6 +296,12 @@ int main(void)
 		anyfailed = 1;
 	}
 
+	puts(IO_CDC, "\r\nTesting BLAKE2s core...\r\n");
+	if (check_blake2s_abc()) {
+		failmsg("BLAKE2s core digest of abc");
+		anyfailed = 1;
+	}
+
 	// Check and display test results.
 	puts(IO_CDC, "\r\n--> ");
 	if (anyfailed) {
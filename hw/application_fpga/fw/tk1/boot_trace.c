@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <stddef.h>
+#include <stdint.h>
+#include <tkey/lib.h>
+#include <tkey/tk1_mem.h>
+
+#include "boot_trace.h"
+
+#if defined(BOOT_TRACE)
+
+// clang-format off
+static volatile uint32_t *timer            = (volatile uint32_t *)TK1_MMIO_TIMER_TIMER;
+static volatile uint32_t *timer_prescaler  = (volatile uint32_t *)TK1_MMIO_TIMER_PRESCALER;
+static volatile uint32_t *timer_ctrl       = (volatile uint32_t *)TK1_MMIO_TIMER_CTRL;
+// clang-format on
+
+struct boot_trace boot_trace;
+
+// The timer counts down, so start it from the top and let it run
+// freely during boot.
+void boot_trace_start(void)
+{
+	*timer_prescaler = 1;
+	*timer = 0xffffffff;
+	*timer_ctrl = (1 << TK1_MMIO_TIMER_CTRL_START_BIT);
+}
+
+uint32_t boot_trace_now(void)
+{
+	return 0xffffffff - *timer;
+}
+
+// Record the first time we enter state.
+void boot_trace_state(enum state state)
+{
+	if (state < FW_STATE_MAX && boot_trace.state[state] == 0) {
+		boot_trace.state[state] = boot_trace_now();
+	}
+}
+
+// Sleep without stopping the timer used for the trace.
+void boot_trace_sleep(uint32_t cycles)
+{
+	uint32_t start = boot_trace_now();
+
+	while (boot_trace_now() - start < cycles) {
+	}
+}
+
+// Leave the timer stopped for the app, like without the trace.
+void boot_trace_stop(void)
+{
+	*timer_ctrl = (1 << TK1_MMIO_TIMER_CTRL_STOP_BIT);
+}
+
+#endif
+
+// Copy the boot trace to buf. Returns -1 if buf is too small or if
+// firmware was built without BOOT_TRACE.
+int boot_trace_get(uint8_t *buf, size_t bufsize)
+{
+#if defined(BOOT_TRACE)
+	if (bufsize < sizeof(boot_trace)) {
+		return -1;
+	}
+
+	memcpy_s(buf, bufsize, &boot_trace, sizeof(boot_trace));
+
+	return 0;
+#else
+	(void)buf;
+	(void)bufsize;
+
+	return -1;
+#endif
+}
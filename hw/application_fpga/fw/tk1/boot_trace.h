@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef BOOT_TRACE_H
+#define BOOT_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "state.h"
+
+// Boot trace, only collected when built with -DBOOT_TRACE.
+//
+// All timestamps are cycles since the timer was started at the
+// beginning of main(). Zero means the point was never reached.
+//
+// Needs to be held synchronized with struct boot_trace in tkey-libs.
+struct boot_trace {
+	uint32_t state[FW_STATE_MAX]; // First entry into each enum state
+	uint32_t scrambled;	      // scramble_ram() done
+	uint32_t part_table_read;     // part_table_read() done
+	uint32_t cdi_done;	      // compute_cdi() done
+	uint32_t jump;		      // Right before jump_to_app()
+};
+
+#if defined(BOOT_TRACE)
+
+extern struct boot_trace boot_trace;
+
+void boot_trace_start(void);
+uint32_t boot_trace_now(void);
+void boot_trace_sleep(uint32_t cycles);
+void boot_trace_stop(void);
+void boot_trace_state(enum state state);
+#define boot_trace_point(field) (boot_trace.field = boot_trace_now())
+
+#else
+
+#define boot_trace_start()
+#define boot_trace_state(state)
+#define boot_trace_point(field)
+#define boot_trace_stop()
+
+#endif
+
+int boot_trace_get(uint8_t *buf, size_t bufsize);
+
+#endif
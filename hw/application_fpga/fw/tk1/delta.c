@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "delta.h"
+#include "partition_table.h"
+#include "preload_app.h"
+
+enum delta_state {
+	DELTA_OP,
+	DELTA_HEADER,
+	DELTA_DATA,
+};
+
+void delta_init(struct delta_ctx *d, struct partition_table *part_table,
+		uint8_t *dst, uint32_t size)
+{
+	d->part_table = part_table;
+	d->state = DELTA_OP;
+	d->op = 0;
+	d->hdrlen = 0;
+	d->len = 0;
+	d->offset = 0;
+	d->out = dst;
+	d->end = dst + size;
+}
+
+// Copy d->len bytes at d->offset in the base app from flash.
+static int copy_from_base(struct delta_ctx *d)
+{
+	if (d->len > (uint32_t)(d->end - d->out)) {
+		return -1;
+	}
+
+	if (preload_read(d->part_table, DELTA_BASE_SLOT, d->offset, d->out,
+			 d->len) != 0) {
+		return -1;
+	}
+
+	d->out += d->len;
+	d->state = DELTA_OP;
+
+	return 0;
+}
+
+// Apply srclen bytes of delta from src. Returns 0 on success or -1 on
+// a malformed delta. The app is complete when d->out reaches d->end
+// and any input after that is ignored, so the client can pad the last
+// frame.
+int delta_apply(struct delta_ctx *d, const uint8_t *src, size_t srclen)
+{
+	for (size_t i = 0; i < srclen && d->out < d->end; i++) {
+		uint8_t b = src[i];
+
+		switch (d->state) {
+		case DELTA_OP:
+			if (b != DELTA_LITERAL && b != DELTA_COPY) {
+				return -1;
+			}
+			d->op = b;
+			d->hdrlen = 0;
+			d->len = 0;
+			d->offset = 0;
+			d->state = DELTA_HEADER;
+			break;
+
+		case DELTA_HEADER:
+			if (d->hdrlen < 3) {
+				d->len |= (uint32_t)b << (8 * d->hdrlen);
+			} else {
+				d->offset |= (uint32_t)b << (8 * (d->hdrlen - 3));
+			}
+			d->hdrlen++;
+
+			if (d->op == DELTA_LITERAL && d->hdrlen == 3) {
+				if (d->len == 0 ||
+				    d->len > (uint32_t)(d->end - d->out)) {
+					return -1;
+				}
+				d->state = DELTA_DATA;
+			} else if (d->op == DELTA_COPY && d->hdrlen == 6) {
+				if (copy_from_base(d) != 0) {
+					return -1;
+				}
+			}
+			break;
+
+		case DELTA_DATA:
+			*d->out++ = b;
+			if (--d->len == 0) {
+				d->state = DELTA_OP;
+			}
+			break;
+
+		default:
+			return -1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef DELTA_H
+#define DELTA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "partition_table.h"
+
+// The app in this flash slot is the base for deltas.
+#define DELTA_BASE_SLOT 1
+
+// Delta operations. Each starts with the operation byte and a 3 byte
+// little-endian length.
+enum delta_op {
+	DELTA_LITERAL = 0x00, // length bytes of data follow
+	DELTA_COPY = 0x01,    // 3 byte little-endian offset in base follows
+};
+
+// Streaming decoder rebuilding an app from a delta against the app in
+// flash slot DELTA_BASE_SLOT. Input may be split anywhere.
+struct delta_ctx {
+	struct partition_table *part_table;
+	uint8_t state;
+	uint8_t op;
+	// Header bytes received after the operation byte
+	uint8_t hdrlen;
+	// Length of the current operation
+	uint32_t len;
+	uint32_t offset;
+	// Next byte to write
+	uint8_t *out;
+	// End of destination
+	uint8_t *end;
+};
+
+void delta_init(struct delta_ctx *d, struct partition_table *part_table,
+		uint8_t *dst, uint32_t size);
+int delta_apply(struct delta_ctx *d, const uint8_t *src, size_t srclen);
+
+#endif
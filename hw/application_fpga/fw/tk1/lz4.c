@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lz4.h"
+
+enum lz4_state {
+	LZ4_TOKEN,
+	LZ4_LITLEN,
+	LZ4_LITERALS,
+	LZ4_OFFSET0,
+	LZ4_OFFSET1,
+	LZ4_MATCHLEN,
+};
+
+void lz4_init(struct lz4_ctx *z, uint8_t *dst, uint32_t size)
+{
+	z->state = LZ4_TOKEN;
+	z->token = 0;
+	z->len = 0;
+	z->offset = 0;
+	z->start = dst;
+	z->out = dst;
+	z->end = dst + size;
+}
+
+static int copy_match(struct lz4_ctx *z)
+{
+	uint8_t *from = NULL;
+
+	if (z->offset == 0 || z->offset > (uint32_t)(z->out - z->start) ||
+	    z->len > (uint32_t)(z->end - z->out)) {
+		return -1;
+	}
+
+	// Byte by byte since source and destination may overlap.
+	from = z->out - z->offset;
+	while (z->len > 0) {
+		*z->out++ = *from++;
+		z->len--;
+	}
+
+	z->state = LZ4_TOKEN;
+
+	return 0;
+}
+
+// Decompress srclen bytes from src. Returns 0 on success or -1 on a
+// malformed stream. Decompression is done when z->out reaches z->end
+// and any input after that is ignored, so the client can pad the last
+// frame.
+int lz4_decompress(struct lz4_ctx *z, const uint8_t *src, size_t srclen)
+{
+	for (size_t i = 0; i < srclen && z->out < z->end; i++) {
+		uint8_t b = src[i];
+
+		switch (z->state) {
+		case LZ4_TOKEN:
+			z->token = b;
+			z->len = b >> 4;
+			if (z->len == 15) {
+				z->state = LZ4_LITLEN;
+			} else if (z->len > 0) {
+				z->state = LZ4_LITERALS;
+			} else {
+				z->state = LZ4_OFFSET0;
+			}
+			break;
+
+		case LZ4_LITLEN:
+			z->len += b;
+			if (b != 255) {
+				z->state = LZ4_LITERALS;
+			}
+			break;
+
+		case LZ4_LITERALS:
+			*z->out++ = b;
+			if (--z->len == 0) {
+				z->state = LZ4_OFFSET0;
+			}
+			break;
+
+		case LZ4_OFFSET0:
+			z->offset = b;
+			z->state = LZ4_OFFSET1;
+			break;
+
+		case LZ4_OFFSET1:
+			z->offset |= (uint32_t)b << 8;
+			z->len = (z->token & 0x0f) + 4;
+			if ((z->token & 0x0f) == 15) {
+				z->state = LZ4_MATCHLEN;
+			} else if (copy_match(z) != 0) {
+				return -1;
+			}
+			break;
+
+		case LZ4_MATCHLEN:
+			z->len += b;
+			if (b != 255 && copy_match(z) != 0) {
+				return -1;
+			}
+			break;
+
+		default:
+			return -1;
+		}
+	}
+
+	return 0;
+}
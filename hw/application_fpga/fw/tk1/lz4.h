@@ -0,0 +1,27 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef LZ4_H
+#define LZ4_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Streaming decompressor for the LZ4 block format. Input may be split
+// anywhere, so it can be fed one frame at a time. Matches are copied
+// from what has already been written to the destination, so the only
+// state is this struct.
+struct lz4_ctx {
+	uint8_t state;
+	uint8_t token;
+	uint32_t len;	 // Literal or match length left
+	uint32_t offset; // Match offset
+	uint8_t *start;	 // Start of destination
+	uint8_t *out;	 // Next byte to write
+	uint8_t *end;	 // End of destination
+};
+
+void lz4_init(struct lz4_ctx *z, uint8_t *dst, uint32_t size);
+int lz4_decompress(struct lz4_ctx *z, const uint8_t *src, size_t srclen);
+
+#endif
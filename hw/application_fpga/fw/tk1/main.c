@@ -11,6 +11,12 @@
 #include <tkey/lib.h>
 #include <tkey/tk1_mem.h>
 
+#include "boot_trace.h"
+#if defined(APP_DELTA)
+#include "delta.h"
+#else
+#include "lz4.h"
+#endif
 #include "mgmt_app.h"
 #include "partition_table.h"
 #include "preload_app.h"
@@ -39,10 +45,12 @@ static volatile uint32_t *timer_status     = (volatile uint32_t *)TK1_MMIO_TIMER
 static volatile uint32_t *timer_ctrl       = (volatile uint32_t *)TK1_MMIO_TIMER_CTRL;
 static volatile uint32_t *ram_addr_rand    = (volatile uint32_t *)TK1_MMIO_TK1_RAM_ADDR_RAND;
 static volatile uint32_t *ram_data_rand    = (volatile uint32_t *)TK1_MMIO_TK1_RAM_DATA_RAND;
+static volatile uint32_t *ram_fill_acc     = (volatile uint32_t *)TK1_MMIO_TK1_RAM_FILL_ACC;
+static volatile uint32_t *ram_fill         = (volatile uint32_t *)TK1_MMIO_TK1_RAM_FILL;
 static volatile struct reset *resetinfo    = (volatile struct reset *)TK1_MMIO_RESETINFO_BASE;
 // clang-format on
 
-struct partition_table_storage part_table_storage;
+struct partition_table_storage part_table_storage FW_RAM_WARMBOOT;
 
 // Context for the loading of a TKey program
 struct context {
@@ -54,6 +62,20 @@ struct context {
 	uint8_t flash_slot; // App is loaded from flash slot number
 	/*@null@*/ volatile uint8_t
 	    *ver_digest; // Verify loaded app against this digest
+	// Running digest of the app being loaded from the client
+	blake2s_ctx digest_ctx;
+	uint16_t seq; // Number of LOAD_APP_DATA_WIN frames received
+#if defined(APP_DELTA)
+	// App data is a delta against the app in flash slot
+	// DELTA_BASE_SLOT
+	bool delta;
+	struct delta_ctx dctx;
+#else
+	// App data is LZ4 compressed and decompressed by lz4 while
+	// loading
+	bool compressed;
+	struct lz4_ctx lz4;
+#endif
 };
 
 static void print_hw_version(void);
@@ -68,11 +90,7 @@ static enum state initial_commands(const struct frame_header *hdr,
 static enum state loading_commands(const struct frame_header *hdr,
 				   const uint8_t *cmd, enum state state,
 				   struct context *ctx);
-#if !defined(SIMULATION)
-static uint32_t xorwow(uint32_t state, uint32_t acc);
-#endif
 static void scramble_ram(void);
-static int compute_app_digest(uint8_t *digest);
 static int load_flash_app(struct partition_table *part_table,
 			  uint8_t digest[32], uint8_t slot);
 static enum state start_where(struct context *ctx);
@@ -120,14 +138,19 @@ static void compute_cdi(uint8_t domain, const uint8_t *digest,
 	int blake2err = 0;
 
 	// Prepare to sleep a random number of cycles before reading out UDS
-	*timer_prescaler = 1;
 	rnd_sleep = rnd_word();
 	// Up to 65536 cycles
 	rnd_sleep &= 0xffff;
+#if defined(BOOT_TRACE)
+	// The timer is busy keeping time for the boot trace
+	boot_trace_sleep(rnd_sleep == 0 ? 1 : rnd_sleep);
+#else
+	*timer_prescaler = 1;
 	*timer = (uint32_t)(rnd_sleep == 0 ? 1 : rnd_sleep);
 	*timer_ctrl = (1 << TK1_MMIO_TIMER_CTRL_START_BIT);
 	while (*timer_status & (1 << TK1_MMIO_TIMER_STATUS_RUNNING_BIT)) {
 	}
+#endif
 
 	// Initialize the BLAKE2s hash function with the UDS as key.
 	// This means UDS will live for a short while on the firmware
@@ -211,8 +234,29 @@ static enum state initial_commands(const struct frame_header *hdr,
 		break;
 	}
 
+	case FW_CMD_GET_BOOT_TRACE:
+		debug_puts("cmd: get-boot-trace\n");
+		if (hdr->len != 1) {
+			// Bad length
+			state = FW_STATE_FAIL;
+			break;
+		}
+
+		// Only has status and trace up to now when built
+		// with BOOT_TRACE, otherwise just a bad status.
+		if (boot_trace_get(&rsp[1], CMDSIZE - 1) == 0) {
+			rsp[0] = STATUS_OK;
+		} else {
+			rsp[0] = STATUS_BAD;
+		}
+		fwreply(*hdr, FW_RSP_GET_BOOT_TRACE, rsp);
+		// still initial state
+		break;
+
 	case FW_CMD_LOAD_APP: {
 		uint32_t local_app_size;
+		int blake2err = 0;
+		bool refuse = false;
 
 		debug_puts("cmd: load-app(size, uss)\n");
 		if (hdr->len != 128) {
@@ -247,6 +291,30 @@ static enum state initial_commands(const struct frame_header *hdr,
 			ctx->use_uss = false;
 		}
 
+		// cmd[38] contains load flags. The size is still the
+		// size of the app in RAM. Only one of compressed and
+		// differential loading fits in ROM, so the other one
+		// is refused.
+#if defined(APP_DELTA)
+		ctx->delta = (cmd[38] & LOAD_APP_FLAG_DELTA) != 0;
+
+		// A delta needs a base app.
+		refuse = (cmd[38] & LOAD_APP_FLAG_COMPRESSED) != 0 ||
+			 (ctx->delta &&
+			  part_table_storage.table.pre_app_data[DELTA_BASE_SLOT]
+				  .size == 0);
+#else
+		ctx->compressed = (cmd[38] & LOAD_APP_FLAG_COMPRESSED) != 0;
+		refuse = (cmd[38] & LOAD_APP_FLAG_DELTA) != 0;
+#endif
+
+		if (refuse) {
+			rsp[0] = STATUS_BAD;
+			fwreply(*hdr, FW_RSP_LOAD_APP, rsp);
+			// still initial state
+			break;
+		}
+
 		rsp[0] = STATUS_OK;
 		fwreply(*hdr, FW_RSP_LOAD_APP, rsp);
 
@@ -255,6 +323,22 @@ static enum state initial_commands(const struct frame_header *hdr,
 
 		ctx->left = *app_size;
 
+		// Measure the app incrementally as the chunks come in
+		// instead of hashing all of it after the last one.
+		blake2err = blake2s_init(&ctx->digest_ctx, 32, NULL, 0);
+		assert(blake2err == 0);
+
+#if defined(APP_DELTA)
+		if (ctx->delta) {
+			delta_init(&ctx->dctx, &part_table_storage.table,
+				   ctx->loadaddr, *app_size);
+		}
+#else
+		if (ctx->compressed) {
+			lz4_init(&ctx->lz4, ctx->loadaddr, *app_size);
+		}
+#endif
+
 		led_set(LED_BLACK);
 
 		state = FW_STATE_LOADING;
@@ -281,35 +365,77 @@ static enum state loading_commands(const struct frame_header *hdr,
 
 	switch (cmd[0]) {
 	case FW_CMD_LOAD_APP_DATA:
-		debug_puts("cmd: load-app-data\n");
+		// fallthrough
+	case FW_CMD_LOAD_APP_DATA_WIN:
+		trace_puts("cmd: load-app-data\n");
 		if (hdr->len != 128) {
 			// Bad length
 			state = FW_STATE_FAIL;
 			break;
 		}
 
-		if (ctx->left > (128 - 1)) {
-			nbytes = 128 - 1;
+		if (cmd[0] == FW_CMD_LOAD_APP_DATA_WIN) {
+			// The frame ID is a sequence counter when
+			// streaming. Anything out of order means we
+			// lost data.
+			if (hdr->id != (ctx->seq % LOAD_WINDOW)) {
+				debug_puts("Frame out of sequence\n");
+				rsp[0] = STATUS_BAD;
+				fwreply(*hdr, FW_RSP_LOAD_APP_DATA_WIN, rsp);
+				state = FW_STATE_FAIL;
+				break;
+			}
+
+			ctx->seq++;
+		}
+
+#if defined(APP_DELTA)
+		if (ctx->delta) {
+			// Rebuild the app from the base app in flash
+			// and the literals in the delta.
+			if (delta_apply(&ctx->dctx, cmd + 1, 128 - 1) != 0) {
+				debug_puts("Bad delta\n");
+				state = FW_STATE_FAIL;
+				break;
+			}
+			nbytes = (uint32_t)(ctx->dctx.out - ctx->loadaddr);
+		} else {
+#else
+		if (ctx->compressed) {
+			// Decompress straight into app RAM. nbytes is
+			// what the frame expanded to.
+			if (lz4_decompress(&ctx->lz4, cmd + 1, 128 - 1) != 0) {
+				debug_puts("Bad compressed data\n");
+				state = FW_STATE_FAIL;
+				break;
+			}
+			nbytes = (uint32_t)(ctx->lz4.out - ctx->loadaddr);
 		} else {
-			nbytes = ctx->left;
+#endif
+			if (ctx->left > (128 - 1)) {
+				nbytes = 128 - 1;
+			} else {
+				nbytes = ctx->left;
+			}
+			memcpy_s(ctx->loadaddr, ctx->left, cmd + 1, nbytes);
 		}
-		memcpy_s(ctx->loadaddr, ctx->left, cmd + 1, nbytes);
+
+		// Hash what actually ended up in app RAM.
+		blake2s_update(&ctx->digest_ctx, ctx->loadaddr, nbytes);
+
 		/*@-mustfreeonly@*/
 		ctx->loadaddr += nbytes;
 		/*@+mustfreeonly@*/
 		ctx->left -= nbytes;
 
 		if (ctx->left == 0) {
-			int blake2err = 0;
-
 			debug_puts("Fully loaded ");
 			debug_putinthex(*app_size);
 			debug_lf();
 
-			// Compute Blake2S digest of the app,
+			// Finalize the Blake2S digest of the app,
 			// storing it for FW_STATE_RUN
-			blake2err = compute_app_digest(ctx->digest);
-			assert(blake2err == 0);
+			blake2s_final(&ctx->digest_ctx, ctx->digest);
 			print_digest(ctx->digest);
 
 			// And return the digest in final
@@ -322,6 +448,20 @@ static enum state loading_commands(const struct frame_header *hdr,
 			break;
 		}
 
+		if (cmd[0] == FW_CMD_LOAD_APP_DATA_WIN) {
+			// Only acknowledge the last frame in each
+			// window, with the total number of frames
+			// received so far.
+			if (hdr->id == LOAD_WINDOW - 1) {
+				rsp[0] = STATUS_OK;
+				rsp[1] = ctx->seq;
+				rsp[2] = ctx->seq >> 8;
+				fwreply(*hdr, FW_RSP_LOAD_APP_DATA_WIN, rsp);
+			}
+			// still loading state
+			break;
+		}
+
 		rsp[0] = STATUS_OK;
 		fwreply(*hdr, FW_RSP_LOAD_APP_DATA, rsp);
 		// still loading state
@@ -347,6 +487,7 @@ static void jump_to_app(void)
 	debug_puts("Jumping to ");
 	debug_putinthex(*app_addr);
 	debug_lf();
+	debug_flush();
 
 	// Clear the firmware stack
 	// clang-format off
@@ -388,7 +529,8 @@ static int load_flash_app(struct partition_table *part_table,
 		return -1;
 	}
 
-	if (preload_load(part_table, slot) == -1) {
+	// Loads and measures the app
+	if (preload_load(part_table, slot, digest) == -1) {
 		return -1;
 	}
 
@@ -397,40 +539,23 @@ static int load_flash_app(struct partition_table *part_table,
 		return -1;
 	}
 
-	int digest_err = compute_app_digest(digest);
-	assert(digest_err == 0);
 	print_digest(digest);
 
 	return 0;
 }
 
-#if !defined(SIMULATION)
-static uint32_t xorwow(uint32_t state, uint32_t acc)
-{
-	state ^= state << 13;
-	state ^= state >> 17;
-	state ^= state << 5;
-	state += acc;
-	return state;
-}
-#endif
-
 static void scramble_ram(void)
 {
 	// Can't fill RAM if we are simulating, data has already been loaded
 	// into RAM.
 #if !defined(SIMULATION)
-	uint32_t *ram = (uint32_t *)(TK1_RAM_BASE);
-
-	// Fill RAM with random data
-	// Get random state and accumulator seeds.
-	uint32_t data_state = rnd_word();
-	uint32_t data_acc = rnd_word();
-
-	for (uint32_t w = 0; w < TK1_RAM_SIZE / 4; w++) {
-		data_state = xorwow(data_state, data_acc);
-		ram[w] = data_state;
-	}
+	// Fill RAM with random data. The RAM core runs an xorwow
+	// generator from random accumulator and state seeds over
+	// every word, starting when the state seed is written. It
+	// holds any access to RAM until it's done, so we can continue
+	// booting while it runs, as long as we don't touch app RAM.
+	*ram_fill_acc = rnd_word();
+	*ram_fill = rnd_word();
 #endif
 
 	// Set RAM address and data scrambling parameters
@@ -438,13 +563,9 @@ static void scramble_ram(void)
 	*ram_data_rand = rnd_word();
 }
 
-/* Computes the blake2s digest of the app loaded into RAM */
-static int compute_app_digest(uint8_t *digest)
-{
-	return blake2s(digest, 32, NULL, 0, (const void *)TK1_RAM_BASE,
-		       *app_size);
-}
-
+// Decides where to start the next app from, flash or client, and
+// which digest it has to match, if any, from the reset type left by
+// the previous app.
 static enum state start_where(struct context *ctx)
 {
 	assert(ctx != NULL);
@@ -517,6 +638,8 @@ int main(void)
 	uint8_t cmd[CMDSIZE] = {0};
 	enum state state = FW_STATE_INITIAL;
 
+	boot_trace_start();
+
 	print_hw_version();
 
 	/*@-mustfreeonly@*/
@@ -528,12 +651,14 @@ int main(void)
 	ctx.use_uss = false;
 
 	scramble_ram();
+	boot_trace_point(scrambled);
 
 	if (part_table_read(&part_table_storage) != 0) {
 		// Couldn't read partition table
 		debug_puts("Couldn't read partition table\n");
 		assert(1 == 2);
 	}
+	boot_trace_point(part_table_read);
 
 	// Reset the USB controller to only enable the USB CDC
 	// endpoint and the internal command channel.
@@ -546,6 +671,8 @@ int main(void)
 #endif
 
 	for (;;) {
+		boot_trace_state(state);
+
 		switch (state) {
 		case FW_STATE_INITIAL:
 			state = start_where(&ctx);
@@ -557,8 +684,8 @@ int main(void)
 				break;
 			}
 
-			debug_puts("cmd: \n");
-			debug_hexdump(cmd, hdr.len);
+			trace_puts("cmd: \n");
+			trace_hexdump(cmd, hdr.len);
 
 			state = initial_commands(&hdr, cmd, state, &ctx);
 			break;
@@ -618,6 +745,7 @@ int main(void)
 				compute_cdi(domain, ctx.digest, ctx.use_uss,
 					    ctx.uss);
 			}
+			boot_trace_point(cdi_done);
 
 			// Reset resetinfo to default. Leave
 			// next_app_data intact, if any. We also leave
@@ -641,6 +769,9 @@ int main(void)
 			(void)memset((void *)resetinfo->app_digest, 0,
 				     RESET_DIGEST_SIZE);
 
+			boot_trace_point(jump);
+			boot_trace_stop();
+
 			jump_to_app();
 			break; // Not reached
 		}
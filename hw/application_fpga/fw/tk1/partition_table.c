@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: 2024 Tillitis AB <tillitis.se>
 // SPDX-License-Identifier: BSD-2-Clause
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <tkey/assert.h>
 #include <tkey/lib.h>
@@ -10,7 +11,13 @@
 #include "partition_table.h"
 #include "proto.h"
 
-static enum part_status part_status;
+// Set when the partition table storage passed to part_table_read()
+// matches flash. Kept over a system reset together with the storage
+// itself and the status.
+#define PART_TABLE_KEPT 0x6b707421
+
+static uint32_t part_table_kept FW_RAM_WARMBOOT;
+static enum part_status part_status FW_RAM_WARMBOOT;
 
 enum part_status part_get_status(void)
 {
@@ -36,10 +43,28 @@ static void part_checksum(struct partition_table *part_table,
 	assert(blake2err == 0);
 }
 
+// part_table_kept_ok checks if storage still holds the partition
+// table read or written before a system reset. The checksum is
+// verified just like when reading from flash.
+static bool part_table_kept_ok(struct partition_table_storage *storage)
+{
+	uint8_t check_digest[PART_CHECKSUM_SIZE] = {0};
+
+	if (part_table_kept != PART_TABLE_KEPT) {
+		return false;
+	}
+
+	part_checksum(&storage->table, check_digest, sizeof(check_digest));
+
+	return memeq(check_digest, storage->checksum, sizeof(check_digest));
+}
+
 // part_table_read reads and verifies the partition table storage,
 // first trying slot 0, then slot 1 if slot 0 does not verify.
 //
-// It stores the partition table in storage.
+// It stores the partition table in storage, which must be placed with
+// FW_RAM_WARMBOOT. After a system reset the table is still there and
+// isn't read from flash again if it verifies.
 //
 // Returns negative values on errors.
 int part_table_read(struct partition_table_storage *storage)
@@ -55,6 +80,13 @@ int part_table_read(struct partition_table_storage *storage)
 	}
 
 	flash_release_powerdown();
+
+	if (part_table_kept_ok(storage)) {
+		return 0;
+	}
+
+	part_table_kept = 0;
+	part_status = 0;
 	(void)memset(storage, 0x00, sizeof(*storage));
 
 	for (int i = 0; i < 2; i++) {
@@ -71,6 +103,8 @@ int part_table_read(struct partition_table_storage *storage)
 				part_status = PART_SLOT0_INVALID;
 			}
 
+			part_table_kept = PART_TABLE_KEPT;
+
 			return 0;
 		}
 	}
@@ -89,6 +123,9 @@ int part_table_write(struct partition_table_storage *storage)
 		return -1;
 	}
 
+	// Not the same as in flash until both copies are written.
+	part_table_kept = 0;
+
 	part_checksum(&storage->table, storage->checksum,
 		      sizeof(storage->checksum));
 
@@ -100,5 +137,8 @@ int part_table_write(struct partition_table_storage *storage)
 		}
 	}
 
+	part_table_kept = PART_TABLE_KEPT;
+	part_status = 0;
+
 	return 0;
 }
@@ -108,6 +108,10 @@ struct partition_table_storage {
 	uint8_t checksum[PART_CHECKSUM_SIZE]; // Helps detect flash problems
 } __attribute__((packed));
 
+// Put in the part of FW_RAM which isn't cleared on boot, so it is
+// kept over a system reset.
+#define FW_RAM_WARMBOOT __attribute__((section(".warmboot")))
+
 enum part_status part_get_status(void);
 int part_table_read(struct partition_table_storage *storage);
 int part_table_write(struct partition_table_storage *storage);
@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: 2024 Tillitis AB <tillitis.se>
 // SPDX-License-Identifier: BSD-2-Clause
 
+#include <blake2s/blake2s.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -19,8 +20,10 @@ static uint32_t slot_to_start_address(uint8_t slot)
 	return ADDR_PRE_LOADED_APP_0 + slot * SIZE_PRE_LOADED_APP;
 }
 
-// Loads a preloaded app from flash to app RAM
-int preload_load(struct partition_table *part_table, uint8_t from_slot)
+// Loads a preloaded app from flash to app RAM and computes its BLAKE2s
+// digest.
+int preload_load(struct partition_table *part_table, uint8_t from_slot,
+		 uint8_t digest[32])
 {
 	if (part_table == NULL) {
 		return -1;
@@ -38,10 +41,38 @@ int preload_load(struct partition_table *part_table, uint8_t from_slot)
 	uint8_t *loadaddr = (uint8_t *)TK1_RAM_BASE;
 
 	// Read from flash, straight into RAM
-	int ret = flash_read_data(slot_to_start_address(from_slot), loadaddr,
-				  part_table->pre_app_data[from_slot].size);
+	if (flash_read_data(slot_to_start_address(from_slot), loadaddr,
+			    part_table->pre_app_data[from_slot].size) != 0) {
+		return -1;
+	}
+
+	return blake2s(digest, 32, NULL, 0, loadaddr,
+		       part_table->pre_app_data[from_slot].size);
+}
+
+// Reads size bytes at offset of the app in from_slot into dest.
+// Everything read must be within the app.
+//
+// Returns 0 on success.
+int preload_read(struct partition_table *part_table, uint8_t from_slot,
+		 uint32_t offset, uint8_t *dest, size_t size)
+{
+	if (part_table == NULL || dest == NULL) {
+		return -1;
+	}
+
+	if (from_slot >= N_PRELOADED_APP) {
+		return -1;
+	}
+
+	if (part_table->pre_app_data[from_slot].size > TK1_APP_MAX_SIZE ||
+	    offset > part_table->pre_app_data[from_slot].size ||
+	    size > part_table->pre_app_data[from_slot].size - offset) {
+		return -1;
+	}
 
-	return ret;
+	return flash_read_data(slot_to_start_address(from_slot) + offset,
+			       dest, size);
 }
 
 // preload_store stores chunks of an app in app slot to_slot. data is a buffer
@@ -9,7 +9,10 @@
 #include <stddef.h>
 #include <stdint.h>
 
-int preload_load(struct partition_table *part_table, uint8_t from_slot);
+int preload_load(struct partition_table *part_table, uint8_t from_slot,
+		 uint8_t digest[32]);
+int preload_read(struct partition_table *part_table, uint8_t from_slot,
+		 uint32_t offset, uint8_t *dest, size_t size);
 int preload_store(struct partition_table *part_table, uint32_t offset,
 		  uint8_t *data, size_t size, uint8_t to_slot);
 int preload_store_finalize(struct partition_table_storage *part_table_storage,
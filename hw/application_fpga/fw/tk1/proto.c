@@ -26,51 +26,25 @@ static uint8_t genhdr(uint8_t id, uint8_t endpoint, uint8_t status,
 int readcommand(struct frame_header *hdr, uint8_t *cmd, int state)
 {
 	uint8_t in = 0;
-	uint8_t available = 0;
-	enum ioend endpoint = IO_NONE;
 
 	led_set((state == FW_STATE_LOADING) ? LED_BLACK : LED_WHITE);
 
-	debug_puts("readcommand\n");
-
-	if (readselect(IO_CDC, &endpoint, &available) < 0) {
-		return -1;
-	}
-
-	if (read(IO_CDC, &in, 1, 1) == -1) {
+	// Read the frame header and then the whole frame in one go,
+	// straight from the UART FIFO.
+	if (readfull(IO_CDC, &in, 1, 1) < 0) {
 		return -1;
 	}
 
-	debug_puts("read 1 byte\n");
-
 	if (parseframe(in, hdr) == -1) {
 		debug_puts("Couldn't parse header\n");
 		return -1;
 	}
 
-	debug_puts("parseframe succeeded\n");
-
 	(void)memset(cmd, 0, CMDSIZE);
 
 	// Now we know the size of the cmd frame, read it all
-	uint8_t n = 0;
-	while (n < hdr->len) {
-		// Wait for something to be available
-		if (readselect(IO_CDC, &endpoint, &available) < 0) {
-			return -1;
-		}
-
-		// Read as much as is available of what we expect
-		available = available > hdr->len ? hdr->len : available;
-
-		assert(n < CMDSIZE);
-		int n_bytes_read =
-		    read(IO_CDC, &cmd[n], CMDSIZE - n, available);
-		if (n_bytes_read < 0) {
-			return -1;
-		}
-
-		n += n_bytes_read;
+	if (readfull(IO_CDC, cmd, CMDSIZE, hdr->len) < 0) {
+		return -1;
 	}
 
 	// Is it for us?
@@ -106,8 +80,8 @@ static int parseframe(uint8_t b, struct frame_header *hdr)
 void fwreply(struct frame_header hdr, enum fwcmd rspcode, uint8_t *buf)
 {
 	size_t nbytes = 0;
-	enum cmdlen len = 0;	// length covering (rspcode + length of buf)
-	uint8_t frame[1 + 128]; // Frame header + longest response
+	enum cmdlen len = 0; // length covering (rspcode + length of buf)
+	uint8_t hdrs[2];     // Frame header + response code
 
 	switch (rspcode) {
 	case FW_RSP_NAME_VERSION:
@@ -122,6 +96,10 @@ void fwreply(struct frame_header hdr, enum fwcmd rspcode, uint8_t *buf)
 		len = LEN_4;
 		break;
 
+	case FW_RSP_LOAD_APP_DATA_WIN:
+		len = LEN_4;
+		break;
+
 	case FW_RSP_LOAD_APP_DATA_READY:
 		len = LEN_128;
 		break;
@@ -130,6 +108,10 @@ void fwreply(struct frame_header hdr, enum fwcmd rspcode, uint8_t *buf)
 		len = LEN_32;
 		break;
 
+	case FW_RSP_GET_BOOT_TRACE:
+		len = LEN_128;
+		break;
+
 	default:
 		debug_puts("fwreply(): Unknown response code: 0x");
 		debug_puthex(rspcode);
@@ -140,14 +122,17 @@ void fwreply(struct frame_header hdr, enum fwcmd rspcode, uint8_t *buf)
 	nbytes = bytelen(len);
 
 	// Frame Protocol Header
-	frame[0] = genhdr(hdr.id, hdr.endpoint, 0x0, len);
+	hdrs[0] = genhdr(hdr.id, hdr.endpoint, 0x0, len);
 	// App protocol header
-	frame[1] = rspcode;
+	hdrs[1] = rspcode;
 
-	// Payload
-	memcpy(&frame[2], buf, nbytes - 1);
+	// Payload straight from buf
+	struct iovec iov[2] = {
+	    {hdrs, sizeof(hdrs)},
+	    {buf, nbytes - 1},
+	};
 
-	write(IO_CDC, frame, 1 + nbytes);
+	writev(IO_CDC, iov, 2);
 }
 
 // bytelen returns the number of bytes a cmdlen takes
@@ -34,10 +34,23 @@ enum fwcmd {
 	FW_RSP_LOAD_APP_DATA_READY	= 0x07,
 	FW_CMD_GET_UDI			= 0x08,
 	FW_RSP_GET_UDI			= 0x09,
-	FW_CMD_MAX                      = 0x0a,
+	FW_CMD_LOAD_APP_DATA_WIN	= 0x0a,
+	FW_RSP_LOAD_APP_DATA_WIN	= 0x0b,
+	FW_CMD_GET_BOOT_TRACE		= 0x0c,
+	FW_RSP_GET_BOOT_TRACE		= 0x0d,
+	FW_CMD_MAX                      = 0x0e,
 };
 // clang-format on
 
+// Number of FW_CMD_LOAD_APP_DATA_WIN frames the client may send
+// before it gets a cumulative acknowledgement. One for every value of
+// the 2 bit frame ID.
+#define LOAD_WINDOW 4
+
+// Flags in FW_CMD_LOAD_APP, after the USS.
+#define LOAD_APP_FLAG_COMPRESSED 0x01 // App data is LZ4 compressed
+#define LOAD_APP_FLAG_DELTA 0x02      // App data is a delta against slot 1
+
 enum status {
 	STATUS_OK,
 	STATUS_BAD
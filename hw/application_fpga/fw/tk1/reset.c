@@ -15,8 +15,27 @@
 static volatile uint32_t *cdi           = (volatile uint32_t *)TK1_MMIO_TK1_CDI_FIRST;
 static volatile uint32_t *system_reset  = (volatile uint32_t *)TK1_MMIO_TK1_SYSTEM_RESET;
 static volatile struct reset *resetinfo = (volatile struct reset *)TK1_MMIO_RESETINFO_BASE;
+static volatile uint32_t *can_tx        = (volatile uint32_t *)TK1_MMIO_UART_TX_STATUS;
+static volatile uint32_t *tx_free       = (volatile uint32_t *)TK1_MMIO_UART_TX_FREE;
 // clang-format on
 
+// Wait for the UART to start sending everything in its transmit
+// FIFO, which is cleared by the system reset.
+static void uart_tx_drain(void)
+{
+	for (;;) {
+		if (*tx_free == TK1_UART_TX_FIFO_SIZE) {
+			return;
+		}
+
+		// No free count at all, QEMU. can_tx is read first
+		// since the free count can only grow meanwhile.
+		if (*can_tx && *tx_free == 0) {
+			return;
+		}
+	}
+}
+
 int reset(struct user_reset *userreset, size_t nextlen)
 {
 	if (!in_app_ram(userreset, sizeof(struct user_reset))) {
@@ -52,6 +71,8 @@ int reset(struct user_reset *userreset, size_t nextlen)
 	memcpy((void *)resetinfo->next_app_data, userreset->next_app_data,
 	       nextlen);
 
+	uart_tx_drain();
+
 	// Do the actual reset.
 	*system_reset = 1;
 
@@ -54,23 +54,40 @@ static void spi_write(uint8_t *cmd, size_t size)
 	}
 }
 
+// Reads are pipelined: as soon as a byte has been picked up the next
+// transfer is started, so storing the byte and the loop overhead runs
+// while the next byte is clocked in. The rx register is only valid
+// between transfers, so it can't be read any later than that.
 static void spi_read(uint8_t *buf, size_t size)
 {
 	assert(buf != NULL);
 
+	if (size == 0) {
+		return;
+	}
+
 	while (!spi_ready()) {
 	}
 
-	for (size_t i = 0; i < size; i++) {
+	*spi_data = 0x00;
+	*spi_xfer = 1;
 
-		*spi_data = 0x00;
-		*spi_xfer = 1;
+	for (size_t i = 0; i < size; i++) {
+		uint8_t b;
 
 		// wait until spi master is done
 		while (!spi_ready()) {
 		}
 
-		buf[i] = (*spi_data & 0xff);
+		b = (*spi_data & 0xff);
+
+		// The tx register has been shifted out to all zeroes,
+		// just start the next one.
+		if (i + 1 < size) {
+			*spi_xfer = 1;
+		}
+
+		buf[i] = b;
 	}
 }
 
@@ -7,11 +7,14 @@
 #include <tkey/lib.h>
 #include <tkey/tk1_mem.h>
 
+#include "boot_trace.h"
+#include "memcheck.h"
 #include "partition_table.h"
 #include "preload_app.h"
 #include "reset.h"
 #include "storage.h"
 #include "syscall_num.h"
+#include "uart_irq.h"
 
 // clang-format off
 static volatile uint32_t *udi           = (volatile uint32_t *)TK1_MMIO_TK1_UDI_FIRST;
@@ -31,6 +34,7 @@ int32_t syscall_handler(uint32_t number, uint32_t arg1, uint32_t arg2,
 	case TK1_SYSCALL_ALLOC_AREA:
 		if (storage_allocate_area(&part_table_storage) < 0) {
 			debug_puts("couldn't allocate storage area\n");
+			debug_flush();
 			return -1;
 		}
 		return 0;
@@ -38,6 +42,7 @@ int32_t syscall_handler(uint32_t number, uint32_t arg1, uint32_t arg2,
 	case TK1_SYSCALL_DEALLOC_AREA:
 		if (storage_deallocate_area(&part_table_storage) < 0) {
 			debug_puts("couldn't deallocate storage area\n");
+			debug_flush();
 			return -1;
 		}
 		return 0;
@@ -46,6 +51,7 @@ int32_t syscall_handler(uint32_t number, uint32_t arg1, uint32_t arg2,
 		if (storage_write_data(&part_table_storage.table, arg1,
 				       (uint8_t *)arg2, arg3) < 0) {
 			debug_puts("couldn't write storage area\n");
+			debug_flush();
 			return -1;
 		}
 		return 0;
@@ -54,6 +60,7 @@ int32_t syscall_handler(uint32_t number, uint32_t arg1, uint32_t arg2,
 		if (storage_read_data(&part_table_storage.table, arg1,
 				      (uint8_t *)arg2, arg3) < 0) {
 			debug_puts("couldn't read storage area\n");
+			debug_flush();
 			return -1;
 		}
 		return 0;
@@ -62,6 +69,7 @@ int32_t syscall_handler(uint32_t number, uint32_t arg1, uint32_t arg2,
 		if (storage_erase_sector(&part_table_storage.table, arg1,
 					 arg2) < 0) {
 			debug_puts("couldn't erase storage area\n");
+			debug_flush();
 			return -1;
 		}
 		return 0;
@@ -113,6 +121,19 @@ int32_t syscall_handler(uint32_t number, uint32_t arg1, uint32_t arg2,
 	case TK1_SYSCALL_ERASE_AREAS:
 		return storage_erase_areas(&part_table_storage);
 
+	case TK1_SYSCALL_GET_BOOT_TRACE:
+		// arg1 buf
+		// arg2 bufsize
+		if (!in_app_ram((uint8_t *)arg1, arg2)) {
+			return -1;
+		}
+		return boot_trace_get((uint8_t *)arg1, arg2);
+
+	case TK1_SYSCALL_UART_RX_RING:
+		// arg1 ring
+		// arg2 size of ring buffer
+		return uart_rx_ring_set((struct uart_rx_ring *)arg1, arg2);
+
 	default:
 		assert(1 == 2);
 	}
@@ -21,6 +21,8 @@ enum syscall_num {
 	TK1_SYSCALL_GET_APP_DATA = 14,
 	TK1_SYSCALL_PRELOAD_SET_PUBKEY = 15,
 	TK1_SYSCALL_ERASE_AREAS = 16,
+	TK1_SYSCALL_GET_BOOT_TRACE = 17,
+	TK1_SYSCALL_UART_RX_RING = 18,
 };
 
 #endif
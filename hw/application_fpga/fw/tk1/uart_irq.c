@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <stddef.h>
+#include <stdint.h>
+#include <tkey/tk1_mem.h>
+
+#include "memcheck.h"
+#include "uart_irq.h"
+
+// clang-format off
+static volatile uint32_t *const rx      = (volatile uint32_t *)TK1_MMIO_UART_RX_DATA;
+static volatile uint32_t *const rxbytes = (volatile uint32_t *)TK1_MMIO_UART_RX_BYTES;
+static volatile uint32_t *const rx_irq  = (volatile uint32_t *)TK1_MMIO_UART_RX_IRQ;
+// clang-format on
+
+// The app's receive ring, see struct uart_rx_ring in tkey-libs. head
+// is only written by us, tail only by the app.
+static struct uart_rx_ring *rx_ring;
+
+// uart_rx_ring_set registers the app's receive ring. size is the size
+// of the ring buffer, which must match ours, to catch an app built
+// with another version of tkey-libs. A NULL ring stops the use of the
+// ring and disables the receive interrupt.
+//
+// Returns 0 on success.
+int uart_rx_ring_set(struct uart_rx_ring *ring, size_t size)
+{
+	if (ring == NULL) {
+		*rx_irq = 0;
+		rx_ring = NULL;
+
+		return 0;
+	}
+
+	if (size != sizeof(ring->buf)) {
+		return -1;
+	}
+
+	if (!in_app_ram(ring, sizeof(*ring))) {
+		return -1;
+	}
+
+	rx_ring = ring;
+
+	return 0;
+}
+
+// uart_irq_handler is called from the IRQ30 entry in start.S when the
+// UART receive FIFO has data and the app has enabled the interrupt.
+//
+// Moves everything in the FIFO to the app's ring. If the ring is full
+// the interrupt is disabled, leaving the rest in the FIFO and letting
+// the CTS flow control stop the sender. The app enables the interrupt
+// again when it has made room.
+void uart_irq_handler(void)
+{
+	if (rx_ring == NULL) {
+		// Nowhere to put it.
+		*rx_irq = 0;
+		return;
+	}
+
+	// The app controls tail, so never trust it for more than the
+	// fill level. The index is always taken modulo the ring size.
+	uint32_t head = rx_ring->head;
+	uint32_t tail = rx_ring->tail;
+	uint32_t n = *rxbytes;
+
+	while (n-- > 0) {
+		if (head - tail >= UART_RX_RING_SIZE) {
+			*rx_irq = 0;
+			break;
+		}
+
+		rx_ring->buf[head % UART_RX_RING_SIZE] = *rx;
+		head++;
+	}
+
+	rx_ring->head = head;
+}
@@ -0,0 +1,13 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef UART_IRQ_H
+#define UART_IRQ_H
+
+#include <stddef.h>
+#include <tkey/io.h>
+
+int uart_rx_ring_set(struct uart_rx_ring *ring, size_t size);
+void uart_irq_handler(void);
+
+#endif
@@ -69,6 +69,7 @@ module application_fpga_sim (
   localparam UDS_PREFIX = 6'h02;
   localparam UART_PREFIX = 6'h03;
   localparam TOUCH_SENSE_PREFIX = 6'h04;
+  localparam BLAKE2S_PREFIX = 6'h05;
   localparam FW_RAM_PREFIX = 6'h10;
   localparam SYSCALL_PREFIX = 6'h21;
   localparam TK1_PREFIX = 6'h3f;
@@ -77,6 +78,7 @@ module application_fpga_sim (
   localparam ILLEGAL_INSTRUCTION = 32'h0;
 
   localparam IRQ31_IRQ_MASK = 2 ** 31;
+  localparam IRQ30_IRQ_MASK = 2 ** 30;
 
   //----------------------------------------------------------------
   // Registers, memories with associated wires.
@@ -104,6 +106,17 @@ module application_fpga_sim (
   wire [31 : 0] cpu_addr;
   wire [31 : 0] cpu_wdata;
 
+`ifdef PCPI
+  wire          pcpi_valid;
+  wire [31 : 0] pcpi_insn;
+  wire [31 : 0] pcpi_rs1;
+  wire [31 : 0] pcpi_rs2;
+  wire          pcpi_wr;
+  wire [31 : 0] pcpi_rd;
+  wire          pcpi_wait;
+  wire          pcpi_ready;
+`endif
+
   reg           rom_cs;
   reg  [10 : 0] rom_address;
   wire [31 : 0] rom_read_data;
@@ -130,6 +143,13 @@ module application_fpga_sim (
   wire [31 : 0] timer_read_data;
   wire          timer_ready;
 
+  reg           blake2s_cs;
+  reg           blake2s_we;
+  reg  [ 7 : 0] blake2s_address;
+  reg  [31 : 0] blake2s_write_data;
+  wire [31 : 0] blake2s_read_data;
+  wire          blake2s_ready;
+
   reg           uds_cs;
   reg  [ 2 : 0] uds_address;
   wire [31 : 0] uds_read_data;
@@ -141,6 +161,7 @@ module application_fpga_sim (
   reg  [31 : 0] uart_write_data;
   wire [31 : 0] uart_read_data;
   wire          uart_ready;
+  wire          uart_rx_irq;
 
   reg           fw_ram_cs;
   reg  [ 3 : 0] fw_ram_we;
@@ -158,6 +179,7 @@ module application_fpga_sim (
   reg           irq31_cs;
   reg           irq31_we;
   reg           irq31_eoi;
+  reg           irq30_eoi;
 
   reg           tk1_cs;
   reg           tk1_we;
@@ -170,6 +192,10 @@ module application_fpga_sim (
   wire          force_trap;
   wire [14 : 0] ram_addr_rand;
   wire [31 : 0] ram_data_rand;
+  wire          ram_fill_start;
+  wire [31 : 0] ram_fill_seed;
+  wire [31 : 0] ram_fill_acc;
+  wire          ram_fill_busy;
   wire          tk1_system_reset;
   /* verilator lint_on UNOPTFLAT */
 
@@ -190,12 +216,17 @@ module application_fpga_sim (
       .TWO_STAGE_SHIFT (0),
       .CATCH_MISALIGN  (0),
       .COMPRESSED_ISA  (1),
+`ifdef PCPI
+      .ENABLE_PCPI     (1),
+      .ENABLE_FAST_MUL (0),
+`else
       .ENABLE_FAST_MUL (1),
+`endif
       .BARREL_SHIFTER  (1),
       .ENABLE_IRQ      (1),
       .ENABLE_IRQ_QREGS(0),
       .ENABLE_IRQ_TIMER(0),
-      .MASKED_IRQ      (~IRQ31_IRQ_MASK),
+      .MASKED_IRQ      (~(IRQ31_IRQ_MASK | IRQ30_IRQ_MASK)),
       .LATCHED_IRQ     (IRQ31_IRQ_MASK)
   ) cpu (
       .clk(clk),
@@ -213,6 +244,17 @@ module application_fpga_sim (
       .irq(cpu_irq),
       .eoi(cpu_eoi),
 
+`ifdef PCPI
+      .pcpi_valid(pcpi_valid),
+      .pcpi_insn(pcpi_insn),
+      .pcpi_rs1(pcpi_rs1),
+      .pcpi_rs2(pcpi_rs2),
+      .pcpi_wr(pcpi_wr),
+      .pcpi_rd(pcpi_rd),
+      .pcpi_wait(pcpi_wait),
+      .pcpi_ready(pcpi_ready),
+`endif
+
       // Defined unused ports. Makes lint happy. But
       // we still needs to help lint with empty ports.
       /* verilator lint_off PINCONNECTEMPTY */
@@ -222,6 +264,9 @@ module application_fpga_sim (
       .mem_la_write(),
       .mem_la_addr(),
       .mem_la_wdata(),
+`ifdef PCPI
+      .mem_la_wstrb()
+`else
       .mem_la_wstrb(),
       .pcpi_valid(),
       .pcpi_insn(),
@@ -231,10 +276,28 @@ module application_fpga_sim (
       .pcpi_rd(32'h0),
       .pcpi_wait(1'h0),
       .pcpi_ready(1'h0)
+`endif
       /* verilator lint_on PINCONNECTEMPTY */
   );
 
 
+`ifdef PCPI
+  pcpi_ext pcpi_ext_inst (
+      .clk(clk),
+      .reset_n(reset_n),
+
+      .pcpi_valid(pcpi_valid),
+      .pcpi_insn(pcpi_insn),
+      .pcpi_rs1(pcpi_rs1),
+      .pcpi_rs2(pcpi_rs2),
+      .pcpi_wr(pcpi_wr),
+      .pcpi_rd(pcpi_rd),
+      .pcpi_wait(pcpi_wait),
+      .pcpi_ready(pcpi_ready)
+  );
+`endif
+
+
   rom rom_inst (
       .clk(clk),
       .reset_n(reset_n),
@@ -253,6 +316,11 @@ module application_fpga_sim (
       .ram_addr_rand(ram_addr_rand),
       .ram_data_rand(ram_data_rand),
 
+      .fill_start(ram_fill_start),
+      .fill_seed(ram_fill_seed),
+      .fill_acc(ram_fill_acc),
+      .fill_busy(ram_fill_busy),
+
       .cs(ram_cs),
       .we(ram_we),
       .address(ram_address),
@@ -302,6 +370,19 @@ module application_fpga_sim (
   );
 
 
+  blake2s blake2s_inst (
+      .clk(clk),
+      .reset_n(reset_n),
+
+      .cs(blake2s_cs),
+      .we(blake2s_we),
+      .address(blake2s_address),
+      .write_data(blake2s_write_data),
+      .read_data(blake2s_read_data),
+      .ready(blake2s_ready)
+  );
+
+
   uds uds_inst (
       .clk(clk),
       .reset_n(reset_n),
@@ -330,7 +411,9 @@ module application_fpga_sim (
       .address(uart_address),
       .write_data(uart_write_data),
       .read_data(uart_read_data),
-      .ready(uart_ready)
+      .ready(uart_ready),
+
+      .rx_irq(uart_rx_irq)
   );
 
 
@@ -368,6 +451,11 @@ module application_fpga_sim (
       .ram_addr_rand(ram_addr_rand),
       .ram_data_rand(ram_data_rand),
 
+      .ram_fill_start(ram_fill_start),
+      .ram_fill_seed(ram_fill_seed),
+      .ram_fill_acc(ram_fill_acc),
+      .ram_fill_busy(ram_fill_busy),
+
       .spi_ss  (spi_ss),
       .spi_sck (spi_sck),
       .spi_mosi(spi_mosi),
@@ -382,7 +470,7 @@ module application_fpga_sim (
       .gpio3(app_gpio3),
       .gpio4(app_gpio4),
 
-      .syscall(irq31_eoi),
+      .syscall(irq31_eoi | irq30_eoi),
 
       .cs(tk1_cs),
       .we(tk1_we),
@@ -417,9 +505,10 @@ module application_fpga_sim (
     reg irq31_set;
 
     irq31_set = irq31_cs & irq31_we;
-    cpu_irq   = {irq31_set, 31'h0};
+    cpu_irq   = {irq31_set, uart_rx_irq, 30'h0};
 
     irq31_eoi = cpu_eoi[31];
+    irq30_eoi = cpu_eoi[30];
   end
 
 
@@ -462,6 +551,11 @@ module application_fpga_sim (
     timer_address       = cpu_addr[9 : 2];
     timer_write_data    = cpu_wdata;
 
+    blake2s_cs          = 1'h0;
+    blake2s_we          = |cpu_wstrb;
+    blake2s_address     = cpu_addr[9 : 2];
+    blake2s_write_data  = cpu_wdata;
+
     uds_cs              = 1'h0;
     uds_address         = cpu_addr[4 : 2];
 
@@ -561,6 +655,14 @@ module application_fpga_sim (
                 muxed_ready_new = touch_sense_ready;
               end
 
+              BLAKE2S_PREFIX: begin
+                `verbose($display("Access to BLAKE2S core");)
+                ascii_state     = "BLAKE2S core";
+                blake2s_cs      = 1'h1;
+                muxed_rdata_new = blake2s_read_data;
+                muxed_ready_new = blake2s_ready;
+              end
+
               FW_RAM_PREFIX: begin
                 `verbose($display("Access to FW_RAM core");)
                 ascii_state     = "FW_RAM core";
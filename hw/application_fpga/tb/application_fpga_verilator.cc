@@ -19,15 +19,16 @@
 #include <stdint.h>
 #include <string.h>
 #include <signal.h>
+#include <stdlib.h>
 #include <sys/types.h>
 
 #include "Vapplication_fpga_sim.h"
 #include "verilated.h"
 
-// Clock: 21 MHz, 62500 bps
-// Divisor = 21E6 / 62500 = 336
-#define CPU_CLOCK 21000000
-#define BAUD_RATE 62500
+// Clock: 24 MHz, 500 kbps, must match DEFAULT_BIT_RATE in uart.v
+// Divisor = 24E6 / 500E3 = 48
+#define CPU_CLOCK 24000000
+#define BAUD_RATE 500000
 #define BIT_DIV (CPU_CLOCK/BAUD_RATE)
 
 
@@ -287,6 +288,729 @@ void touch(uint8_t *touch_event)
 	}
 }
 
+// Turnaround measurement, enabled with +turnaround on the command
+// line. Reports the number of CPU cycles from the stop bit of the last
+// byte sent by the host until the start bit of the first byte of the
+// reply. Useful for measuring how long firmware or an app takes to
+// process a request, e.g. the final FW_CMD_LOAD_APP_DATA.
+struct turnaround {
+	int enabled;
+	int pending;
+	unsigned int host_done_ts;
+	int prev_tx_state;
+	int prev_rx_state;
+};
+
+void turnaround_init(struct turnaround *t, int enabled);
+void turnaround_tick(struct turnaround *t, struct uart *u);
+
+void turnaround_init(struct turnaround *t, int enabled)
+{
+	memset(t, 0, sizeof(*t));
+	t->enabled = enabled;
+}
+
+void turnaround_tick(struct turnaround *t, struct uart *u)
+{
+	if (!t->enabled)
+		return;
+
+	if (u->tx_has_data) {
+		// Host is still sending.
+		t->pending = 0;
+	}
+
+	if (t->prev_tx_state == 10 && u->tx_state == 0 && !u->tx_has_data) {
+		// Stop bit of a host byte just ended.
+		t->host_done_ts = u->ts;
+		t->pending = 1;
+	}
+
+	if (t->prev_rx_state == 0 && u->rx_state == 1 && t->pending) {
+		// Start bit of the first reply byte.
+		printf("turnaround: %u cycles\n", u->ts - t->host_done_ts);
+		t->pending = 0;
+	}
+
+	t->prev_tx_state = u->tx_state;
+	t->prev_rx_state = u->rx_state;
+}
+
+// SPI flash model, enough of a W25Q80 for the firmware: read data,
+// status, write enable/disable, page program and erase. Contents are
+// loaded from the file given with +flash=<file>, typically a
+// flash_image.bin built with tkeyimage. Without it the flash is
+// erased and firmware will fail to read the partition table.
+#define FLASH_SIZE 0x100000
+
+struct flash {
+	uint8_t mem[FLASH_SIZE];
+	int prev_ss;
+	int prev_sck;
+	int bitcnt;
+	int bytecnt;
+	uint8_t in;
+	uint8_t out;
+	uint8_t cmd;
+	uint32_t addr;
+	int wel;
+};
+
+int flash_init(struct flash *f, const char *fname);
+void flash_tick(struct flash *f, uint8_t ss, uint8_t sck, uint8_t mosi,
+		uint8_t *miso);
+
+int flash_init(struct flash *f, const char *fname)
+{
+	FILE *fp;
+
+	memset(f, 0, sizeof(*f));
+	memset(f->mem, 0xff, sizeof(f->mem));
+	f->prev_ss = 1;
+
+	if (fname == NULL)
+		return 0;
+
+	if ((fp = fopen(fname, "rb")) == NULL)
+		return -1;
+
+	printf("flash: %s, %zu bytes\n", fname,
+	       fread(f->mem, 1, sizeof(f->mem), fp));
+	fclose(fp);
+
+	return 0;
+}
+
+static int flash_has_addr(uint8_t cmd)
+{
+	return cmd == 0x03 || cmd == 0x02 || cmd == 0x20 || cmd == 0x52 ||
+	    cmd == 0xd8;
+}
+
+static void flash_byte(struct flash *f, uint8_t b)
+{
+	if (f->bytecnt == 0) {
+		f->cmd = b;
+		f->addr = 0;
+		f->out = 0;
+
+		switch (b) {
+		case 0x05: // Read status register 1, never busy
+			f->out = f->wel << 1;
+			break;
+		case 0x06: // Write enable
+			f->wel = 1;
+			break;
+		case 0x04: // Write disable
+			f->wel = 0;
+			break;
+		case 0x9f: // JEDEC ID
+			f->out = 0xef;
+			break;
+		}
+	} else if (flash_has_addr(f->cmd) && f->bytecnt <= 3) {
+		f->addr = (f->addr << 8) | b;
+		if (f->cmd == 0x03 && f->bytecnt == 3)
+			f->out = f->mem[f->addr % FLASH_SIZE];
+	} else {
+		switch (f->cmd) {
+		case 0x03: // Read data
+			f->addr++;
+			f->out = f->mem[f->addr % FLASH_SIZE];
+			break;
+		case 0x02: // Page program, wraps within the page
+			if (f->wel) {
+				uint32_t a = (f->addr & ~0xffu) |
+				    ((f->addr + f->bytecnt - 4) & 0xff);
+				f->mem[a % FLASH_SIZE] &= b;
+			}
+			break;
+		case 0x05:
+			f->out = f->wel << 1;
+			break;
+		case 0x9f:
+			f->out = f->bytecnt == 1 ? 0x40 : 0x14;
+			break;
+		}
+	}
+
+	f->bytecnt++;
+}
+
+static void flash_end(struct flash *f)
+{
+	uint32_t size = 0;
+
+	switch (f->cmd) {
+	case 0x20:
+		size = 0x1000;
+		break;
+	case 0x52:
+		size = 0x8000;
+		break;
+	case 0xd8:
+		size = 0x10000;
+		break;
+	case 0xc7:
+		size = FLASH_SIZE;
+		break;
+	case 0x02:
+		f->wel = 0;
+		return;
+	default:
+		return;
+	}
+
+	if (f->wel && (f->cmd == 0xc7 || f->bytecnt >= 4)) {
+		uint32_t start = (f->addr % FLASH_SIZE) & ~(size - 1);
+		memset(&f->mem[start], 0xff, size);
+	}
+	f->wel = 0;
+}
+
+void flash_tick(struct flash *f, uint8_t ss, uint8_t sck, uint8_t mosi,
+		uint8_t *miso)
+{
+	if (ss) {
+		if (!f->prev_ss)
+			flash_end(f);
+
+		f->bitcnt = 0;
+		f->bytecnt = 0;
+		f->prev_ss = 1;
+		f->prev_sck = sck;
+		return;
+	}
+
+	// SPI mode 0: sample on rising edge, shift out on falling edge.
+	if (sck && !f->prev_sck) {
+		f->in = (f->in << 1) | (mosi & 1);
+		if (++f->bitcnt == 8) {
+			flash_byte(f, f->in);
+			f->bitcnt = 0;
+		}
+	} else if (!sck && f->prev_sck) {
+		*miso = (f->out >> 7) & 1;
+		f->out <<= 1;
+	}
+
+	f->prev_ss = 0;
+	f->prev_sck = sck;
+}
+
+// App loader benchmark, enabled with +loadapp=<file>. Acts as the
+// client: waits for firmware to come up in WAITCOMMAND, loads the app
+// and reports the number of cycles from the first LOAD_APP_DATA byte
+// until LOAD_APP_DATA_READY has been received.
+//
+// Uses FW_CMD_LOAD_APP_DATA with one round trip per frame by default
+// or the windowed FW_CMD_LOAD_APP_DATA_WIN with +window.
+//
+// Note that firmware must start in WAITCOMMAND, that is, the app in
+// flash slot 0 must reset to START_CLIENT, like the defaultapp.
+//
+// With +rxbench=<bytes> the loaded app is expected to be
+// apps/rxbench. When it has started we send it <bytes> bytes as fast
+// as CTS allows and report the number of cycles until it answers
+// with their sum and the result of the computation it does between
+// blocks, which we check. The computation keeps its state in
+// registers, so a bad result means the receive interrupt clobbered
+// app registers. The app polls the UART, or uses the UART receive
+// interrupt with +rxirq. With +rxfull it also lets the receive ring
+// fill up before every block it reads, so firmware turns the
+// interrupt off and the app must turn it on again. If we can't send
+// for a long time the app is stuck and we say so.
+//
+// With +evbench=<pings> the loaded app is expected to be apps/evbench.
+// We keep a FIDO request for long work outstanding all the time and
+// meanwhile send <pings> CDC pings, one at a time, reporting the
+// round trip times. The app yields to other events during the work,
+// or not with +evnoyield.
+//
+// With +console we send a newline to the loaded app when it has
+// started and print everything it writes on CDC, for apps like
+// apps/pcpibench that print their results.
+#define MODE_CDC 0x08
+#define MODE_FIDO 0x10
+#define MODE_CH552 0x04
+#define FRAME_FW(id, len) (((id) << 5) | (2 << 3) | (len))
+#define LOAD_WINDOW 4
+#define RXBENCH_STALL (2 * CPU_CLOCK) // Cycles without sending anything
+#define RXBENCH_BLOCK 1024	      // BLOCK_SIZE in apps/rxbench
+#define RXBENCH_ROUNDS 20000	      // WORK_ROUNDS in apps/rxbench
+
+enum loader_state {
+	LOADER_WAIT_BOOT,
+	LOADER_WAIT_NAME,
+	LOADER_WAIT_LOAD_APP,
+	LOADER_LOADING,
+	LOADER_RXBENCH,
+	LOADER_EVBENCH,
+	LOADER_CONSOLE,
+	LOADER_DONE,
+};
+
+struct loader {
+	int enabled;
+	int window;
+	uint8_t *app;
+	size_t app_size;
+
+	uint8_t txbuf[1024];
+	size_t txlen;
+	size_t txpos;
+
+	int rx_mode_hdr; // USB Mode Protocol header bytes left to read
+	uint8_t rx_mode;
+	uint8_t rx_left;
+	uint8_t frame[129];
+	size_t frame_len;
+	size_t frame_need;
+
+	enum loader_state state;
+	size_t sent;
+	int frames_sent;
+	int frames_acked;
+	unsigned int start_ts;
+
+	uint32_t bench_size;
+	int bench_irq;
+	int bench_full;
+	uint32_t bench_sent;
+	unsigned int bench_sent_ts;
+	uint32_t bench_sum;
+	uint8_t bench_rsp[8];
+	int bench_rsp_len;
+
+	uint32_t ev_pings;
+	int ev_noyield;
+	uint32_t ev_done;
+	int ev_fido_outstanding;
+	int ev_ping_outstanding;
+	unsigned int ev_ping_ts;
+	unsigned int ev_min;
+	unsigned int ev_max;
+	uint64_t ev_sum;
+	uint32_t ev_fido_done;
+
+	int console;
+};
+
+int loader_init(struct loader *l, const char *fname, int window);
+void loader_bench(struct loader *l, uint32_t size, int irq, int full);
+void loader_evbench(struct loader *l, uint32_t pings, int noyield);
+void loader_console(struct loader *l, int console);
+void loader_tick(struct loader *l, struct uart *u, int fpga_cts);
+
+int loader_init(struct loader *l, const char *fname, int window)
+{
+	FILE *fp;
+
+	memset(l, 0, sizeof(*l));
+	l->rx_mode_hdr = 2;
+
+	if (fname == NULL)
+		return 0;
+
+	if ((fp = fopen(fname, "rb")) == NULL)
+		return -1;
+
+	l->app = (uint8_t *)malloc(0x20000);
+	l->app_size = fread(l->app, 1, 0x20000, fp);
+	fclose(fp);
+
+	if (l->app_size == 0)
+		return -1;
+
+	l->enabled = 1;
+	l->window = window;
+	printf("loadapp: %s, %zu bytes, %s\n", fname, l->app_size,
+	       window ? "windowed" : "one frame per round trip");
+
+	return 0;
+}
+
+void loader_bench(struct loader *l, uint32_t size, int irq, int full)
+{
+	l->bench_size = size;
+	l->bench_irq = irq || full;
+	l->bench_full = full;
+
+	if (size > 0)
+		printf("rxbench: %u bytes, %s\n", size,
+		       full ? "receive interrupt, full ring" :
+		       irq  ? "receive interrupt" :
+			      "polling");
+}
+
+void loader_evbench(struct loader *l, uint32_t pings, int noyield)
+{
+	l->ev_pings = pings;
+	l->ev_noyield = noyield;
+	l->ev_min = ~0u;
+
+	if (pings > 0)
+		printf("evbench: %u pings, %s\n", pings,
+		       noyield ? "no yield" : "yield");
+}
+
+void loader_console(struct loader *l, int console)
+{
+	l->console = console;
+}
+
+static void loader_send_mode(struct loader *l, uint8_t mode,
+			     const uint8_t *frame, size_t len)
+{
+	if (l->txpos == l->txlen)
+		l->txlen = l->txpos = 0;
+
+	l->txbuf[l->txlen++] = mode;
+	l->txbuf[l->txlen++] = len;
+	memcpy(&l->txbuf[l->txlen], frame, len);
+	l->txlen += len;
+}
+
+static void loader_send(struct loader *l, const uint8_t *frame, size_t len)
+{
+	loader_send_mode(l, MODE_CDC, frame, len);
+}
+
+static void loader_send_data(struct loader *l)
+{
+	uint8_t frame[129] = {0};
+	size_t n = l->app_size - l->sent;
+	int id = l->window ? l->frames_sent % LOAD_WINDOW : 0;
+
+	n = n > 127 ? 127 : n;
+	frame[0] = FRAME_FW(id, 3);
+	frame[1] = l->window ? 0x0a : 0x05;
+	memcpy(&frame[2], &l->app[l->sent], n);
+	loader_send(l, frame, sizeof(frame));
+
+	l->sent += n;
+	l->frames_sent++;
+}
+
+static void loader_send_bench(struct loader *l)
+{
+	uint8_t packet[64];
+	uint32_t n = l->bench_size - l->bench_sent;
+
+	n = n > sizeof(packet) ? sizeof(packet) : n;
+	for (uint32_t i = 0; i < n; i++) {
+		packet[i] = (l->bench_sent + i) * 7;
+		l->bench_sum += packet[i];
+	}
+	loader_send(l, packet, n);
+
+	l->bench_sent += n;
+}
+
+#define ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+// Same as work() in apps/rxbench.
+static uint32_t bench_work(uint32_t seed, uint32_t n)
+{
+	uint32_t a = seed, b = ~seed, c = seed ^ 0x9e3779b9, d = 1;
+	uint32_t e = 2, f = 3, g = 5, h = 7;
+
+	for (uint32_t i = 0; i < n; i++) {
+		a += b;
+		b = ROTL(b ^ c, 7);
+		c += d ^ i;
+		d = ROTL(d + e, 13);
+		e ^= f + a;
+		f = ROTL(f ^ g, 17);
+		g += h ^ b;
+		h = ROTL(h + a, 3);
+	}
+
+	return a ^ b ^ c ^ d ^ e ^ f ^ g ^ h;
+}
+
+// bench_check returns the computation result apps/rxbench should
+// answer with.
+static uint32_t bench_check(struct loader *l)
+{
+	uint32_t check = 0;
+	uint32_t sum = 0;
+
+	for (uint32_t i = 0; i < l->bench_size; i++) {
+		sum += (uint8_t)(i * 7);
+		if ((i + 1) % RXBENCH_BLOCK == 0 || i + 1 == l->bench_size)
+			check = bench_work(check ^ sum, RXBENCH_ROUNDS);
+	}
+
+	return check;
+}
+
+static uint32_t le32(const uint8_t *b)
+{
+	return b[0] | b[1] << 8 | b[2] << 16 | (uint32_t)b[3] << 24;
+}
+
+static void loader_bench_recv(struct loader *l, struct uart *u, uint8_t b)
+{
+	l->bench_rsp[l->bench_rsp_len++] = b;
+	if (l->bench_rsp_len < 8)
+		return;
+
+	unsigned int cycles = u->ts - l->start_ts;
+	uint32_t sum = le32(&l->bench_rsp[0]);
+	uint32_t check = le32(&l->bench_rsp[4]);
+
+	printf("rxbench: %u bytes in %u cycles, %.0f bytes/s, sum %s, "
+	       "registers %s\n",
+	       l->bench_size, cycles,
+	       (double)l->bench_size * CPU_CLOCK / cycles,
+	       sum == l->bench_sum ? "ok" : "BAD",
+	       check == bench_check(l) ? "ok" : "BAD");
+	l->state = LOADER_DONE;
+}
+
+static void loader_evbench_tick(struct loader *l, struct uart *u)
+{
+	if (l->txpos != l->txlen)
+		return;
+
+	if (!l->ev_fido_outstanding) {
+		uint8_t req = l->ev_noyield ? 'n' : 'y';
+
+		loader_send_mode(l, MODE_FIDO, &req, 1);
+		l->ev_fido_outstanding = 1;
+	} else if (!l->ev_ping_outstanding && l->ev_done < l->ev_pings) {
+		uint8_t ping[4] = {(uint8_t)l->ev_done,
+				   (uint8_t)(l->ev_done >> 8), 0, 0};
+
+		loader_send(l, ping, sizeof(ping));
+		l->ev_ping_outstanding = 1;
+		l->ev_ping_ts = u->ts;
+		l->bench_rsp_len = 0;
+	}
+}
+
+static void loader_evbench_recv(struct loader *l, struct uart *u, uint8_t b)
+{
+	if (l->rx_mode == MODE_FIDO) {
+		l->ev_fido_outstanding = 0;
+		l->ev_fido_done++;
+		return;
+	}
+
+	l->bench_rsp[l->bench_rsp_len++] = b;
+	if (l->bench_rsp_len < 4)
+		return;
+
+	unsigned int rtt = u->ts - l->ev_ping_ts;
+
+	l->ev_min = rtt < l->ev_min ? rtt : l->ev_min;
+	l->ev_max = rtt > l->ev_max ? rtt : l->ev_max;
+	l->ev_sum += rtt;
+	l->ev_done++;
+	l->ev_ping_outstanding = 0;
+
+	if (l->ev_done == l->ev_pings) {
+		printf("evbench: %u pings, round trip min %u avg %llu max %u "
+		       "cycles, %u FIDO requests done\n",
+		       l->ev_done, l->ev_min,
+		       (unsigned long long)(l->ev_sum / l->ev_done), l->ev_max,
+		       l->ev_fido_done);
+		l->state = LOADER_DONE;
+	}
+}
+
+static void loader_frame(struct loader *l, struct uart *u)
+{
+	uint8_t *f = l->frame;
+
+	switch (l->state) {
+	case LOADER_WAIT_NAME:
+		if (f[1] == 0x02) {
+			uint8_t frame[129] = {0};
+
+			frame[0] = FRAME_FW(0, 3);
+			frame[1] = 0x03; // FW_CMD_LOAD_APP
+			frame[2] = l->app_size;
+			frame[3] = l->app_size >> 8;
+			frame[4] = l->app_size >> 16;
+			frame[5] = l->app_size >> 24;
+			loader_send(l, frame, sizeof(frame));
+			l->state = LOADER_WAIT_LOAD_APP;
+		}
+		break;
+
+	case LOADER_WAIT_LOAD_APP:
+		if (f[1] == 0x04 && f[2] == 0) {
+			l->start_ts = u->ts;
+			l->state = LOADER_LOADING;
+		}
+		break;
+
+	case LOADER_LOADING:
+		if (f[2] != 0) {
+			printf("loadapp: bad status in response 0x%02x\n",
+			       f[1]);
+			l->state = LOADER_DONE;
+			break;
+		}
+
+		if (f[1] == 0x06) {
+			l->frames_acked++;
+		} else if (f[1] == 0x0b) {
+			l->frames_acked = f[3] | (f[4] << 8);
+		} else if (f[1] == 0x07) {
+			unsigned int cycles = u->ts - l->start_ts;
+
+			printf("loadapp: %d frames in %u cycles, %.0f bytes/s\n",
+			       l->frames_sent, cycles,
+			       (double)l->app_size * CPU_CLOCK / cycles);
+			printf("loadapp: digest ");
+			for (int i = 0; i < 32; i++)
+				printf("%02x", f[3 + i]);
+			printf("\n");
+			l->state = LOADER_DONE;
+
+			if (l->bench_size > 0) {
+				uint8_t cmd[5] = {
+				    (uint8_t)(l->bench_full ? 'f' :
+					      l->bench_irq  ? 'i' :
+							      'p'),
+				    (uint8_t)l->bench_size,
+				    (uint8_t)(l->bench_size >> 8),
+				    (uint8_t)(l->bench_size >> 16),
+				    (uint8_t)(l->bench_size >> 24)};
+
+				loader_send(l, cmd, sizeof(cmd));
+				l->start_ts = u->ts;
+				l->bench_sent_ts = u->ts;
+				l->state = LOADER_RXBENCH;
+			} else if (l->ev_pings > 0) {
+				l->state = LOADER_EVBENCH;
+			} else if (l->console) {
+				uint8_t key = '\n';
+
+				loader_send(l, &key, 1);
+				l->state = LOADER_CONSOLE;
+			}
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+static void loader_recv(struct loader *l, struct uart *u, uint8_t b)
+{
+	if (l->rx_mode_hdr == 2) {
+		l->rx_mode = b;
+		l->rx_mode_hdr--;
+		return;
+	}
+
+	if (l->rx_mode_hdr == 1) {
+		l->rx_left = b;
+		l->rx_mode_hdr = b == 0 ? 2 : 0;
+		return;
+	}
+
+	if (--l->rx_left == 0)
+		l->rx_mode_hdr = 2;
+
+	if (l->rx_mode == MODE_CH552) {
+		// Firmware configures the CH552 endpoints when it
+		// (re)starts. Start over.
+		// The app may do it too, ignore it then.
+		if (l->state <= LOADER_LOADING && l->rx_mode_hdr == 2) {
+			uint8_t frame[2] = {FRAME_FW(0, 0), 0x01};
+
+			l->txlen = l->txpos = 0;
+			l->frame_len = 0;
+			l->sent = 0;
+			l->frames_sent = 0;
+			l->frames_acked = 0;
+			loader_send(l, frame, sizeof(frame));
+			l->state = LOADER_WAIT_NAME;
+		}
+		return;
+	}
+
+	if (l->state == LOADER_EVBENCH) {
+		if (l->rx_mode == MODE_CDC || l->rx_mode == MODE_FIDO)
+			loader_evbench_recv(l, u, b);
+		return;
+	}
+
+	if (l->rx_mode != MODE_CDC)
+		return;
+
+	if (l->state == LOADER_RXBENCH) {
+		loader_bench_recv(l, u, b);
+		return;
+	}
+
+	if (l->state == LOADER_CONSOLE) {
+		putchar(b);
+		fflush(stdout);
+		return;
+	}
+
+	if (l->frame_len == 0) {
+		static const size_t bytelen[] = {1, 4, 32, 128};
+
+		l->frame_need = 1 + bytelen[b & 3];
+	}
+
+	l->frame[l->frame_len++] = b;
+	if (l->frame_len == l->frame_need) {
+		loader_frame(l, u);
+		l->frame_len = 0;
+	}
+}
+
+void loader_tick(struct loader *l, struct uart *u, int fpga_cts)
+{
+	uint8_t b;
+
+	if (!l->enabled)
+		return;
+
+	if (uart_recv(u, &b) == 1)
+		loader_recv(l, u, b);
+
+	if (l->state == LOADER_LOADING && l->sent < l->app_size) {
+		int outstanding = l->frames_sent - l->frames_acked;
+		int limit = l->window ? 2 * LOAD_WINDOW : 1;
+
+		if (outstanding < limit && l->txpos == l->txlen)
+			loader_send_data(l);
+	}
+
+	if (l->state == LOADER_RXBENCH && l->bench_sent < l->bench_size &&
+	    l->txpos == l->txlen)
+		loader_send_bench(l);
+
+	if (l->state == LOADER_EVBENCH)
+		loader_evbench_tick(l, u);
+
+	// fpga_cts is active low
+	if (l->txpos < l->txlen && !fpga_cts && uart_can_send(u)) {
+		uart_send(u, l->txbuf[l->txpos++]);
+		l->bench_sent_ts = u->ts;
+	}
+
+	// Nothing the app does between blocks takes this long, so it
+	// has stopped reading, like it would if the receive interrupt
+	// was never turned on again after the ring was full.
+	if (l->state == LOADER_RXBENCH && l->bench_sent < l->bench_size &&
+	    u->ts - l->bench_sent_ts > RXBENCH_STALL) {
+		printf("rxbench: stalled after %u of %u bytes\n",
+		       l->bench_sent, l->bench_size);
+		l->state = LOADER_DONE;
+	}
+}
+
 vluint64_t main_time = 0;
 double sc_time_stamp()
 {
@@ -300,6 +1024,10 @@ int main(int argc, char **argv, char **env)
 	Vapplication_fpga_sim top;
 	struct uart u;
 	struct pty p;
+	struct turnaround t;
+	static struct flash f;
+	struct loader l;
+	const char *arg;
 	int err;
 
 	if (signal(SIGUSR1, sighandler) == SIG_ERR)
@@ -313,9 +1041,31 @@ int main(int argc, char **argv, char **env)
 		return -1;
 
 	uart_init(&u, &top.interface_tx, &top.interface_rx, BIT_DIV);
+	turnaround_init(&t, Verilated::commandArgsPlusMatch("turnaround")[0]);
+
+	arg = Verilated::commandArgsPlusMatch("flash=");
+	if (flash_init(&f, arg[0] ? strchr(arg, '=') + 1 : NULL) < 0)
+		return -1;
+
+	arg = Verilated::commandArgsPlusMatch("loadapp=");
+	if (loader_init(&l, arg[0] ? strchr(arg, '=') + 1 : NULL,
+			Verilated::commandArgsPlusMatch("window")[0]) < 0)
+		return -1;
+
+	arg = Verilated::commandArgsPlusMatch("rxbench=");
+	loader_bench(&l, arg[0] ? strtoul(strchr(arg, '=') + 1, NULL, 0) : 0,
+		     Verilated::commandArgsPlusMatch("rxirq")[0],
+		     Verilated::commandArgsPlusMatch("rxfull")[0]);
+
+	arg = Verilated::commandArgsPlusMatch("evbench=");
+	loader_evbench(&l, arg[0] ? strtoul(strchr(arg, '=') + 1, NULL, 0) : 0,
+		       Verilated::commandArgsPlusMatch("evnoyield")[0]);
+
+	loader_console(&l, Verilated::commandArgsPlusMatch("console")[0]);
 
 	top.clk = 0;
-	top.interface_ch552_cts = 1;
+	// CTS is active low, always clear to send to the CPU
+	top.interface_ch552_cts = 0;
 
 	while (!Verilated::gotFinish()) {
 		uint8_t to_host = 0;
@@ -328,9 +1078,18 @@ int main(int argc, char **argv, char **env)
 		if (!top.clk) {
 			touch(&top.touch_event);
 			uart_tick(&u);
+			turnaround_tick(&t, &u);
+			flash_tick(&f, top.spi_ss, top.spi_sck, top.spi_mosi,
+				   &top.spi_miso);
+		}
+
+		if (l.enabled) {
+			loader_tick(&l, &u, top.interface_fpga_cts);
+			goto skip;
 		}
 
-		if (pty_can_recv(&p) && uart_can_send(&u)) {
+		if (pty_can_recv(&p) && uart_can_send(&u) &&
+		    !top.interface_fpga_cts) {
 			uint8_t from_host = 0;
 
 			pty_recv(&p, &from_host);
@@ -12,15 +12,19 @@
 #include <stdint.h>
 #include "blake2s.h"
 
-#define VERBOSE 0
-#define SHOW_V 0
-#define SHOW_M_WORDS 0
+#ifdef BLAKE2S_HW
+#include <tkey/tk1_mem.h>
+#endif
 
-#if VERBOSE || SHOW_V || SHOW_M_WORDS
-#include <stdio.h>
+#ifdef TKEY_PCPI
+#include <tkey/pcpi.h>
 #endif
 
 // Cyclic right rotation.
+#ifdef TKEY_PCPI
+#define ROTR32(x, y)  pcpi_rori((x), (y))
+#endif
+
 #ifndef ROTR32
 #define ROTR32(x, y)  (((x) >> (y)) ^ ((x) << (32 - (y))))
 #endif
@@ -34,6 +38,10 @@
     (((uint32_t) ((uint8_t *) (p))[3]) << 24))
 
 
+// A word that may alias the bytes of the input buffer.
+typedef uint32_t __attribute__((may_alias)) b2s_word;
+
+
 // Initialization Vector.
 static const uint32_t blake2s_iv[8] = {
   0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
@@ -41,113 +49,185 @@ static const uint32_t blake2s_iv[8] = {
 };
 
 
-#if VERBOSE || SHOW_V
+#ifdef BLAKE2S_SMALL
+// Message schedule, only needed when the rounds are not unrolled.
+// The two message words of each G application are packed as the
+// low and high nibble of a byte.
+static const uint8_t blake2s_sigma[10][8] = {
+    {0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe},
+    {0xae, 0x84, 0xf9, 0x6d, 0xc1, 0x20, 0x7b, 0x35},
+    {0x8b, 0x0c, 0x25, 0xdf, 0xea, 0x63, 0x17, 0x49},
+    {0x97, 0x13, 0xcd, 0xeb, 0x62, 0xa5, 0x04, 0x8f},
+    {0x09, 0x75, 0x42, 0xfa, 0x1e, 0xcb, 0x86, 0xd3},
+    {0xc2, 0xa6, 0xb0, 0x38, 0xd4, 0x57, 0xef, 0x91},
+    {0x5c, 0xf1, 0xde, 0xa4, 0x70, 0x36, 0x29, 0xb8},
+    {0xbd, 0xe7, 0x1c, 0x93, 0x05, 0x4f, 0x68, 0xa2},
+    {0xf6, 0x9e, 0x3b, 0x80, 0x2c, 0x7d, 0x41, 0x5a},
+    {0x2a, 0x48, 0x67, 0x51, 0xbf, 0xe9, 0xc3, 0x0d}
+};
+
+// The work variables a, b, c, d of the eight G applications in a
+// round, one nibble each from the least significant one: the four
+// columns and then the four diagonals.
+static const uint16_t blake2s_g_abcd[8] = {
+    0xc840, 0xd951, 0xea62, 0xfb73, 0xfa50, 0xcb61, 0xd872, 0xe943
+};
+#endif
+
+
 //------------------------------------------------------------------
+// The G function. Unrolled it works on the work variables v0..v15
+// in the scope of the caller so that they can stay in registers.
 //------------------------------------------------------------------
-void print_v(uint32_t *v) {
-  printf("0x%08x, 0x%08x, 0x%08x, 0x%08x\n", v[0],  v[1],  v[2],  v[3]);
-  printf("0x%08x, 0x%08x, 0x%08x, 0x%08x\n", v[4],  v[5],  v[6],  v[7]);
-  printf("0x%08x, 0x%08x, 0x%08x, 0x%08x\n", v[8],  v[9],  v[10], v[11]);
-  printf("0x%08x, 0x%08x, 0x%08x, 0x%08x\n", v[12], v[13], v[14], v[15]);
-  printf("\n");
-}
+#define B2S_G(a, b, c, d, x, y)     \
+    do {                            \
+        a = a + b + (x);            \
+        d = ROTR32(d ^ a, 16);      \
+        c = c + d;                  \
+        b = ROTR32(b ^ c, 12);      \
+        a = a + b + (y);            \
+        d = ROTR32(d ^ a, 8);       \
+        c = c + d;                  \
+        b = ROTR32(b ^ c, 7);       \
+    } while (0)
 
 
 //------------------------------------------------------------------
-// print_ctx()
-// Print the contents of the context data structure.
+// One round: G applied on the columns and then the diagonals, with
+// the message words picked by the schedule s0..s15. With constant
+// arguments the whole schedule is resolved at compile time.
+//------------------------------------------------------------------
+#define B2S_ROUND(s0, s1, s2, s3, s4, s5, s6, s7,                \
+                  s8, s9, s10, s11, s12, s13, s14, s15)          \
+    do {                                                         \
+        B2S_G(v0, v4,  v8, v12, m[s0],  m[s1]);                  \
+        B2S_G(v1, v5,  v9, v13, m[s2],  m[s3]);                  \
+        B2S_G(v2, v6, v10, v14, m[s4],  m[s5]);                  \
+        B2S_G(v3, v7, v11, v15, m[s6],  m[s7]);                  \
+        B2S_G(v0, v5, v10, v15, m[s8],  m[s9]);                  \
+        B2S_G(v1, v6, v11, v12, m[s10], m[s11]);                 \
+        B2S_G(v2, v7,  v8, v13, m[s12], m[s13]);                 \
+        B2S_G(v3, v4,  v9, v14, m[s14], m[s15]);                 \
+    } while (0)
+
+
+#ifdef BLAKE2S_HW
+//------------------------------------------------------------------
+// The BLAKE2s core, see core/blake2s in the FPGA design. It is only
+// present from TK1 core version 7. On earlier bitstreams and in
+// QEMU the core is missing and its address range traps, so always
+// check the version first.
 //------------------------------------------------------------------
-void print_ctx(blake2s_ctx *ctx) {
-  printf("Chained state (h):\n");
-  printf("0x%08x, 0x%08x, 0x%08x, 0x%08x, ",
-         ctx->h[0], ctx->h[1], ctx->h[2], ctx->h[3]);
-  printf("0x%08x, 0x%08x, 0x%08x, 0x%08x",
-         ctx->h[4], ctx->h[5], ctx->h[6], ctx->h[7]);
-  printf("\n");
-
-  printf("Byte counter (t):\n");
-  printf("0x%08x, 0x%08x", ctx->t[0], ctx->t[1]);
-  printf("\n");
-
-  printf("\n");
+#define B2S_HW_TK1_VERSION 7
+
+static volatile uint32_t *const b2s_hw_tk1_version =
+    (volatile uint32_t *) TK1_MMIO_TK1_VERSION;
+static volatile uint32_t *const b2s_hw_ctrl =
+    (volatile uint32_t *) TK1_MMIO_BLAKE2S_CTRL;
+static volatile uint32_t *const b2s_hw_status =
+    (volatile uint32_t *) TK1_MMIO_BLAKE2S_STATUS;
+static volatile uint32_t *const b2s_hw_t0 =
+    (volatile uint32_t *) TK1_MMIO_BLAKE2S_T0;
+static volatile uint32_t *const b2s_hw_t1 =
+    (volatile uint32_t *) TK1_MMIO_BLAKE2S_T1;
+static volatile uint32_t *const b2s_hw_h =
+    (volatile uint32_t *) TK1_MMIO_BLAKE2S_H_FIRST;
+static volatile uint32_t *const b2s_hw_block =
+    (volatile uint32_t *) TK1_MMIO_BLAKE2S_BLOCK_FIRST;
+
+
+static int blake2s_hw_present(void)
+{
+    return *b2s_hw_tk1_version >= B2S_HW_TK1_VERSION;
 }
 
-#endif
 
 //------------------------------------------------------------------
-// B2S_G macro redefined as a G function.
-// Allows us to output intermediate values for debugging.
+// Compress the block in the core. The core keeps no state between
+// calls, so interleaved contexts, like the firmware hashing during
+// a system call, work as they do in software.
 //------------------------------------------------------------------
-void G(uint32_t *v, uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t x, uint32_t y) {
-#if VERBOSE
-    printf("G started.\n");
-#endif
+static void blake2s_compress_hw(blake2s_ctx *ctx, int last)
+{
+    const b2s_word *m = (const b2s_word *) ctx->b;
+    int i;
 
-#if SHOW_V
-    printf("v before processing:\n");
-    print_v(&v[0]);
-#endif
+    for (i = 0; i < 8; i++) {
+        b2s_hw_h[i] = ctx->h[i];
+    }
 
-#if SHOW_M_WORDS
-    printf("x: 0x%08x, y: 0x%08x\n", x, y);
-#endif
+    *b2s_hw_t0 = ctx->t[0];
+    *b2s_hw_t1 = ctx->t[1];
 
-  v[a] = v[a] + v[b] + x;
-  v[d] = ROTR32(v[d] ^ v[a], 16);
-  v[c] = v[c] + v[d];
-  v[b] = ROTR32(v[b] ^ v[c], 12);
-  v[a] = v[a] + v[b] + y;
-  v[d] = ROTR32(v[d] ^ v[a], 8);
-  v[c] = v[c] + v[d];
-  v[b] = ROTR32(v[b] ^ v[c], 7);
-
-#if SHOW_V
-    printf("v after processing:\n");
-    print_v(&v[0]);
-#endif
+    for (i = 0; i < 16; i++) {
+        b2s_hw_block[i] = m[i];
+    }
 
-#if VERBOSE
-    printf("G completed.\n\n");
-#endif
+    *b2s_hw_ctrl = 1 << (last ? TK1_MMIO_BLAKE2S_CTRL_LAST_BIT
+                              : TK1_MMIO_BLAKE2S_CTRL_NEXT_BIT);
+
+    while ((*b2s_hw_status & (1 << TK1_MMIO_BLAKE2S_STATUS_READY_BIT)) == 0) {
+    }
+
+    for (i = 0; i < 8; i++) {
+        ctx->h[i] = b2s_hw_h[i];
+    }
 }
 
 
+//------------------------------------------------------------------
+// Clear the state and the block in the core, so nothing of a keyed
+// hash is left behind when it is finalized.
+//------------------------------------------------------------------
+static void blake2s_clear_hw(void)
+{
+    *b2s_hw_ctrl = 1 << TK1_MMIO_BLAKE2S_CTRL_CLEAR_BIT;
+}
+#endif
+
+
 //------------------------------------------------------------------
 // Compression function. "last" flag indicates last block.
+//
+// By default all ten rounds are unrolled. Define BLAKE2S_SMALL to
+// loop over the rounds and the G applications in them with the work
+// variables in an array and the schedule in tables instead, which
+// is a fraction of the size and fits in ROM.
+//
+// With BLAKE2S_HW the BLAKE2s core is used when present.
 //------------------------------------------------------------------
 static void blake2s_compress(blake2s_ctx *ctx, int last)
 {
-    const uint8_t sigma[10][16] = {
-        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
-        {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
-        {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
-        {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
-        {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
-        {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
-        {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
-        {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
-        {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
-        {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0}
-    };
+#ifdef BLAKE2S_HW
+    if (blake2s_hw_present()) {
+        blake2s_compress_hw(ctx, last);
+        return;
+    }
+#endif
 
-    int i;
-    uint32_t v[16], m[16];
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // The input buffer is first in blake2s_ctx, so it is word
+    // aligned and the message words can be loaded right from it.
+    const b2s_word *m = (const b2s_word *) ctx->b;
+#else
+    uint32_t m[16];
 
-#if VERBOSE
-      printf("blake2s_compress started.\n");
+    for (int i = 0; i < 16; i++) {
+        m[i] = B2S_GET32(&ctx->b[4 * i]);
+    }
 #endif
 
+#ifdef BLAKE2S_SMALL
+    uint32_t v[16];
+
     // init work variables
-    for (i = 0; i < 8; i++) {
+    for (int i = 0; i < 8; i++) {
         v[i] = ctx->h[i];
         v[i + 8] = blake2s_iv[i];
     }
 
     // low 32 bits of offset
     // high 32 bits
-#if VERBOSE
-      printf("t[0]: 0x%08x, t[1]: 0x%08x\n", ctx->t[0], ctx->t[1]);
-#endif
     v[12] ^= ctx->t[0];
     v[13] ^= ctx->t[1];
 
@@ -156,56 +236,67 @@ static void blake2s_compress(blake2s_ctx *ctx, int last)
         v[14] = ~v[14];
     }
 
-    // get little-endian words
-    for (i = 0; i < 16; i++) {
-        m[i] = B2S_GET32(&ctx->b[4 * i]);
-    }
-
-#if VERBOSE
-      printf("v before G processing:\n");
-      print_v(&v[0]);
-#endif
+    for (int i = 0; i < 10; i++) {
+        for (int j = 0; j < 8; j++) {
+            uint32_t g = blake2s_g_abcd[j];
+            uint32_t s = blake2s_sigma[i][j];
 
-    // Ten rounds of the G function applied on rows, diagonal.
-    for (i = 0; i < 10; i++) {
-#if VERBOSE
-        printf("Round %02d:\n", (i + 1));
-        printf("Row processing started.\n");
-#endif
-
-      G(&v[0], 0, 4,  8, 12, m[sigma[i][ 0]], m[sigma[i][ 1]]);
-      G(&v[0], 1, 5,  9, 13, m[sigma[i][ 2]], m[sigma[i][ 3]]);
-      G(&v[0], 2, 6, 10, 14, m[sigma[i][ 4]], m[sigma[i][ 5]]);
-      G(&v[0], 3, 7, 11, 15, m[sigma[i][ 6]], m[sigma[i][ 7]]);
+            B2S_G(v[g & 15], v[(g >> 4) & 15], v[(g >> 8) & 15], v[g >> 12],
+                  m[s & 15], m[s >> 4]);
+        }
+    }
 
-#if VERBOSE
-        printf("Row processing completed.\n");
-        printf("Diagonal processing started.\n");
-#endif
+    // Update the hash state.
+    for (int i = 0; i < 8; i++) {
+        ctx->h[i] ^= v[i] ^ v[i + 8];
+    }
+#else
+    uint32_t v0, v1, v2, v3, v4, v5, v6, v7;
+    uint32_t v8, v9, v10, v11, v12, v13, v14, v15;
 
-      G(&v[0], 0, 5, 10, 15, m[sigma[i][ 8]], m[sigma[i][ 9]]);
-      G(&v[0], 1, 6, 11, 12, m[sigma[i][10]], m[sigma[i][11]]);
-      G(&v[0], 2, 7,  8, 13, m[sigma[i][12]], m[sigma[i][13]]);
-      G(&v[0], 3, 4,  9, 14, m[sigma[i][14]], m[sigma[i][15]]);
+    // init work variables
+    v0 = ctx->h[0];
+    v1 = ctx->h[1];
+    v2 = ctx->h[2];
+    v3 = ctx->h[3];
+    v4 = ctx->h[4];
+    v5 = ctx->h[5];
+    v6 = ctx->h[6];
+    v7 = ctx->h[7];
+    v8 = blake2s_iv[0];
+    v9 = blake2s_iv[1];
+    v10 = blake2s_iv[2];
+    v11 = blake2s_iv[3];
 
-#if VERBOSE
-        printf("Diagonal processing completed.\n");
-        printf("\n");
-#endif
-    }
+    // low 32 bits of offset
+    // high 32 bits
+    v12 = blake2s_iv[4] ^ ctx->t[0];
+    v13 = blake2s_iv[5] ^ ctx->t[1];
 
-#if VERBOSE
-      printf("v after G processing:\n");
-      print_v(&v[0]);
-#endif
+    // last block flag set ?
+    v14 = last ? ~blake2s_iv[6] : blake2s_iv[6];
+    v15 = blake2s_iv[7];
+
+    B2S_ROUND( 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15);
+    B2S_ROUND(14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3);
+    B2S_ROUND(11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4);
+    B2S_ROUND( 7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8);
+    B2S_ROUND( 9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13);
+    B2S_ROUND( 2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9);
+    B2S_ROUND(12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11);
+    B2S_ROUND(13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10);
+    B2S_ROUND( 6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5);
+    B2S_ROUND(10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0);
 
     // Update the hash state.
-    for (i = 0; i < 8; ++i) {
-      ctx->h[i] ^= v[i] ^ v[i + 8];
-    }
-
-#if VERBOSE
-      printf("blake2s_compress completed.\n");
+    ctx->h[0] ^= v0 ^ v8;
+    ctx->h[1] ^= v1 ^ v9;
+    ctx->h[2] ^= v2 ^ v10;
+    ctx->h[3] ^= v3 ^ v11;
+    ctx->h[4] ^= v4 ^ v12;
+    ctx->h[5] ^= v5 ^ v13;
+    ctx->h[6] ^= v6 ^ v14;
+    ctx->h[7] ^= v7 ^ v15;
 #endif
 }
 
@@ -220,12 +311,6 @@ int blake2s_init(blake2s_ctx *ctx, size_t outlen,
 {
     size_t i;
 
-#if VERBOSE
-      printf("blake2s_init started.\n");
-      printf("Context before blake2s_init processing:\n");
-      print_ctx(ctx);
-#endif
-
     if (outlen == 0 || outlen > 32 || keylen > 32)
         return -1;                      // illegal parameters
 
@@ -245,12 +330,6 @@ int blake2s_init(blake2s_ctx *ctx, size_t outlen,
         ctx->c = 64;                    // at the end
     }
 
-#if VERBOSE
-      printf("Context after blake2s_init processing:\n");
-      print_ctx(ctx);
-      printf("blake2s_init completed.\n");
-#endif
-
     return 0;
 }
 
@@ -263,12 +342,6 @@ void blake2s_update(blake2s_ctx *ctx,
 {
     size_t i;
 
-#if VERBOSE
-      printf("blake2s_update started.\n");
-      printf("Context before blake2s_update processing:\n");
-      print_ctx(ctx);
-#endif
-
     for (i = 0; i < inlen; i++) {
         if (ctx->c == 64) {             // buffer full ?
             ctx->t[0] += ctx->c;        // add counters
@@ -279,12 +352,6 @@ void blake2s_update(blake2s_ctx *ctx,
         }
         ctx->b[ctx->c++] = ((const uint8_t *) in)[i];
     }
-
-#if VERBOSE
-      printf("Context after blake2s_update processing:\n");
-      print_ctx(ctx);
-      printf("blake2s_update completed.\n");
-#endif
 }
 
 
@@ -296,12 +363,6 @@ void blake2s_final(blake2s_ctx *ctx, void *out)
 {
     size_t i;
 
-#if VERBOSE
-     printf("blake2s_final started.\n");
-     printf("Context before blake2s_final processing:\n");
-     print_ctx(ctx);
-#endif
-
     ctx->t[0] += ctx->c;                // mark last block offset
 
     // carry overflow
@@ -317,17 +378,17 @@ void blake2s_final(blake2s_ctx *ctx, void *out)
     }
     blake2s_compress(ctx, 1);
 
+#ifdef BLAKE2S_HW
+    if (blake2s_hw_present()) {
+        blake2s_clear_hw();
+    }
+#endif
+
     // little endian convert and store
     for (i = 0; i < ctx->outlen; i++) {
         ((uint8_t *) out)[i] =
             (ctx->h[i >> 2] >> (8 * (i & 3))) & 0xFF;
     }
-
-#if VERBOSE
-     printf("Context after blake2s_final processing:\n");
-     print_ctx(ctx);
-     printf("blake2s_final completed.\n");
-#endif
 }
 
 
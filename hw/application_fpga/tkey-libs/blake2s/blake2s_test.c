@@ -6,8 +6,41 @@
 //======================================================================
 
 #include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include "blake2s.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+//------------------------------------------------------------------
+// Cycle counter, or nanoseconds where we don't know how to read one.
+//------------------------------------------------------------------
+#if defined(__x86_64__) || defined(__i386__)
+#define UNIT "cycles"
+static uint64_t now(void) {
+  return __rdtsc();
+}
+#elif defined(__riscv) && __riscv_xlen == 64
+#define UNIT "cycles"
+static uint64_t now(void) {
+  uint64_t c;
+  asm volatile("rdcycle %0" : "=r"(c));
+  return c;
+}
+#else
+#define UNIT "ns"
+static uint64_t now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+#endif
+
 
 //------------------------------------------------------------------
 //------------------------------------------------------------------
@@ -115,6 +148,84 @@ void test_one_block_one_byte_message() {
 }
 
 
+//------------------------------------------------------------------
+// test_known_answer()
+// Check the digest of the RFC 7693 'abc' message. Returns non-zero
+// on mismatch.
+//------------------------------------------------------------------
+int test_known_answer() {
+
+  uint8_t md[32];
+  const uint8_t expected[32] = {
+    0x50, 0x8c, 0x5e, 0x8c, 0x32, 0x7c, 0x14, 0xe2,
+    0xe1, 0xa7, 0x2b, 0xa3, 0x4e, 0xeb, 0x45, 0x2f,
+    0x37, 0x45, 0x8b, 0x20, 0x9e, 0xd6, 0x3a, 0x29,
+    0x4d, 0x99, 0x9b, 0x4c, 0x86, 0x67, 0x59, 0x82
+  };
+
+  blake2s(md, 32, NULL, 0, "abc", 3);
+
+  if (memcmp(md, expected, 32) != 0) {
+    printf("Known answer test FAILED.\n\n");
+    return 1;
+  }
+
+  printf("Known answer test passed.\n\n");
+  return 0;
+}
+
+
+//------------------------------------------------------------------
+// bench()
+// Hash messages of a couple of sizes, up to a whole 128 KiB app
+// like compute_app_digest() in firmware, and print the best time
+// of a number of runs.
+//------------------------------------------------------------------
+void bench() {
+
+  const size_t sizes[] = {32, 64, 128, 1024, 128 * 1024};
+  const int runs = 100;
+  uint8_t md[32];
+  uint8_t *msg;
+
+  msg = malloc(128 * 1024);
+  if (msg == NULL) {
+    return;
+  }
+
+  for (size_t i = 0 ; i < 128 * 1024 ; i++) {
+    msg[i] = i;
+  }
+
+#ifdef BLAKE2S_SMALL
+  printf("Benchmark, BLAKE2S_SMALL:\n");
+#else
+  printf("Benchmark:\n");
+#endif
+
+  for (size_t s = 0 ; s < sizeof(sizes) / sizeof(sizes[0]) ; s++) {
+    uint64_t best = UINT64_MAX;
+
+    for (int r = 0 ; r < runs ; r++) {
+      uint64_t start = now();
+      blake2s(md, 32, NULL, 0, msg, sizes[s]);
+      uint64_t t = now() - start;
+
+      if (t < best) {
+        best = t;
+      }
+    }
+
+    printf("%7zu bytes: %10llu %s, %6.2f %s/byte\n", sizes[s],
+           (unsigned long long) best, UNIT, (double) best / sizes[s],
+           UNIT);
+  }
+  printf("\n");
+
+  free(msg);
+}
+
+
 //------------------------------------------------------------------
 //------------------------------------------------------------------
 int main(void) {
@@ -127,6 +238,12 @@ int main(void) {
   test_one_block_message();
   test_one_block_one_byte_message();
 
+  if (test_known_answer()) {
+    return 1;
+  }
+
+  bench();
+
   printf("BLAKE2s reference model completed.\n");
   printf("\n");
 
@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <blake2s/blake2s.h>
+#include <monocypher/monocypher.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <tkey/lib.h>
+#include <tkey/syscall.h>
+
+#include "eddsa_comb.h"
+
+// Largest read the firmware allows in one system call.
+#define READ_CHUNK 4096
+
+// BLAKE2s-256 digest of the table computed by
+// crypto_eddsa_comb_generate(). It is the same for everyone, so a
+// table read from flash is only used if it matches.
+static const uint8_t comb_digest[32] = {
+    0x7e, 0x3a, 0x1b, 0x19, 0xb0, 0x5c, 0xa5, 0x27, 0x3d, 0x9a, 0x58,
+    0x5b, 0xb2, 0x88, 0x13, 0xd2, 0x6e, 0x61, 0xba, 0x59, 0x1a, 0x07,
+    0xc5, 0x6d, 0x73, 0x9a, 0xe5, 0x0b, 0x1b, 0xa6, 0x6d, 0x9c,
+};
+
+static int comb_check(const crypto_eddsa_comb *comb)
+{
+	uint8_t digest[32];
+
+	if (blake2s(digest, sizeof(digest), NULL, 0, comb, sizeof(*comb)) !=
+	    0) {
+		return -1;
+	}
+
+	return memeq(digest, comb_digest, sizeof(digest)) ? 0 : -1;
+}
+
+// Read the table from the app's flash storage area at byte `offset`
+// into `comb` and check it.
+//
+// Returns 0 on success.
+int eddsa_comb_load(crypto_eddsa_comb *comb, uint32_t offset)
+{
+	uint8_t *buf = (uint8_t *)comb;
+
+	if (sys_alloc() != 0) {
+		return -1;
+	}
+
+	for (size_t i = 0; i < sizeof(*comb); i += READ_CHUNK) {
+		if (sys_read(offset + i, &buf[i], READ_CHUNK) != 0) {
+			return -1;
+		}
+	}
+
+	return comb_check(comb);
+}
+
+// Erase EDDSA_COMB_FLASH_SIZE bytes of the app's flash storage area
+// at byte `offset`, a multiple of 4096, and write the table in `comb`
+// there.
+//
+// Returns 0 on success.
+int eddsa_comb_store(crypto_eddsa_comb *comb, uint32_t offset)
+{
+	if (sys_alloc() != 0) {
+		return -1;
+	}
+
+	if (sys_erase(offset, EDDSA_COMB_FLASH_SIZE) != 0) {
+		return -1;
+	}
+
+	return sys_write(offset, comb, sizeof(*comb));
+}
+
+// Load the table from the app's flash storage area at byte `offset`,
+// or generate it and store it there if it isn't, and use it in
+// Monocypher. Generating takes about as long as a few signatures,
+// loading much less.
+//
+// Needs tkey-libs built with TKEY_EDDSA_COMB=1.
+//
+// Returns 0 on success.
+int eddsa_comb_setup(crypto_eddsa_comb *comb, uint32_t offset)
+{
+#ifdef TKEY_EDDSA_COMB
+	if (eddsa_comb_load(comb, offset) != 0) {
+		crypto_eddsa_comb_generate(comb);
+		if (comb_check(comb) != 0) {
+			return -1;
+		}
+
+		// Still usable if this fails, it is just generated again
+		// next time.
+		(void)eddsa_comb_store(comb, offset);
+	}
+
+	crypto_eddsa_comb_use(comb);
+
+	return 0;
+#else
+	(void)comb;
+	(void)offset;
+
+	return -1;
+#endif
+}
+
+// Have Monocypher stop using the table set up by eddsa_comb_setup(),
+// before its memory is used for something else.
+void eddsa_comb_stop(void)
+{
+#ifdef TKEY_EDDSA_COMB
+	crypto_eddsa_comb_use(NULL);
+#endif
+}
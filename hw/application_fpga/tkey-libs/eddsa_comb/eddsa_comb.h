@@ -0,0 +1,18 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <monocypher/monocypher.h>
+#include <stdint.h>
+
+#ifndef TKEY_EDDSA_COMB_H
+#define TKEY_EDDSA_COMB_H
+
+// Bytes used in the app's flash storage area, a multiple of the 4096
+// bytes sector size.
+#define EDDSA_COMB_FLASH_SIZE 12288
+
+int eddsa_comb_load(crypto_eddsa_comb *comb, uint32_t offset);
+int eddsa_comb_store(crypto_eddsa_comb *comb, uint32_t offset);
+int eddsa_comb_setup(crypto_eddsa_comb *comb, uint32_t offset);
+void eddsa_comb_stop(void);
+#endif
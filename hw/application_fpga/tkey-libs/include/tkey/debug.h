@@ -4,26 +4,41 @@
 #ifndef TKEY_DEBUG_H
 #define TKEY_DEBUG_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "io.h"
 
-#if defined(QEMU_DEBUG)
-#define debug_putchar(ch) putchar(IO_QEMU, ch)
-#define debug_lf() putchar(IO_QEMU, '\n')
-#define debug_putinthex(ch) putinthex(IO_QEMU, ch)
-#define debug_puts(s) puts(IO_QEMU, s)
-#define debug_puthex(ch) puthex(IO_QEMU, ch)
-#define debug_hexdump(buf, len) hexdump(IO_QEMU, buf, len)
+// Log levels. The debug_*() macros print at DEBUG_LEVEL_INFO and up,
+// the trace_*() macros, meant for hot paths, only at
+// DEBUG_LEVEL_TRACE. Below its level a macro expands to nothing.
+#define DEBUG_LEVEL_NONE 0
+#define DEBUG_LEVEL_INFO 1
+#define DEBUG_LEVEL_TRACE 2
 
+#if defined(QEMU_DEBUG)
+#define DEBUG_DEST IO_QEMU
 #elif defined(TKEY_DEBUG)
+#define DEBUG_DEST IO_DEBUG
+#endif
+
+#if defined(DEBUG_DEST)
+#ifndef DEBUG_LEVEL
+#define DEBUG_LEVEL DEBUG_LEVEL_INFO
+#endif
+#else
+#undef DEBUG_LEVEL
+#define DEBUG_LEVEL DEBUG_LEVEL_NONE
+#endif
 
-#define debug_putchar(ch) putchar(IO_DEBUG, ch)
-#define debug_lf() putchar(IO_DEBUG, '\n')
-#define debug_putinthex(ch) putinthex(IO_DEBUG, ch)
-#define debug_puts(s) puts(IO_DEBUG, s)
-#define debug_puthex(ch) puthex(IO_DEBUG, ch)
-#define debug_hexdump(buf, len) hexdump(IO_DEBUG, buf, len)
+#if DEBUG_LEVEL >= DEBUG_LEVEL_INFO
+#define debug_putchar(ch) log_putchar(DEBUG_DEST, ch)
+#define debug_lf() log_putchar(DEBUG_DEST, '\n')
+#define debug_putinthex(ch) log_putinthex(DEBUG_DEST, ch)
+#define debug_puts(s) log_puts(DEBUG_DEST, s)
+#define debug_puthex(ch) log_puthex(DEBUG_DEST, ch)
+#define debug_hexdump(buf, len) log_hexdump(DEBUG_DEST, buf, len)
+#define debug_flush() log_flush()
 
 #else
 
@@ -33,7 +48,35 @@
 #define debug_puts(s)
 #define debug_puthex(ch)
 #define debug_hexdump(buf, len)
+#define debug_flush()
 
 #endif
 
+#if DEBUG_LEVEL >= DEBUG_LEVEL_TRACE
+#define trace_putchar(ch) log_putchar(DEBUG_DEST, ch)
+#define trace_lf() log_putchar(DEBUG_DEST, '\n')
+#define trace_putinthex(ch) log_putinthex(DEBUG_DEST, ch)
+#define trace_puts(s) log_puts(DEBUG_DEST, s)
+#define trace_puthex(ch) log_puthex(DEBUG_DEST, ch)
+#define trace_hexdump(buf, len) log_hexdump(DEBUG_DEST, buf, len)
+
+#else
+
+#define trace_putchar(ch)
+#define trace_lf()
+#define trace_putinthex(n)
+#define trace_puts(s)
+#define trace_puthex(ch)
+#define trace_hexdump(buf, len)
+
+#endif
+
+void log_write(enum ioend dest, const uint8_t *buf, size_t nbytes);
+void log_flush(void);
+void log_putchar(enum ioend dest, const uint8_t ch);
+void log_puthex(enum ioend dest, const uint8_t ch);
+void log_putinthex(enum ioend dest, const uint32_t n);
+void log_puts(enum ioend dest, const char *s);
+void log_hexdump(enum ioend dest, void *buf, int len);
+
 #endif
@@ -0,0 +1,41 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef TKEY_EVENT_H
+#define TKEY_EVENT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tkey/io.h>
+
+// Cooperative event loop. Handlers are called from ev_run() or from
+// ev_yield() in another handler doing long work. Nothing is allocated,
+// timers are owned by the caller.
+
+// Called when there is data from endpoint, len bytes in the current
+// USB Mode Protocol packet. Read it with read() or readview().
+typedef void (*ev_io_fn)(enum ioend endpoint, uint8_t len, void *arg);
+typedef void (*ev_fn)(void *arg);
+
+struct ev_timer {
+	ev_fn fn;
+	void *arg;
+	uint32_t when;	 // ev_now() to run at
+	uint32_t period; // Milliseconds, 0 for one-shot
+	bool active;
+	bool running;
+	struct ev_timer *next;
+};
+
+void ev_init(void);
+uint32_t ev_now(void);
+int ev_io(enum ioend endpoint, ev_io_fn fn, void *arg);
+void ev_timer_start(struct ev_timer *t, uint32_t ms, uint32_t period,
+		    ev_fn fn, void *arg);
+void ev_timer_stop(struct ev_timer *t);
+void ev_touch(ev_fn fn, void *arg);
+void ev_yield(void);
+void ev_run(void);
+void ev_stop(void);
+
+#endif
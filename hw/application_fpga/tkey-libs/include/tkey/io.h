@@ -28,15 +28,40 @@ enum ch552cmd {
 	CH552_CMD_MAX,
 };
 
+// Size of the receive ring, a power of two.
+#define UART_RX_RING_SIZE 4096
+
+// Receive ring filled by firmware on the UART receive interrupt. head
+// is written by firmware, tail by us. Both are free-running.
+//
+// Firmware uses this definition as well, see uart_irq.c in firmware.
+struct uart_rx_ring {
+	volatile uint32_t head;
+	volatile uint32_t tail;
+	uint8_t buf[UART_RX_RING_SIZE];
+};
+
+// A segment for writev()
+struct iovec {
+	const void *iov_base;
+	size_t iov_len;
+};
+
 void write(enum ioend dest, const uint8_t *buf, size_t nbytes);
+void writev(enum ioend dest, const struct iovec *iov, int iovcnt);
 int read(enum ioend src, uint8_t *buf, size_t bufsize, size_t nbytes);
+int readfull(enum ioend src, uint8_t *buf, size_t bufsize, size_t nbytes);
 int uart_read(uint8_t *buf, size_t bufsize, size_t nbytes);
 int readselect(int bitmask, enum ioend *endpoint, uint8_t *len);
+int readpoll(int bitmask, enum ioend *endpoint, uint8_t *len);
+int readview(enum ioend src, const uint8_t **data, uint8_t *len);
+void release(void);
 void putchar(enum ioend dest, const uint8_t ch);
 void puthex(enum ioend dest, const uint8_t ch);
 void putinthex(enum ioend dest, const uint32_t n);
 void puts(enum ioend dest, const char *s);
 void hexdump(enum ioend dest, void *buf, int len);
 void config_endpoints(uint8_t endpoints);
+void uart_rx_irq_enable(struct uart_rx_ring *ring);
 
 #endif
@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <stdint.h>
+
+#ifndef TKEY_PCPI_H
+#define TKEY_PCPI_H
+
+// Instructions of the pcpi_ext co-processor next to the CPU, from TK1
+// version 8. They are not known by QEMU.
+//
+// ror, rol and rori are encoded as in the Zbb extension. The
+// multiply-accumulate instructions use the custom-1 opcode and work
+// on a 64 bit accumulator in the co-processor. The accumulator is not
+// saved on interrupts or system calls, so a sum has to be done before
+// anything else might use it.
+//
+// The instructions are emitted with .insn so no change of -march is
+// needed. Multiply-accumulate, opcode 0x2b and funct7 0:
+//
+//   funct3  name    operation
+//   ------------------------------------------
+//   0       mac     acc += (int32)rs1 * (int32)rs2
+//   1       macu    acc += (uint32)rs1 * (uint32)rs2
+//   2       macset  acc = rs2:rs1
+//   4       maclo   rd = acc[31:0]
+//   5       machi   rd = acc[63:32]
+
+// Rotate right by the low five bits of n.
+static inline __attribute__((always_inline)) uint32_t pcpi_ror(uint32_t x,
+							       uint32_t n)
+{
+	uint32_t r;
+
+	__asm__(".insn r 0x33, 5, 0x30, %0, %1, %2"
+		: "=r"(r)
+		: "r"(x), "r"(n));
+
+	return r;
+}
+
+// Rotate left by the low five bits of n.
+static inline __attribute__((always_inline)) uint32_t pcpi_rol(uint32_t x,
+							       uint32_t n)
+{
+	uint32_t r;
+
+	__asm__(".insn r 0x33, 1, 0x30, %0, %1, %2"
+		: "=r"(r)
+		: "r"(x), "r"(n));
+
+	return r;
+}
+
+// Rotate right by n, which must be a constant 0..31.
+static inline __attribute__((always_inline)) uint32_t pcpi_rori(uint32_t x,
+								const uint32_t n)
+{
+	uint32_t r;
+
+	__asm__(".insn i 0x13, 5, %0, %1, %2"
+		: "=r"(r)
+		: "r"(x), "i"(0x600 | (n & 31)));
+
+	return r;
+}
+
+// Rotate left by n, which must be a constant 0..31.
+static inline __attribute__((always_inline)) uint32_t pcpi_roli(uint32_t x,
+								const uint32_t n)
+{
+	return pcpi_rori(x, (32 - n) & 31);
+}
+
+// Set the accumulator.
+static inline __attribute__((always_inline)) void pcpi_mac_set(int64_t acc)
+{
+	uint32_t lo = (uint32_t)acc;
+	uint32_t hi = (uint32_t)((uint64_t)acc >> 32);
+
+	__asm__ volatile(".insn r 0x2b, 2, 0, zero, %0, %1"
+			 :
+			 : "r"(lo), "r"(hi));
+}
+
+// Add the signed product a * b to the accumulator.
+static inline __attribute__((always_inline)) void pcpi_mac(int32_t a,
+							   int32_t b)
+{
+	__asm__ volatile(".insn r 0x2b, 0, 0, zero, %0, %1"
+			 :
+			 : "r"(a), "r"(b));
+}
+
+// Add the unsigned product a * b to the accumulator.
+static inline __attribute__((always_inline)) void pcpi_macu(uint32_t a,
+							    uint32_t b)
+{
+	__asm__ volatile(".insn r 0x2b, 1, 0, zero, %0, %1"
+			 :
+			 : "r"(a), "r"(b));
+}
+
+// Get the accumulator.
+static inline __attribute__((always_inline)) int64_t pcpi_mac_get(void)
+{
+	uint32_t lo;
+	uint32_t hi;
+
+	__asm__ volatile(".insn r 0x2b, 4, 0, %0, zero, zero" : "=r"(lo));
+	__asm__ volatile(".insn r 0x2b, 5, 0, %0, zero, zero" : "=r"(hi));
+
+	return (int64_t)(((uint64_t)hi << 32) | lo);
+}
+
+#endif
@@ -1,8 +1,10 @@
 // SPDX-FileCopyrightText: 2022 Tillitis AB <tillitis.se>
 // SPDX-License-Identifier: BSD-2-Clause
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <tkey/io.h>
 
 #ifndef TKEY_PROTO_H
 #define TKEY_PROTO_H
@@ -34,6 +36,34 @@ struct frame_header {
 	size_t len;
 };
 
+// A frame being read. Keeps the header and command between calls to
+// frame_reader_feed() so a frame can arrive in several USB packets.
+struct frame_reader {
+	struct frame_header hdr;
+	uint8_t cmd[CMDLEN_MAXBYTES];
+	size_t len;    // Command bytes read so far
+	bool have_hdr; // In the middle of a frame
+};
+
+// Called by frame_dispatch() with the whole command, cmd[0] being the
+// command code.
+typedef void (*frame_cmd_fn)(const struct frame_header *hdr,
+			     const uint8_t *cmd, size_t len, void *arg);
+
+struct frame_cmd {
+	uint8_t code;
+	frame_cmd_fn fn;
+};
+
 uint8_t genhdr(uint8_t id, uint8_t endpoint, uint8_t status, enum cmdlen len);
 int parseframe(uint8_t b, struct frame_header *hdr);
+void frame_reader_init(struct frame_reader *r);
+int frame_reader_feed(struct frame_reader *r, enum ioend src, uint8_t avail);
+int readframe(struct frame_reader *r, enum ioend src);
+int frame_dispatch(const struct frame_cmd *cmds, size_t ncmds,
+		   const struct frame_reader *r, void *arg);
+void frame_reply(enum ioend dest, const struct frame_header *hdr,
+		 enum cmdlen len, uint8_t rspcode, const void *buf,
+		 size_t buflen);
+void frame_reply_nok(enum ioend dest, const struct frame_header *hdr);
 #endif
@@ -43,8 +43,22 @@ enum syscall_num {
 	TK1_SYSCALL_REG_MGMT = 12,
 	TK1_SYSCALL_STATUS = 13,
 	TK1_SYSCALL_GET_APP_DATA = 14,
+	TK1_SYSCALL_GET_BOOT_TRACE = 17,
+	TK1_SYSCALL_UART_RX_RING = 18,
 };
 
+// Needs to be held synchronized with boot_trace.h in firmware.
+// Timestamps are cycles since start of firmware, 0 if never reached.
+struct boot_trace {
+	uint32_t state[7]; // First entry into each firmware state
+	uint32_t scrambled;
+	uint32_t part_table_read;
+	uint32_t cdi_done;
+	uint32_t jump;
+};
+
+struct uart_rx_ring;
+
 int syscall(uint32_t number, uint32_t arg1, uint32_t arg2, uint32_t arg3);
 int sys_reset(struct reset *rst, size_t len);
 int sys_reset_data(uint8_t next_app_data[RESET_DATA_SIZE]);
@@ -60,4 +74,6 @@ int sys_preload_store_fin(size_t len, uint8_t digest[32],
 			  uint8_t signature[64]);
 int sys_get_digsig(uint8_t digest[32], uint8_t signature[64]);
 int sys_status(void);
+int sys_get_boot_trace(struct boot_trace *trace);
+int sys_uart_rx_ring(struct uart_rx_ring *ring);
 #endif
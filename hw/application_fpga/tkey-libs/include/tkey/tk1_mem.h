@@ -49,6 +49,7 @@
   UDS		0xc2
   UART		0xc3
   TOUCH		0xc4
+  BLAKE2S	0xc5
   FW_RAM	0xd0
   QEMU		0xfe   Not used in real hardware
   TK1		0xff
@@ -92,13 +93,35 @@
 #define TK1_MMIO_UART_RX_STATUS 0xc3000080
 #define TK1_MMIO_UART_RX_DATA 0xc3000084
 #define TK1_MMIO_UART_RX_BYTES 0xc3000088
+#define TK1_MMIO_UART_RX_IRQ 0xc300008c
 #define TK1_MMIO_UART_TX_STATUS 0xc3000100
 #define TK1_MMIO_UART_TX_DATA 0xc3000104
+#define TK1_MMIO_UART_TX_FREE 0xc3000108
+#define TK1_UART_TX_FIFO_SIZE 511
 
 #define TK1_MMIO_TOUCH_BASE 0xc4000000
 #define TK1_MMIO_TOUCH_STATUS 0xc4000024
 #define TK1_MMIO_TOUCH_STATUS_EVENT_BIT 0
 
+#define TK1_MMIO_BLAKE2S_BASE 0xc5000000
+#define TK1_MMIO_BLAKE2S_NAME0 0xc5000000
+#define TK1_MMIO_BLAKE2S_NAME1 0xc5000004
+#define TK1_MMIO_BLAKE2S_VERSION 0xc5000008
+#define TK1_MMIO_BLAKE2S_CTRL 0xc5000020
+#define TK1_MMIO_BLAKE2S_CTRL_NEXT_BIT 0
+#define TK1_MMIO_BLAKE2S_CTRL_LAST_BIT 1
+#define TK1_MMIO_BLAKE2S_CTRL_CLEAR_BIT 2
+#define TK1_MMIO_BLAKE2S_STATUS 0xc5000024
+#define TK1_MMIO_BLAKE2S_STATUS_READY_BIT 0
+#define TK1_MMIO_BLAKE2S_T0 0xc5000040
+#define TK1_MMIO_BLAKE2S_T1 0xc5000044
+// 8 words of chained state, h[0] first
+#define TK1_MMIO_BLAKE2S_H_FIRST 0xc5000080
+#define TK1_MMIO_BLAKE2S_H_LAST 0xc500009c
+// 16 words of message block, write only
+#define TK1_MMIO_BLAKE2S_BLOCK_FIRST 0xc5000100
+#define TK1_MMIO_BLAKE2S_BLOCK_LAST 0xc500013c
+
 // This only exists in QEMU, not real hardware
 #define TK1_MMIO_QEMU_BASE 0xfe000000
 #define TK1_MMIO_QEMU_DEBUG 0xfe001000
@@ -135,6 +158,9 @@
 // Deprecated - use _DATA_RAND instead
 #define TK1_MMIO_TK1_RAM_SCRAMBLE 0xff000104
 #define TK1_MMIO_TK1_RAM_DATA_RAND 0xff000104
+#define TK1_MMIO_TK1_RAM_FILL_ACC 0xff000108
+#define TK1_MMIO_TK1_RAM_FILL 0xff00010c
+#define TK1_MMIO_TK1_RAM_FILL_BUSY_BIT 0
 
 #define TK1_MMIO_TK1_CPU_MON_CTRL 0xff000180
 #define TK1_MMIO_TK1_CPU_MON_FIRST 0xff000184
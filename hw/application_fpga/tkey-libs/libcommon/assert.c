@@ -5,9 +5,16 @@
 #include <tkey/io.h>
 #include <tkey/lib.h>
 
+// See debug.c
+extern void log_flush(void) __attribute__((weak));
+
 void assert_fail(enum ioend dest, const char *assertion, const char *file,
 		 unsigned int line, const char *function)
 {
+	if (log_flush != NULL) {
+		log_flush();
+	}
+
 	puts(dest, "assert: ");
 	puts(dest, assertion);
 	puts(dest, " ");
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <stddef.h>
+#include <stdint.h>
+#include <tkey/debug.h>
+#include <tkey/io.h>
+#include <tkey/lib.h>
+
+// Buffered debug output, used by the debug_*() and trace_*() macros in
+// debug.h.
+//
+// Output is collected until we have a full USB Mode Protocol packet of
+// 64 bytes, so many small prints end up as a few full packets instead
+// of one short packet each. What is left is sent by log_flush(), which
+// is also called automatically by readfull() and readselect() before
+// they wait for input, and by assert_fail().
+//
+// Output to IO_QEMU isn't packetized so it isn't buffered.
+#define LOG_BUFSIZE 64
+
+static struct {
+	enum ioend dest;
+	uint8_t len;
+	uint8_t buf[LOG_BUFSIZE];
+} logbuf;
+
+void log_flush(void)
+{
+	if (logbuf.len > 0) {
+		write(logbuf.dest, logbuf.buf, logbuf.len);
+		logbuf.len = 0;
+	}
+}
+
+void log_write(enum ioend dest, const uint8_t *buf, size_t nbytes)
+{
+	if (dest == IO_QEMU) {
+		write(dest, buf, nbytes);
+		return;
+	}
+
+	if (dest != logbuf.dest) {
+		log_flush();
+		logbuf.dest = dest;
+	}
+
+	while (nbytes > 0) {
+		size_t n = sizeof(logbuf.buf) - logbuf.len;
+
+		if (n > nbytes) {
+			n = nbytes;
+		}
+
+		memcpy(&logbuf.buf[logbuf.len], buf, n);
+		logbuf.len += n;
+		buf += n;
+		nbytes -= n;
+
+		if (logbuf.len == sizeof(logbuf.buf)) {
+			log_flush();
+		}
+	}
+}
+
+void log_putchar(enum ioend dest, const uint8_t ch)
+{
+	log_write(dest, &ch, 1);
+}
+
+static void hex(uint8_t buf[2], const uint8_t c)
+{
+	unsigned int upper = (c >> 4) & 0xf;
+	unsigned int lower = c & 0xf;
+
+	buf[0] = upper < 10 ? '0' + upper : 'a' - 10 + upper;
+	buf[1] = lower < 10 ? '0' + lower : 'a' - 10 + lower;
+}
+
+void log_puthex(enum ioend dest, const uint8_t ch)
+{
+	uint8_t hexbuf[2] = {0};
+
+	hex(hexbuf, ch);
+	log_write(dest, hexbuf, 2);
+}
+
+void log_putinthex(enum ioend dest, const uint32_t n)
+{
+	log_puts(dest, "0x");
+
+	for (int shift = 24; shift >= 0; shift -= 8) {
+		log_puthex(dest, n >> shift);
+	}
+}
+
+void log_puts(enum ioend dest, const char *s)
+{
+	log_write(dest, (const uint8_t *)s, strlen(s));
+}
+
+void log_hexdump(enum ioend dest, void *buf, int len)
+{
+	uint8_t *byte_buf = (uint8_t *)buf;
+
+	for (int i = 0; i < len; i++) {
+		log_puthex(dest, byte_buf[i]);
+		log_putchar(dest, ' ');
+
+		// 16 bytes per row
+		if (i % 16 == 15 || i == len - 1) {
+			log_putchar(dest, '\n');
+		}
+	}
+}
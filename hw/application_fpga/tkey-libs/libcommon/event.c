@@ -0,0 +1,257 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <tkey/assert.h>
+#include <tkey/event.h>
+#include <tkey/io.h>
+#include <tkey/lib.h>
+#include <tkey/tk1_mem.h>
+
+// CPU clock frequency in Hz, the same as in uart.v
+#define CPUFREQ 24000000
+
+// clang-format off
+static volatile uint32_t *timer           = (volatile uint32_t *)TK1_MMIO_TIMER_TIMER;
+static volatile uint32_t *timer_prescaler = (volatile uint32_t *)TK1_MMIO_TIMER_PRESCALER;
+static volatile uint32_t *timer_ctrl      = (volatile uint32_t *)TK1_MMIO_TIMER_CTRL;
+static volatile uint32_t *touch           = (volatile uint32_t *)TK1_MMIO_TOUCH_STATUS;
+// clang-format on
+
+// The endpoints we can have handlers for
+#define EV_ENDPOINTS 4
+
+struct ev_io_handler {
+	enum ioend endpoint;
+	ev_io_fn fn;
+	void *arg;
+};
+
+static struct {
+	struct ev_io_handler io[EV_ENDPOINTS];
+	int io_mask;  // Endpoints with a handler
+	int io_busy;  // Endpoints with a handler running
+	struct ev_timer *timers;
+	ev_fn touch_fn;
+	void *touch_arg;
+	bool touch_busy;
+	bool running;
+} ev;
+
+// ev_init starts the timer, counting milliseconds, and forgets all
+// handlers. The event loop owns the timer, so touch_wait() can't be
+// used together with it. Use ev_touch() and a timer instead.
+void ev_init(void)
+{
+	*timer_ctrl = (1 << TK1_MMIO_TIMER_CTRL_STOP_BIT);
+	*timer_prescaler = CPUFREQ / 1000;
+	*timer = 0xffffffff;
+	*timer_ctrl = (1 << TK1_MMIO_TIMER_CTRL_START_BIT);
+
+	// Forget any stray touch events
+	*touch = 0;
+
+	memset(&ev, 0, sizeof(ev));
+}
+
+// ev_now returns milliseconds since ev_init().
+uint32_t ev_now(void)
+{
+	return 0xffffffff - *timer;
+}
+
+// ev_io sets fn to be called with arg when there is data from
+// endpoint: IO_CDC, IO_FIDO, IO_CCID or IO_DEBUG. A NULL fn removes
+// the handler. Data for endpoints without a handler is discarded.
+//
+// The handler should read what it is told is available. If it doesn't
+// it is called again for the rest.
+//
+// Returns non-zero on error.
+int ev_io(enum ioend endpoint, ev_io_fn fn, void *arg)
+{
+	struct ev_io_handler *h = NULL;
+
+	if (endpoint != IO_CDC && endpoint != IO_FIDO &&
+	    endpoint != IO_CCID && endpoint != IO_DEBUG) {
+		return -1;
+	}
+
+	for (int i = 0; i < EV_ENDPOINTS; i++) {
+		if (ev.io[i].endpoint == endpoint) {
+			h = &ev.io[i];
+			break;
+		}
+
+		if (h == NULL && ev.io[i].endpoint == IO_NONE) {
+			h = &ev.io[i];
+		}
+	}
+
+	if (h == NULL) {
+		return -1;
+	}
+
+	if (fn == NULL) {
+		h->endpoint = IO_NONE;
+		ev.io_mask &= ~endpoint;
+
+		return 0;
+	}
+
+	h->endpoint = endpoint;
+	h->fn = fn;
+	h->arg = arg;
+	ev.io_mask |= endpoint;
+
+	return 0;
+}
+
+// ev_timer_start runs fn with arg in ms milliseconds, and then every
+// period milliseconds if period isn't 0. t must be kept until the
+// timer is stopped or has run, if it is one-shot.
+void ev_timer_start(struct ev_timer *t, uint32_t ms, uint32_t period,
+		    ev_fn fn, void *arg)
+{
+	ev_timer_stop(t);
+
+	t->fn = fn;
+	t->arg = arg;
+	t->when = ev_now() + ms;
+	t->period = period;
+	t->active = true;
+	t->running = false;
+	t->next = ev.timers;
+	ev.timers = t;
+}
+
+void ev_timer_stop(struct ev_timer *t)
+{
+	for (struct ev_timer **p = &ev.timers; *p != NULL; p = &(*p)->next) {
+		if (*p == t) {
+			*p = t->next;
+			break;
+		}
+	}
+
+	t->active = false;
+	t->next = NULL;
+}
+
+// ev_touch sets fn to be called with arg when the touch sensor is
+// touched. A NULL fn removes it.
+void ev_touch(ev_fn fn, void *arg)
+{
+	ev.touch_fn = fn;
+	ev.touch_arg = arg;
+}
+
+static void ev_run_timers(void)
+{
+	uint32_t now = ev_now();
+	struct ev_timer *t = ev.timers;
+
+	while (t != NULL) {
+		struct ev_timer *next = t->next;
+
+		if (!t->running && (int32_t)(now - t->when) >= 0) {
+			if (t->period != 0) {
+				t->when += t->period;
+			} else {
+				ev_timer_stop(t);
+			}
+
+			t->running = true;
+			t->fn(t->arg);
+			t->running = false;
+
+			// The list may have changed, start over next
+			// time.
+			return;
+		}
+
+		t = next;
+	}
+}
+
+static void ev_run_touch(void)
+{
+	if (ev.touch_fn == NULL || ev.touch_busy) {
+		return;
+	}
+
+	if ((*touch & (1 << TK1_MMIO_TOUCH_STATUS_EVENT_BIT)) == 0) {
+		return;
+	}
+
+	// Confirm touch event
+	*touch = 0;
+
+	ev.touch_busy = true;
+	ev.touch_fn(ev.touch_arg);
+	ev.touch_busy = false;
+}
+
+static void ev_run_io(void)
+{
+	enum ioend endpoint = IO_NONE;
+	uint8_t len = 0;
+
+	if (ev.io_mask == 0) {
+		return;
+	}
+
+	if (readpoll(ev.io_mask, &endpoint, &len) != 0) {
+		return;
+	}
+
+	if (ev.io_busy & endpoint) {
+		// The handler for this endpoint is already running
+		// and has yielded. The packet waits for it to
+		// return, and so does everything after it.
+		return;
+	}
+
+	for (int i = 0; i < EV_ENDPOINTS; i++) {
+		if (ev.io[i].endpoint == endpoint) {
+			ev.io_busy |= endpoint;
+			ev.io[i].fn(endpoint, len, ev.io[i].arg);
+			ev.io_busy &= ~endpoint;
+
+			return;
+		}
+	}
+
+	assert(1 == 2);
+}
+
+// ev_yield runs the handlers that are ready, once, without blocking.
+// Handlers doing long work call it every now and then to let other
+// events be served. A handler is never run again while it is already
+// running.
+//
+// Note that a view from readview() is released by any handler
+// reading, so don't keep one over ev_yield().
+void ev_yield(void)
+{
+	ev_run_io();
+	ev_run_timers();
+	ev_run_touch();
+}
+
+// ev_run runs handlers as events happen until ev_stop().
+void ev_run(void)
+{
+	ev.running = true;
+
+	while (ev.running) {
+		ev_yield();
+	}
+}
+
+void ev_stop(void)
+{
+	ev.running = false;
+}
@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
 // SPDX-License-Identifier: BSD-2-Clause
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <tkey/assert.h>
 #include <tkey/debug.h>
@@ -23,33 +24,68 @@
 static void hex(uint8_t buf[2], const uint8_t c);
 static int discard(size_t nbytes);
 static uint8_t readbyte(void);
-static void writebyte(uint8_t b);
+static void writebytes(const uint8_t *buf, size_t nbytes);
 
 struct usb_mode {
 	enum ioend endpoint; // Current USB endpoint with data
 	uint8_t len;	     // Data available in from current USB mode.
 };
 
+// Flushes buffered debug output, see debug.c. Weak, so debug.o is only
+// linked in if something logs.
+extern void log_flush(void) __attribute__((weak));
+
 static struct usb_mode cur_endpoint = {
     IO_NONE,
     0,
 };
 
+// The data handed out by readview(), kept until release().
+struct view {
+	const uint8_t *data;
+	uint8_t len;
+	bool in_ring; // Points into the receive ring, not viewbuf
+};
+
+static struct view cur_view = {NULL, 0, false};
+static uint8_t viewbuf[255];
+
 // clang-format off
 static volatile uint32_t* const can_rx  = (volatile uint32_t *)TK1_MMIO_UART_RX_STATUS;
 static volatile uint32_t* const rx      = (volatile uint32_t *)TK1_MMIO_UART_RX_DATA;
+static volatile uint32_t* const rxbytes = (volatile uint32_t *)TK1_MMIO_UART_RX_BYTES;
+static volatile uint32_t* const rx_irq  = (volatile uint32_t *)TK1_MMIO_UART_RX_IRQ;
 static volatile uint32_t* const can_tx  = (volatile uint32_t *)TK1_MMIO_UART_TX_STATUS;
 static volatile uint32_t* const tx      = (volatile uint32_t *)TK1_MMIO_UART_TX_DATA;
+static volatile uint32_t* const tx_free = (volatile uint32_t *)TK1_MMIO_UART_TX_FREE;
 static volatile uint8_t*  const debugtx = (volatile uint8_t *)TK1_MMIO_QEMU_DEBUG;
 // clang-format on
 
-// writebyte blockingly writes byte b to UART
-static void writebyte(uint8_t b)
+// Receive ring filled by firmware on the UART receive interrupt, NULL
+// if we read the UART directly. See uart_rx_irq_enable().
+static struct uart_rx_ring *rx_ring = NULL;
+
+// writebytes blockingly writes nbytes of buf to UART. As many bytes as
+// the UART transmit FIFO has room for are written for every status
+// read.
+static void writebytes(const uint8_t *buf, size_t nbytes)
 {
-	for (;;) {
-		if (*can_tx) {
-			*tx = b;
-			return;
+	while (nbytes > 0) {
+		size_t n = *tx_free;
+
+		if (n == 0 && *can_tx) {
+			// Hardware without the free count, like
+			// QEMU. One byte at a time.
+			n = 1;
+		}
+
+		if (n > nbytes) {
+			n = nbytes;
+		}
+
+		nbytes -= n;
+		while (n-- > 0) {
+			*tx = *buf++;
 		}
 	}
 }
@@ -62,13 +98,10 @@ static void write_with_header(enum ioend dest, const uint8_t *buf,
 	// USB Mode Protocol header:
 	//   1 byte mode
 	//   1 byte length
+	uint8_t hdr[2] = {dest, nbytes};
 
-	writebyte(dest);
-	writebyte(nbytes);
-
-	for (int i = 0; i < nbytes; i++) {
-		writebyte(buf[i]);
-	}
+	writebytes(hdr, sizeof(hdr));
+	writebytes(buf, nbytes);
 }
 
 // write blockingly writes nbytes bytes of data from buf to dest which
@@ -98,9 +131,7 @@ void write(enum ioend dest, const uint8_t *buf, size_t nbytes)
 
 		return;
 	} else if (dest == IO_UART) {
-		for (int i = 0; i < nbytes; i++) {
-			writebyte(buf[i]);
-		}
+		writebytes(buf, nbytes);
 
 		return;
 	}
@@ -119,9 +150,129 @@ void write(enum ioend dest, const uint8_t *buf, size_t nbytes)
 	}
 }
 
+// writev blockingly writes the iovcnt segments in iov to dest, as if
+// they were one buffer. Same destinations as write().
+//
+// The USB Mode Protocol packets are filled up to the full 64 bytes
+// across segment boundaries. Nothing is copied on the way.
+void writev(enum ioend dest, const struct iovec *iov, int iovcnt)
+{
+	size_t total = 0;
+	size_t off = 0; // Offset in current segment
+
+	if (dest == IO_QEMU || dest == IO_UART) {
+		for (int i = 0; i < iovcnt; i++) {
+			write(dest, iov[i].iov_base, iov[i].iov_len);
+		}
+
+		return;
+	}
+
+	for (int i = 0; i < iovcnt; i++) {
+		total += iov[i].iov_len;
+	}
+
+	while (total > 0) {
+		uint8_t len =
+		    total < USBMODE_PACKET_SIZE ? total : USBMODE_PACKET_SIZE;
+		uint8_t hdr[2] = {dest, len};
+
+		writebytes(hdr, sizeof(hdr));
+		total -= len;
+
+		while (len > 0) {
+			size_t n = iov->iov_len - off;
+
+			if (n > len) {
+				n = len;
+			}
+
+			writebytes((const uint8_t *)iov->iov_base + off, n);
+			off += n;
+			len -= n;
+
+			if (off == iov->iov_len) {
+				iov++;
+				off = 0;
+			}
+		}
+	}
+}
+
+// uart_rx_irq_enable starts reading through the receive ring, filled
+// by firmware on the UART receive interrupt, instead of polling the
+// UART. All reading functions then take bytes from memory, so data
+// keeps coming in while the app is busy doing something else.
+//
+// The ring must first be registered with firmware, like:
+//
+//   static struct uart_rx_ring ring;
+//
+//   if (sys_uart_rx_ring(&ring) != 0) {
+//           // Firmware without UART receive interrupt support
+//   }
+//   uart_rx_irq_enable(&ring);
+//
+// Every interrupt overwrites x3 (gp) and zeroes x4 (tp) between any
+// two instructions of the app, so the app must never use them. Build
+// with -mno-relax and don't use thread local storage. See README.md.
+void uart_rx_irq_enable(struct uart_rx_ring *ring)
+{
+	uint32_t mask = 0x3fffffff; // Unmask IRQ30 and IRQ31
+
+	rx_ring = ring;
+	*rx_irq = 1;
+
+	// picorv32_maskirq_insn(zero, mask), see custom_ops.S in
+	// picorv32.
+	asm volatile(".insn r 0x0b, 6, 3, zero, %0, zero" : : "r"(mask));
+}
+
+// rx_available returns how many bytes can be read right now.
+static uint32_t rx_available(void)
+{
+	if (rx_ring != NULL) {
+		return rx_ring->head - rx_ring->tail;
+	}
+
+	return *rxbytes;
+}
+
+// rx_ring_consume marks the next nbytes of the receive ring as read.
+static void rx_ring_consume(uint32_t nbytes)
+{
+	rx_ring->tail += nbytes;
+
+	// Firmware stops the interrupt when the ring is full, which
+	// may have happened at any time before tail was moved. Look
+	// at the interrupt itself, not at the fill level we saw
+	// before, and start it again now that there is room.
+	if (*rx_irq == 0) {
+		*rx_irq = 1;
+	}
+}
+
+// rx_ring_byte takes the next byte from the receive ring. There must
+// be one available.
+static uint8_t rx_ring_byte(void)
+{
+	uint8_t b = rx_ring->buf[rx_ring->tail % UART_RX_RING_SIZE];
+
+	rx_ring_consume(1);
+
+	return b;
+}
+
 // readbyte reads a byte from UART and returns it. Blocking.
 static uint8_t readbyte(void)
 {
+	if (rx_ring != NULL) {
+		while (rx_ring->head == rx_ring->tail) {
+		}
+
+		return rx_ring_byte();
+	}
+
 	for (;;) {
 		if (*can_rx) {
 			return *rx;
@@ -137,6 +288,8 @@ static uint8_t readbyte(void)
 // Returns the number of bytes read. Empty data returns 0.
 int read(enum ioend src, uint8_t *buf, size_t bufsize, size_t nbytes)
 {
+	release();
+
 	if (buf == NULL || nbytes > bufsize) {
 		return -1;
 	}
@@ -161,12 +314,80 @@ int read(enum ioend src, uint8_t *buf, size_t bufsize, size_t nbytes)
 	return n;
 }
 
+// readfull reads exactly nbytes into buf of size bufsize from the src
+// USB endpoint. Blocking. Unlike read() it doesn't need readselect()
+// first: it reads USB Mode Protocol headers itself and discards data
+// for other endpoints.
+//
+// The UART FIFO, or the receive ring, is drained in bursts of as many
+// bytes as it reports it has, so there is no status poll for every
+// byte.
+//
+// Returns the number of bytes read, or negative on error.
+int readfull(enum ioend src, uint8_t *buf, size_t bufsize, size_t nbytes)
+{
+	size_t n = 0;
+
+	release();
+	if (log_flush != NULL) {
+		log_flush();
+	}
+
+	if (buf == NULL || nbytes > bufsize) {
+		return -1;
+	}
+
+	if (src == IO_NONE || src == IO_UART || src == IO_QEMU) {
+		// Destination only endpoints
+		return -1;
+	}
+
+	while (n < nbytes) {
+		if (cur_endpoint.len == 0) {
+			// Read USB Mode Protocol header:
+			//   1 byte mode
+			//   1 byte length
+			cur_endpoint.endpoint = readbyte();
+			cur_endpoint.len = readbyte();
+			continue;
+		}
+
+		if (cur_endpoint.endpoint != src) {
+			(void)discard(cur_endpoint.len);
+			continue;
+		}
+
+		size_t burst = rx_available();
+		if (burst > cur_endpoint.len) {
+			burst = cur_endpoint.len;
+		}
+		if (burst > nbytes - n) {
+			burst = nbytes - n;
+		}
+
+		cur_endpoint.len -= burst;
+		if (rx_ring != NULL) {
+			while (burst-- > 0) {
+				buf[n++] = rx_ring_byte();
+			}
+		} else {
+			while (burst-- > 0) {
+				buf[n++] = *rx;
+			}
+		}
+	}
+
+	return n;
+}
+
 // uart_read reads blockingly into buf o size bufsize from UART nbytes
 // bytes.
 //
 // Returns negative on error.
 int uart_read(uint8_t *buf, size_t bufsize, size_t nbytes)
 {
+	release();
+
 	if (nbytes > bufsize) {
 		return -1;
 	}
@@ -222,6 +443,11 @@ static int discard(size_t nbytes)
 // Returns non-zero on error.
 int readselect(int bitmask, enum ioend *endpoint, uint8_t *len)
 {
+	release();
+	if (log_flush != NULL) {
+		log_flush();
+	}
+
 	if ((bitmask & IO_UART) || (bitmask & IO_QEMU)) {
 		// Not possible to use readselect() on these
 		// endpoints.
@@ -267,6 +493,141 @@ int readselect(int bitmask, enum ioend *endpoint, uint8_t *len)
 	return 0;
 }
 
+// readpoll is a non-blocking readselect(). It returns 0 and sets
+// endpoint and len like readselect() if there is data for an endpoint
+// in bitmask, and 1 if there isn't yet. Data for endpoints not in
+// bitmask is discarded as it arrives.
+//
+// Returns negative on error.
+int readpoll(int bitmask, enum ioend *endpoint, uint8_t *len)
+{
+	release();
+
+	if ((bitmask & IO_UART) || (bitmask & IO_QEMU)) {
+		return -1;
+	}
+
+	for (;;) {
+		if (cur_endpoint.len == 0) {
+			if (rx_available() < 2) {
+				return 1;
+			}
+
+			// USB Mode Protocol header
+			cur_endpoint.endpoint = readbyte();
+			cur_endpoint.len = readbyte();
+		}
+
+		if (cur_endpoint.endpoint & bitmask) {
+			*endpoint = cur_endpoint.endpoint;
+			*len = cur_endpoint.len;
+
+			return 0;
+		}
+
+		uint32_t n = rx_available();
+
+		if (n == 0) {
+			return 1;
+		}
+
+		(void)discard(n);
+	}
+}
+
+// readview blocks until all of what is left of the current USB Mode
+// Protocol packet from src has arrived and points data to it, with
+// its length in len. Like read() it needs readselect() first.
+//
+// The data is kept in a buffer owned by the library, so there is no
+// need to copy it to a buffer of your own. When the receive ring is
+// used, see uart_rx_irq_enable(), it is usually not copied at all.
+//
+// The data is valid until release(), or until any of the other
+// reading functions, which release it for you. Calling readview()
+// again before that returns the same data.
+//
+// Returns non-zero on error, like when there is no data for src.
+int readview(enum ioend src, const uint8_t **data, uint8_t *len)
+{
+	if (data == NULL || len == NULL) {
+		return -1;
+	}
+
+	if (cur_view.len != 0) {
+		if (src != cur_endpoint.endpoint) {
+			return -1;
+		}
+
+		*data = cur_view.data;
+		*len = cur_view.len;
+
+		return 0;
+	}
+
+	if (src == IO_NONE || src == IO_UART || src == IO_QEMU) {
+		// Destination only endpoints
+		return -1;
+	}
+
+	if (src != cur_endpoint.endpoint || cur_endpoint.len == 0) {
+		return -1;
+	}
+
+	uint8_t n = cur_endpoint.len;
+
+	if (rx_ring != NULL) {
+		while (rx_available() < n) {
+		}
+
+		uint32_t start = rx_ring->tail % UART_RX_RING_SIZE;
+
+		if (start + n <= UART_RX_RING_SIZE) {
+			// Contiguous in the ring, use it where it is.
+			// The ring isn't advanced until release().
+			cur_view.data = &rx_ring->buf[start];
+			cur_view.in_ring = true;
+		} else {
+			for (int i = 0; i < n; i++) {
+				viewbuf[i] = rx_ring_byte();
+			}
+			cur_view.data = viewbuf;
+			cur_view.in_ring = false;
+		}
+	} else {
+		for (int i = 0; i < n; i++) {
+			viewbuf[i] = readbyte();
+		}
+		cur_view.data = viewbuf;
+		cur_view.in_ring = false;
+	}
+
+	cur_view.len = n;
+
+	*data = cur_view.data;
+	*len = cur_view.len;
+
+	return 0;
+}
+
+// release tells the library that the data from readview() is no
+// longer used. The next USB Mode Protocol packet can then be read.
+void release(void)
+{
+	if (cur_view.len == 0) {
+		return;
+	}
+
+	if (cur_view.in_ring) {
+		rx_ring_consume(cur_view.len);
+	}
+
+	cur_endpoint.len -= cur_view.len;
+	cur_view.data = NULL;
+	cur_view.len = 0;
+	cur_view.in_ring = false;
+}
+
 void putchar(enum ioend dest, const uint8_t ch)
 {
 	write(dest, &ch, 1);
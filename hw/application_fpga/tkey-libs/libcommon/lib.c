@@ -6,9 +6,33 @@
 #include <tkey/lib.h>
 #include <tkey/tk1_mem.h>
 
+// The mem* functions below work on words when the pointers allow it.
+// PicoRV32 traps on misaligned word accesses, so when dest and src
+// can't both be word aligned they fall back to bytes.
+//
+// Built with TKEY_LIB_SMALL, for libcommon_small, they only work on
+// bytes, which takes much less ROM.
+#define WORDMASK (sizeof(uint32_t) - 1)
+
 void *memset(void *dest, int c, unsigned n)
 {
 	uint8_t *s = dest;
+#ifndef TKEY_LIB_SMALL
+	uint32_t w = (uint8_t)c * 0x01010101U;
+
+	for (; n && ((uintptr_t)s & WORDMASK); n--, s++)
+		*s = c;
+
+	for (; n >= 16; n -= 16, s += 16) {
+		((uint32_t *)s)[0] = w;
+		((uint32_t *)s)[1] = w;
+		((uint32_t *)s)[2] = w;
+		((uint32_t *)s)[3] = w;
+	}
+
+	for (; n >= 4; n -= 4, s += 4)
+		*(uint32_t *)s = w;
+#endif
 
 	for (; n; n--, s++)
 		*s = c;
@@ -18,12 +42,31 @@ void *memset(void *dest, int c, unsigned n)
 
 __attribute__((used)) void *memcpy(void *dest, const void *src, unsigned n)
 {
-	uint8_t *src_byte = (uint8_t *)src;
+	const uint8_t *src_byte = (const uint8_t *)src;
 	uint8_t *dest_byte = (uint8_t *)dest;
 
-	for (int i = 0; i < n; i++) {
-		dest_byte[i] = src_byte[i];
+#ifndef TKEY_LIB_SMALL
+	if ((((uintptr_t)src_byte ^ (uintptr_t)dest_byte) & WORDMASK) == 0) {
+		for (; n && ((uintptr_t)dest_byte & WORDMASK); n--)
+			*dest_byte++ = *src_byte++;
+
+		for (; n >= 16; n -= 16, src_byte += 16, dest_byte += 16) {
+			const uint32_t *s = (const uint32_t *)src_byte;
+			uint32_t *d = (uint32_t *)dest_byte;
+
+			d[0] = s[0];
+			d[1] = s[1];
+			d[2] = s[2];
+			d[3] = s[3];
+		}
+
+		for (; n >= 4; n -= 4, src_byte += 4, dest_byte += 4)
+			*(uint32_t *)dest_byte = *(const uint32_t *)src_byte;
 	}
+#endif
+
+	for (; n; n--)
+		*dest_byte++ = *src_byte++;
 
 	return dest;
 }
@@ -34,22 +77,27 @@ void memcpy_s(void *dest, size_t destsize, const void *src, size_t n)
 	assert(src != NULL);
 	assert(destsize >= n);
 
-	uint8_t *src_byte = (uint8_t *)src;
-	uint8_t *dest_byte = (uint8_t *)dest;
-
-	for (size_t i = 0; i < n; i++) {
-		dest_byte[i] = src_byte[i];
-	}
+	(void)memcpy(dest, src, n);
 }
 
+// wordcpy copies n words. Each source word is read exactly once, in
+// order, so it can be used to read MMIO.
 __attribute__((used)) void *wordcpy(void *dest, const void *src, unsigned n)
 {
 	uint32_t *src_word = (uint32_t *)src;
 	uint32_t *dest_word = (uint32_t *)dest;
 
-	for (int i = 0; i < n; i++) {
-		dest_word[i] = src_word[i];
+#ifndef TKEY_LIB_SMALL
+	for (; n >= 4; n -= 4, src_word += 4, dest_word += 4) {
+		dest_word[0] = src_word[0];
+		dest_word[1] = src_word[1];
+		dest_word[2] = src_word[2];
+		dest_word[3] = src_word[3];
 	}
+#endif
+
+	for (; n; n--)
+		*dest_word++ = *src_word++;
 
 	return dest;
 }
@@ -60,27 +108,34 @@ void wordcpy_s(void *dest, size_t destsize, const void *src, size_t n)
 	assert(src != NULL);
 	assert(destsize >= n);
 
-	uint32_t *src_word = (uint32_t *)src;
-	uint32_t *dest_word = (uint32_t *)dest;
-
-	for (size_t i = 0; i < n; i++) {
-		dest_word[i] = src_word[i];
-	}
+	(void)wordcpy(dest, src, n);
 }
 
+// memeq returns -1 if the n bytes at dest and src are equal, otherwise
+// 0. Constant time: all n bytes are always compared and the only
+// branches depend on the pointers and n, never on the data.
 int memeq(void *dest, const void *src, size_t n)
 {
-	uint8_t *src_byte = (uint8_t *)src;
-	uint8_t *dest_byte = (uint8_t *)dest;
-	int res = -1;
-
-	for (size_t i = 0; i < n; i++) {
-		if (dest_byte[i] != src_byte[i]) {
-			res = 0;
-		}
+	const uint8_t *src_byte = (const uint8_t *)src;
+	const uint8_t *dest_byte = (const uint8_t *)dest;
+	uint32_t diff = 0;
+
+#ifndef TKEY_LIB_SMALL
+	if ((((uintptr_t)src_byte ^ (uintptr_t)dest_byte) & WORDMASK) == 0) {
+		for (; n && ((uintptr_t)dest_byte & WORDMASK); n--)
+			diff |= *dest_byte++ ^ *src_byte++;
+
+		for (; n >= 4; n -= 4, src_byte += 4, dest_byte += 4)
+			diff |= *(const uint32_t *)dest_byte ^
+				*(const uint32_t *)src_byte;
 	}
+#endif
+
+	for (; n; n--)
+		diff |= *dest_byte++ ^ *src_byte++;
 
-	return res;
+	// -1 if diff is 0, without branching on it
+	return (int)((diff | -diff) >> 31) - 1;
 }
 
 void secure_wipe(void *v, size_t n)
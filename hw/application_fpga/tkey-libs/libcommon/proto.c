@@ -49,3 +49,163 @@ int parseframe(uint8_t b, struct frame_header *hdr)
 
 	return 0;
 }
+
+static size_t bytelen(enum cmdlen len)
+{
+	switch (len) {
+	case LEN_1:
+		return 1;
+	case LEN_4:
+		return 4;
+	case LEN_32:
+		return 32;
+	case LEN_128:
+		return 128;
+	}
+
+	return 0;
+}
+
+void frame_reader_init(struct frame_reader *r)
+{
+	r->len = 0;
+	r->have_hdr = false;
+}
+
+// frame_reader_feed reads at most avail bytes of a frame from src,
+// typically the length returned by readselect() or readpoll(). Never
+// blocks waiting for more than avail bytes, so it can be used from an
+// event handler.
+//
+// Returns 1 when a whole frame is in r, 0 if more is needed and -1 on
+// a bad frame header. Stops after a complete frame, so call it again
+// if there is still data left in the packet.
+int frame_reader_feed(struct frame_reader *r, enum ioend src, uint8_t avail)
+{
+	while (avail > 0) {
+		if (!r->have_hdr) {
+			uint8_t b = 0;
+
+			if (read(src, &b, 1, 1) != 1) {
+				return -1;
+			}
+			avail--;
+
+			if (parseframe(b, &r->hdr) != 0) {
+				frame_reader_init(r);
+				return -1;
+			}
+
+			r->len = 0;
+			r->have_hdr = true;
+			continue;
+		}
+
+		size_t n = r->hdr.len - r->len;
+		if (n > avail) {
+			n = avail;
+		}
+
+		int got = read(src, &r->cmd[r->len], sizeof(r->cmd) - r->len, n);
+		if (got < 0) {
+			return -1;
+		}
+		r->len += got;
+		avail -= got;
+
+		if (r->len == r->hdr.len) {
+			r->have_hdr = false;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+// readframe reads a whole frame from src into r. Blocking.
+//
+// Returns 0 on success and -1 on a bad frame header.
+int readframe(struct frame_reader *r, enum ioend src)
+{
+	uint8_t b = 0;
+
+	frame_reader_init(r);
+
+	if (readfull(src, &b, 1, 1) < 0) {
+		return -1;
+	}
+
+	if (parseframe(b, &r->hdr) != 0) {
+		return -1;
+	}
+
+	if (readfull(src, r->cmd, sizeof(r->cmd), r->hdr.len) < 0) {
+		return -1;
+	}
+	r->len = r->hdr.len;
+
+	return 0;
+}
+
+// frame_dispatch calls the handler in cmds for the command code of
+// the complete frame in r.
+//
+// Returns -1 if the frame isn't for an app or the command code is
+// unknown, in which case the caller should reply with
+// frame_reply_nok().
+int frame_dispatch(const struct frame_cmd *cmds, size_t ncmds,
+		   const struct frame_reader *r, void *arg)
+{
+	if (r->hdr.endpoint != DST_SW || r->len == 0) {
+		return -1;
+	}
+
+	for (size_t i = 0; i < ncmds; i++) {
+		if (cmds[i].code == r->cmd[0]) {
+			cmds[i].fn(&r->hdr, r->cmd, r->len, arg);
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+// frame_reply sends a response with the same ID as hdr: the frame
+// header, rspcode and buflen bytes of buf, padded with zeroes to len.
+// The parts are written straight from where they are into USB packets,
+// without being copied into a frame buffer first.
+void frame_reply(enum ioend dest, const struct frame_header *hdr,
+		 enum cmdlen len, uint8_t rspcode, const void *buf,
+		 size_t buflen)
+{
+	static const uint8_t zeroes[CMDLEN_MAXBYTES - 1] = {0};
+	size_t nbytes = bytelen(len);
+
+	if (buflen > nbytes - 1) {
+		buflen = nbytes - 1;
+	}
+
+	uint8_t hdrs[2] = {
+	    genhdr(hdr->id, DST_SW, STATUS_OK, len),
+	    rspcode,
+	};
+	struct iovec iov[3] = {
+	    {hdrs, sizeof(hdrs)},
+	    {buf, buflen},
+	    {zeroes, nbytes - 1 - buflen},
+	};
+
+	writev(dest, iov, 3);
+}
+
+// frame_reply_nok sends a one byte response with the status bit set,
+// for a bad or unknown command.
+void frame_reply_nok(enum ioend dest, const struct frame_header *hdr)
+{
+	uint8_t rsp[2] = {
+	    genhdr(hdr->id, DST_SW, STATUS_BAD, LEN_1),
+	    0,
+	};
+
+	write(dest, rsp, sizeof(rsp));
+}
@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
 // SPDX-License-Identifier: BSD-2-Clause
 
+#include <tkey/io.h>
 #include <tkey/syscall.h>
 
 // Reset the TKey. Leave the reset type (enum reset_start) in rst as
@@ -143,3 +144,24 @@ int sys_status(void)
 {
 	return syscall(TK1_SYSCALL_STATUS, 0, 0, 0);
 }
+
+// Copies the firmware boot trace to `trace`. Only available if
+// firmware was built with BOOT_TRACE.
+//
+// Returns 0 on success.
+int sys_get_boot_trace(struct boot_trace *trace)
+{
+	return syscall(TK1_SYSCALL_GET_BOOT_TRACE, (uint32_t)trace,
+		       sizeof(*trace), 0);
+}
+
+// Register the receive ring `ring` with firmware. Firmware moves
+// received bytes from the UART to the ring on the UART receive
+// interrupt. Start using it with uart_rx_irq_enable().
+//
+// Returns 0 on success.
+int sys_uart_rx_ring(struct uart_rx_ring *ring)
+{
+	return syscall(TK1_SYSCALL_UART_RX_RING, (uint32_t)ring,
+		       sizeof(ring->buf), 0);
+}
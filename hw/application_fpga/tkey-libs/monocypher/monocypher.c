@@ -53,6 +53,10 @@
 
 #include "monocypher.h"
 
+#ifdef TKEY_PCPI
+#include <tkey/pcpi.h>
+#endif
+
 #ifdef MONOCYPHER_CPP_NAMESPACE
 namespace MONOCYPHER_CPP_NAMESPACE {
 #endif
@@ -89,6 +93,7 @@ static size_t gap(size_t x, size_t pow_2)
 	return (~x + 1) & (pow_2 - 1);
 }
 
+#ifndef TKEY_FE_RV32 // only used by the 10 limbs field elements
 static u32 load24_le(const u8 s[3])
 {
 	return
@@ -96,6 +101,7 @@ static u32 load24_le(const u8 s[3])
 		((u32)s[1] <<  8) |
 		((u32)s[2] << 16);
 }
+#endif
 
 static u32 load32_le(const u8 s[4])
 {
@@ -139,7 +145,12 @@ static void store64_le_buf(u8 *dst, const u64 *src, size_t size) {
 }
 
 static u64 rotr64(u64 x, u64 n) { return (x >> n) ^ (x << (64 - n)); }
+#ifdef TKEY_PCPI
+// Only used with constant n
+#define rotl32(x, n) pcpi_roli(x, n)
+#else
 static u32 rotl32(u32 x, u32 n) { return (x << n) ^ (x >> (32 - n)); }
+#endif
 
 static int neq0(u64 diff)
 {
@@ -925,8 +936,322 @@ void crypto_argon2(u8 *hash, u32 hash_size, void *work_area,
 //  Originally taken from SUPERCOP's ref10 implementation.
 //  A bit bigger than TweetNaCl, over 4 times faster.
 
+#ifdef TKEY_FE_RV32
+// Packed field elements for 32 bit CPUs with a slow multiplier
+// -------------------------------------------------------------
+//
+// A field element is 8 limbs of 32 bits, little endian.  Elements
+// are kept below 2^256, but are not fully reduced until fe_tobytes().
+// Since 2^256 = 38 modulo p, anything above 2^256 is folded back
+// to the bottom multiplied by 38.
+//
+// fe_mul() needs 64 products instead of 100 with 10 limbs, fe_sq()
+// 36 instead of 55.  On a CPU where a product costs more than an
+// addition (like the PicoRV32 in the TKey), that wins over the extra
+// carry handling.
+typedef u32 fe_limb;
+typedef fe_limb fe[8];
+
+// field constants
+//
+// fe_one      : 1
+// sqrtm1      : sqrt(-1)
+// d           :     -121665 / 121666
+// D2          : 2 * -121665 / 121666
+// lop_x, lop_y: low order point in Edwards coordinates
+// ufactor     : -sqrt(-1) * 2
+// A2          : 486662^2  (A squared)
+static const fe fe_one  = {1};
+static const fe sqrtm1  = {
+	0x4a0ea0b0, 0xc4ee1b27, 0xad2fe478, 0x2f431806,
+	0x3dfbd7a7, 0x2b4d0099, 0x4fc1df0b, 0x2b832480,
+};
+static const fe d       = {
+	0x135978a3, 0x75eb4dca, 0x4141d8ab, 0x00700a4d,
+	0x7779e898, 0x8cc74079, 0x2b6ffe73, 0x52036cee,
+};
+static const fe D2      = {
+	0x26b2f159, 0xebd69b94, 0x8283b156, 0x00e0149a,
+	0xeef3d130, 0x198e80f2, 0x56dffce7, 0x2406d9dc,
+};
+static const fe lop_x   = {
+	0xc545d14a, 0xdea14646, 0x13e5e238, 0x5c193c70,
+	0x38de4abb, 0xe9339932, 0x06394a28, 0x1fd5b9a0,
+};
+static const fe lop_y   = {
+	0x8f95e826, 0xb027b2c2, 0x89f4c345, 0xf098eff2,
+	0x05acdfd5, 0x3933c6d3, 0x880238b1, 0x05fc536d,
+};
+static const fe ufactor = {
+	0x6be2be8d, 0x7623c9b1, 0xa5a0370e, 0xa179cff2,
+	0x840850b1, 0xa965fecd, 0x607c41e9, 0x28f9b6ff,
+};
+static const fe A2      = {
+	0x24c21c24, 0x00000037, 0x00000000, 0x00000000,
+	0x00000000, 0x00000000, 0x00000000, 0x00000000,
+};
+
+static void fe_0(fe h) {           ZERO(h  , 8); }
+static void fe_1(fe h) { h[0] = 1; ZERO(h+1, 7); }
+
+static void fe_copy(fe h, const fe f) { FOR(i, 0, 8) h[i] = f[i]; }
+
+// h = t + c * 2^256, reduced below 2^256 again
+static void fe_fold(fe h, const fe t, u64 c)
+{
+	c *= 38;
+	FOR (i, 0, 8) {
+		c   += t[i];
+		h[i] = (u32)c;
+		c  >>= 32;
+	}
+	// Only wraps if t was close to 2^256, then h[0] is small
+	h[0] += (u32)c * 38;
+}
+
+static void fe_add(fe h, const fe f, const fe g)
+{
+	fe  t;
+	u64 c = 0;
+	FOR (i, 0, 8) {
+		c   += (u64)f[i] + g[i];
+		t[i] = (u32)c;
+		c  >>= 32;
+	}
+	fe_fold(h, t, c);
+}
+
+static void fe_sub(fe h, const fe f, const fe g)
+{
+	i64 c = 0;
+	FOR (i, 0, 8) {
+		c   += (i64)f[i] - g[i];
+		h[i] = (u32)c;
+		c  >>= 32;
+	}
+	// On a borrow, 2^256 was added: remove 38 instead
+	c *= 38;
+	FOR (i, 0, 8) {
+		c   += h[i];
+		h[i] = (u32)c;
+		c  >>= 32;
+	}
+	// Only borrows if h was close to 0, then h[0] is big
+	h[0] += (u32)c * 38;
+}
+
+static void fe_neg(fe h, const fe f)
+{
+	static const fe zero = {0};
+	fe_sub(h, zero, f);
+}
+
+static void fe_cswap(fe f, fe g, int b)
+{
+	u32 mask = (u32)-b; // -1 = 0xffffffff
+	FOR (i, 0, 8) {
+		u32 x = (f[i] ^ g[i]) & mask;
+		f[i] = f[i] ^ x;
+		g[i] = g[i] ^ x;
+	}
+}
+
+static void fe_ccopy(fe f, const fe g, int b)
+{
+	u32 mask = (u32)-b; // -1 = 0xffffffff
+	FOR (i, 0, 8) {
+		u32 x = (f[i] ^ g[i]) & mask;
+		f[i] = f[i] ^ x;
+	}
+}
+
+// Decodes a field element from a byte buffer.
+// mask specifies how many bits we ignore.
+// Traditionally we ignore 1. It's useful for EdDSA,
+// which uses that bit to denote the sign of x.
+// Elligator however uses positive representatives,
+// which means ignoring 2 bits instead.
+static void fe_frombytes_mask(fe h, const u8 s[32], unsigned nb_mask)
+{
+	load32_le_buf(h, s, 8);
+	h[7] &= 0xffffffff >> nb_mask;
+}
+
+static void fe_frombytes(fe h, const u8 s[32])
+{
+	fe_frombytes_mask(h, s, 1);
+}
+
+// Fully reduces h, which can be anything below 2^256.
+static void fe_tobytes(u8 s[32], const fe h)
+{
+	u32 t[8];
+	COPY(t, h, 8);
+
+	// Fold bit 255, t < 2^255 + 19
+	u64 c = (t[7] >> 31) * 19;
+	t[7] &= 0x7fffffff;
+	FOR (i, 0, 8) {
+		c   += t[i];
+		t[i] = (u32)c;
+		c  >>= 32;
+	}
+
+	// q = 1 iff t >= p, that is iff t + 19 reaches bit 255
+	c = 19;
+	FOR (i, 0, 7) {
+		c = (c + t[i]) >> 32;
+	}
+	u32 q = (u32)((c + t[7]) >> 31);
+
+	// Subtract p: add 19 and chop off bit 255
+	c = q * 19;
+	FOR (i, 0, 8) {
+		c   += t[i];
+		t[i] = (u32)c;
+		c  >>= 32;
+	}
+	t[7] &= 0x7fffffff;
+
+	store32_le_buf(s, t, 8);
+	WIPE_BUFFER(t);
+}
+
+// g is a small constant, its sign is not secret.
+static void fe_mul_small(fe h, const fe f, i32 g)
+{
+	fe  t;
+	u32 m = g < 0 ? (u32)-g : (u32)g;
+	u64 c = 0;
+	FOR (i, 0, 8) {
+		c   += (u64)f[i] * m;
+		t[i] = (u32)c;
+		c  >>= 32;
+	}
+	fe_fold(h, t, c);
+	if (g < 0) {
+		fe_neg(h, h);
+	}
+}
+
+// Adds the 64 bit product a * b to the 96 bit accumulator r2:r1:r0.
+// The high half of a product is at most 2^32 - 2, so adding the carry
+// of the low half to it does not wrap.
+#define FE_MAC(a, b) do { \
+		u64 p_  = (u64)(a) * (b); \
+		u32 lo_ = (u32)p_; \
+		u32 hi_ = (u32)(p_ >> 32); \
+		r0 += lo_;  hi_ += r0 < lo_; \
+		r1 += hi_;  r2  += r1 < hi_; \
+	} while (0)
+
+// Moves the lowest word of the accumulator to t, next column.
+#define FE_COL(t) do { t = r0;  r0 = r1;  r1 = r2;  r2 = 0; } while (0)
+
+// h = t[0..7] + t[8..15] * 38, reduced below 2^256
+static void fe_reduce(fe h, const u32 t[16])
+{
+	fe  l;
+	u64 c = 0;
+	FOR (i, 0, 8) {
+		c   += (u64)t[i + 8] * 38 + t[i];
+		l[i] = (u32)c;
+		c  >>= 32;
+	}
+	fe_fold(h, l, c);
+	WIPE_BUFFER(l);
+}
+
+// Product scanning: the 512 bit product is computed one column of
+// partial products at a time, then reduced.  Everything is unrolled,
+// as in the 10 limbs version.
+static void fe_mul(fe h, const fe f, const fe g)
+{
+	u32 f0 = f[0]; u32 f1 = f[1]; u32 f2 = f[2]; u32 f3 = f[3];
+	u32 f4 = f[4]; u32 f5 = f[5]; u32 f6 = f[6]; u32 f7 = f[7];
+	u32 g0 = g[0]; u32 g1 = g[1]; u32 g2 = g[2]; u32 g3 = g[3];
+	u32 g4 = g[4]; u32 g5 = g[5]; u32 g6 = g[6]; u32 g7 = g[7];
+	u32 r0 = 0;    u32 r1 = 0;    u32 r2 = 0;
+	u32 t[16];
+
+	FE_MAC(f0, g0);                                                   FE_COL(t[ 0]);
+	FE_MAC(f0, g1); FE_MAC(f1, g0);                                   FE_COL(t[ 1]);
+	FE_MAC(f0, g2); FE_MAC(f1, g1); FE_MAC(f2, g0);                   FE_COL(t[ 2]);
+	FE_MAC(f0, g3); FE_MAC(f1, g2); FE_MAC(f2, g1); FE_MAC(f3, g0);   FE_COL(t[ 3]);
+	FE_MAC(f0, g4); FE_MAC(f1, g3); FE_MAC(f2, g2); FE_MAC(f3, g1);
+	FE_MAC(f4, g0);                                                   FE_COL(t[ 4]);
+	FE_MAC(f0, g5); FE_MAC(f1, g4); FE_MAC(f2, g3); FE_MAC(f3, g2);
+	FE_MAC(f4, g1); FE_MAC(f5, g0);                                   FE_COL(t[ 5]);
+	FE_MAC(f0, g6); FE_MAC(f1, g5); FE_MAC(f2, g4); FE_MAC(f3, g3);
+	FE_MAC(f4, g2); FE_MAC(f5, g1); FE_MAC(f6, g0);                   FE_COL(t[ 6]);
+	FE_MAC(f0, g7); FE_MAC(f1, g6); FE_MAC(f2, g5); FE_MAC(f3, g4);
+	FE_MAC(f4, g3); FE_MAC(f5, g2); FE_MAC(f6, g1); FE_MAC(f7, g0);   FE_COL(t[ 7]);
+	FE_MAC(f1, g7); FE_MAC(f2, g6); FE_MAC(f3, g5); FE_MAC(f4, g4);
+	FE_MAC(f5, g3); FE_MAC(f6, g2); FE_MAC(f7, g1);                   FE_COL(t[ 8]);
+	FE_MAC(f2, g7); FE_MAC(f3, g6); FE_MAC(f4, g5); FE_MAC(f5, g4);
+	FE_MAC(f6, g3); FE_MAC(f7, g2);                                   FE_COL(t[ 9]);
+	FE_MAC(f3, g7); FE_MAC(f4, g6); FE_MAC(f5, g5); FE_MAC(f6, g4);
+	FE_MAC(f7, g3);                                                   FE_COL(t[10]);
+	FE_MAC(f4, g7); FE_MAC(f5, g6); FE_MAC(f6, g5); FE_MAC(f7, g4);   FE_COL(t[11]);
+	FE_MAC(f5, g7); FE_MAC(f6, g6); FE_MAC(f7, g5);                   FE_COL(t[12]);
+	FE_MAC(f6, g7); FE_MAC(f7, g6);                                   FE_COL(t[13]);
+	FE_MAC(f7, g7);                                                   FE_COL(t[14]);
+	t[15] = r0;
+
+	fe_reduce(h, t);
+	WIPE_BUFFER(t);
+}
+
+// Note: we could use fe_mul() for this, but this is significantly faster
+//
+// Every cross product f[i] * f[j] (i < j) appears twice in the square.
+// They are computed once and the sum is doubled, then the squares
+// f[i]^2 are added.
+static void fe_sq(fe h, const fe f)
+{
+	u32 f0 = f[0]; u32 f1 = f[1]; u32 f2 = f[2]; u32 f3 = f[3];
+	u32 f4 = f[4]; u32 f5 = f[5]; u32 f6 = f[6]; u32 f7 = f[7];
+	u32 r0 = 0;    u32 r1 = 0;    u32 r2 = 0;
+	u32 t[16];
+
+	t[0] = 0;
+	FE_MAC(f0, f1);                                                   FE_COL(t[ 1]);
+	FE_MAC(f0, f2);                                                   FE_COL(t[ 2]);
+	FE_MAC(f0, f3); FE_MAC(f1, f2);                                   FE_COL(t[ 3]);
+	FE_MAC(f0, f4); FE_MAC(f1, f3);                                   FE_COL(t[ 4]);
+	FE_MAC(f0, f5); FE_MAC(f1, f4); FE_MAC(f2, f3);                   FE_COL(t[ 5]);
+	FE_MAC(f0, f6); FE_MAC(f1, f5); FE_MAC(f2, f4);                   FE_COL(t[ 6]);
+	FE_MAC(f0, f7); FE_MAC(f1, f6); FE_MAC(f2, f5); FE_MAC(f3, f4);   FE_COL(t[ 7]);
+	FE_MAC(f1, f7); FE_MAC(f2, f6); FE_MAC(f3, f5);                   FE_COL(t[ 8]);
+	FE_MAC(f2, f7); FE_MAC(f3, f6); FE_MAC(f4, f5);                   FE_COL(t[ 9]);
+	FE_MAC(f3, f7); FE_MAC(f4, f6);                                   FE_COL(t[10]);
+	FE_MAC(f4, f7); FE_MAC(f5, f6);                                   FE_COL(t[11]);
+	FE_MAC(f5, f7);                                                   FE_COL(t[12]);
+	FE_MAC(f6, f7);                                                   FE_COL(t[13]);
+	t[14] = r0;
+	t[15] = r1;
+
+	u64 c   = 0;
+	u32 top = 0; // bit shifted out of the previous word
+	FOR (i, 0, 8) {
+		u64 sq = (u64)f[i] * f[i];
+		u32 lo = t[2*i    ];
+		u32 hi = t[2*i + 1];
+		c += ((lo << 1) | top      ) + (u64)(u32)sq;
+		t[2*i    ] = (u32)c;  c >>= 32;
+		c += ((hi << 1) | (lo >> 31)) + (sq >> 32);
+		t[2*i + 1] = (u32)c;  c >>= 32;
+		top = hi >> 31;
+	}
+
+	fe_reduce(h, t);
+	WIPE_BUFFER(t);
+}
+
+#else
 // field element
-typedef i32 fe[10];
+typedef i32 fe_limb;
+typedef fe_limb fe[10];
 
 // field constants
 //
@@ -1119,6 +1444,29 @@ static void fe_ccopy(fe f, const fe g, int b)
 	h[0]=(i32)t0;  h[1]=(i32)t1;  h[2]=(i32)t2;  h[3]=(i32)t3;  h[4]=(i32)t4; \
 	h[5]=(i32)t5;  h[6]=(i32)t6;  h[7]=(i32)t7;  h[8]=(i32)t8;  h[9]=(i32)t9
 
+#ifdef TKEY_PCPI
+// Sums of products for fe_mul() and fe_sq(), in the multiply-accumulate
+// unit of the TKey CPU.
+#define FE_MAC5(a0, b0, a1, b1, a2, b2, a3, b3, a4, b4) \
+	pcpi_mac(a0, b0), pcpi_mac(a1, b1), pcpi_mac(a2, b2), \
+	pcpi_mac(a3, b3), pcpi_mac(a4, b4)
+#define FE_SUM5(a0, b0, a1, b1, a2, b2, a3, b3, a4, b4) \
+	(pcpi_mac_set(0), \
+	 FE_MAC5(a0, b0, a1, b1, a2, b2, a3, b3, a4, b4), \
+	 pcpi_mac_get())
+#define FE_SUM6(a0, b0, a1, b1, a2, b2, a3, b3, a4, b4, a5, b5) \
+	(pcpi_mac_set(0), \
+	 FE_MAC5(a0, b0, a1, b1, a2, b2, a3, b3, a4, b4), \
+	 pcpi_mac(a5, b5), \
+	 pcpi_mac_get())
+#define FE_SUM10(a0, b0, a1, b1, a2, b2, a3, b3, a4, b4, \
+                 a5, b5, a6, b6, a7, b7, a8, b8, a9, b9) \
+	(pcpi_mac_set(0), \
+	 FE_MAC5(a0, b0, a1, b1, a2, b2, a3, b3, a4, b4), \
+	 FE_MAC5(a5, b5, a6, b6, a7, b7, a8, b8, a9, b9), \
+	 pcpi_mac_get())
+#endif
+
 // Decodes a field element from a byte buffer.
 // mask specifies how many bits we ignore.
 // Traditionally we ignore 1. It's useful for EdDSA,
@@ -1238,6 +1586,28 @@ static void fe_mul(fe h, const fe f, const fe g)
 	// |G0|, |G2|, |G4|, |G6|, |G8|  <  2^31
 	// |G1|, |G3|, |G5|, |G7|, |G9|  <  2^30
 
+#ifdef TKEY_PCPI
+	i64 t0 = FE_SUM10(f0, g0, F1, G9, f2, G8, F3, G7, f4, G6,
+	                  F5, G5, f6, G4, F7, G3, f8, G2, F9, G1);
+	i64 t1 = FE_SUM10(f0, g1, f1, g0, f2, G9, f3, G8, f4, G7,
+	                  f5, G6, f6, G5, f7, G4, f8, G3, f9, G2);
+	i64 t2 = FE_SUM10(f0, g2, F1, g1, f2, g0, F3, G9, f4, G8,
+	                  F5, G7, f6, G6, F7, G5, f8, G4, F9, G3);
+	i64 t3 = FE_SUM10(f0, g3, f1, g2, f2, g1, f3, g0, f4, G9,
+	                  f5, G8, f6, G7, f7, G6, f8, G5, f9, G4);
+	i64 t4 = FE_SUM10(f0, g4, F1, g3, f2, g2, F3, g1, f4, g0,
+	                  F5, G9, f6, G8, F7, G7, f8, G6, F9, G5);
+	i64 t5 = FE_SUM10(f0, g5, f1, g4, f2, g3, f3, g2, f4, g1,
+	                  f5, g0, f6, G9, f7, G8, f8, G7, f9, G6);
+	i64 t6 = FE_SUM10(f0, g6, F1, g5, f2, g4, F3, g3, f4, g2,
+	                  F5, g1, f6, g0, F7, G9, f8, G8, F9, G7);
+	i64 t7 = FE_SUM10(f0, g7, f1, g6, f2, g5, f3, g4, f4, g3,
+	                  f5, g2, f6, g1, f7, g0, f8, G9, f9, G8);
+	i64 t8 = FE_SUM10(f0, g8, F1, g7, f2, g6, F3, g5, f4, g4,
+	                  F5, g3, f6, g2, F7, g1, f8, g0, F9, G9);
+	i64 t9 = FE_SUM10(f0, g9, f1, g8, f2, g7, f3, g6, f4, g5,
+	                  f5, g4, f6, g3, f7, g2, f8, g1, f9, g0);
+#else
 	i64 t0 = f0*(i64)g0 + F1*(i64)G9 + f2*(i64)G8 + F3*(i64)G7 + f4*(i64)G6
 	       + F5*(i64)G5 + f6*(i64)G4 + F7*(i64)G3 + f8*(i64)G2 + F9*(i64)G1;
 	i64 t1 = f0*(i64)g1 + f1*(i64)g0 + f2*(i64)G9 + f3*(i64)G8 + f4*(i64)G7
@@ -1258,6 +1628,7 @@ static void fe_mul(fe h, const fe f, const fe g)
 	       + F5*(i64)g3 + f6*(i64)g2 + F7*(i64)g1 + f8*(i64)g0 + F9*(i64)G9;
 	i64 t9 = f0*(i64)g9 + f1*(i64)g8 + f2*(i64)g7 + f3*(i64)g6 + f4*(i64)g5
 	       + f5*(i64)g4 + f6*(i64)g3 + f7*(i64)g2 + f8*(i64)g1 + f9*(i64)g0;
+#endif
 	// t0 < 0.67 * 2^61
 	// t1 < 0.41 * 2^61
 	// t2 < 0.52 * 2^61
@@ -1290,6 +1661,23 @@ static void fe_sq(fe h, const fe f)
 	// |f1_2| , |f3_2| , |f5_2| , |f7_2| , |f9_2|  <  1.65 * 2^26
 	// |f5_38|, |f6_19|, |f7_38|, |f8_19|, |f9_38| <  2^31
 
+#ifdef TKEY_PCPI
+	i64 t0 = FE_SUM6(f0, f0, f1_2, f9_38, f2_2, f8_19, f3_2, f7_38, f4_2, f6_19,
+	                 f5, f5_38);
+	i64 t1 = FE_SUM5(f0_2, f1, f2, f9_38, f3_2, f8_19, f4, f7_38, f5_2, f6_19);
+	i64 t2 = FE_SUM6(f0_2, f2, f1_2, f1, f3_2, f9_38, f4_2, f8_19, f5_2, f7_38,
+	                 f6, f6_19);
+	i64 t3 = FE_SUM5(f0_2, f3, f1_2, f2, f4, f9_38, f5_2, f8_19, f6, f7_38);
+	i64 t4 = FE_SUM6(f0_2, f4, f1_2, f3_2, f2, f2, f5_2, f9_38, f6_2, f8_19,
+	                 f7, f7_38);
+	i64 t5 = FE_SUM5(f0_2, f5, f1_2, f4, f2_2, f3, f6, f9_38, f7_2, f8_19);
+	i64 t6 = FE_SUM6(f0_2, f6, f1_2, f5_2, f2_2, f4, f3_2, f3, f7_2, f9_38,
+	                 f8, f8_19);
+	i64 t7 = FE_SUM5(f0_2, f7, f1_2, f6, f2_2, f5, f3_2, f4, f8, f9_38);
+	i64 t8 = FE_SUM6(f0_2, f8, f1_2, f7_2, f2_2, f6, f3_2, f5_2, f4, f4,
+	                 f9, f9_38);
+	i64 t9 = FE_SUM5(f0_2, f9, f1_2, f8, f2_2, f7, f3_2, f6, f4, f5_2);
+#else
 	i64 t0 = f0  *(i64)f0    + f1_2*(i64)f9_38 + f2_2*(i64)f8_19
 	       + f3_2*(i64)f7_38 + f4_2*(i64)f6_19 + f5  *(i64)f5_38;
 	i64 t1 = f0_2*(i64)f1    + f2  *(i64)f9_38 + f3_2*(i64)f8_19
@@ -1310,6 +1698,7 @@ static void fe_sq(fe h, const fe f)
 	       + f3_2*(i64)f5_2  + f4  *(i64)f4    + f9  *(i64)f9_38;
 	i64 t9 = f0_2*(i64)f9    + f1_2*(i64)f8    + f2_2*(i64)f7
 	       + f3_2*(i64)f6    + f4  *(i64)f5_2;
+#endif
 	// t0 < 0.67 * 2^61
 	// t1 < 0.41 * 2^61
 	// t2 < 0.52 * 2^61
@@ -1324,6 +1713,8 @@ static void fe_sq(fe h, const fe f)
 	FE_CARRY;
 }
 
+#endif // TKEY_FE_RV32
+
 //  Parity check.  Returns 0 if even, 1 if odd
 static int fe_isodd(const fe f)
 {
@@ -1425,11 +1816,11 @@ static int invsqrt(fe isr, const fe x)
 	fe_sq(t0, t0);  FOR (i, 1,   2) { fe_sq(t0, t0); }  fe_mul(t0, t0, x);
 
 	// quartic = x^((p-1)/4)
-	i32 *quartic = t1;
+	fe_limb *quartic = t1;
 	fe_sq (quartic, t0);
 	fe_mul(quartic, quartic, x);
 
-	i32 *check = t2;
+	fe_limb *check = t2;
 	fe_0  (check);          int z0 = fe_isequal(x      , check);
 	fe_1  (check);          int p1 = fe_isequal(quartic, check);
 	fe_neg(check, check );  int m1 = fe_isequal(quartic, check);
@@ -1855,6 +2246,58 @@ static void ge_double(ge *s, const ge *p, ge *q)
 }
 
 // 5-bit signed window in cached format (Niels coordinates, Z=1)
+#ifdef TKEY_FE_RV32
+static const ge_precomp b_window[8] = {
+	{{0xf58c3b85, 0x2fbc93c6, 0xfb8c0e19, 0xcf932dc6,
+	  0x643d42c2, 0x270b4898, 0x33d4ba65, 0x07cf9d3a,},
+	 {0xd740913e, 0x9d103905, 0xd140beb3, 0xfd399f05,
+	  0x688f8a09, 0xa5c18434, 0x98f81267, 0x44fd2f92,},
+	 {0x877aaa68, 0xabc91205, 0xccaac49e, 0x26d9e823,
+	  0xdd43598c, 0x5a1b7dcb, 0x9f0c65a8, 0x6f117b68,},},
+	{{0x4cee9730, 0xaf25b0a8, 0xe8864b8a, 0x025a8430,
+	  0x9f016732, 0xc11b5002, 0x9a80f8f4, 0x7a164e1b,},
+	 {0xa4fcd265, 0x56611fe8, 0xe5c1ba7d, 0x3bd353fd,
+	  0x214bd6bd, 0x8131f31a, 0x555bda62, 0x2ab91587,},
+	 {0x0dd0d889, 0x14ae933f, 0x1c35da62, 0x58942322,
+	  0x8cf2db4c, 0xd170e545, 0x12b9b4c6, 0x5a2826af,},},
+	{{0x08a5bb33, 0xa212bc44, 0xc75eed02, 0x8d5048c3,
+	  0x5abfec44, 0xdd1beb0c, 0x46e206eb, 0x2945ccf1,},
+	 {0xa447d6ba, 0x7f9182c3, 0x4b2729b7, 0xd50014d1,
+	  0xb864a087, 0xe33cf11c, 0xeb1b55f3, 0x154a7e73,},
+	 {0x812a8285, 0xbcbbdbf1, 0xd0bdd1fc, 0x270e0807,
+	  0x1bbda72d, 0xb41b670b, 0x6b3bb69a, 0x43aabe69,},},
+	{{0x944ea3bf, 0x6b1a5cd0, 0xb39dc0d2, 0x7470353a,
+	  0x28542e49, 0x71b25282, 0x283c927e, 0x461bea69,},
+	 {0xaa3221b1, 0xba6f2c9a, 0x3bba23a7, 0x6ca02153,
+	  0x92192c3a, 0x9dea764f, 0x2e5317e0, 0x1d6edd5d,},
+	 {0x01b8b3a2, 0xf1836dc8, 0x053ea49a, 0xb3035f47,
+	  0x5877adf3, 0x529c41ba, 0x6a0f90a7, 0x7a9fbb1c,},},
+	{{0xa6a8632f, 0x9b2e678a, 0x51bc46c5, 0xa6509e6f,
+	  0xc686f5b5, 0xceb233c9, 0x8add7f59, 0x34b9ed33,},
+	 {0x039d8064, 0xf36e217e, 0xf520419b, 0x98a081b6,
+	  0xe75eb044, 0x96cbc608, 0xfadc9c8f, 0x49c05a51,},
+	 {0x9045af1b, 0x06b4e8bf, 0xa719d22f, 0xe2ff83e8,
+	  0x93d4cf16, 0xaaf6fc29, 0x1b008b06, 0x73c17202,},},
+	{{0x8a802ade, 0x2fbf0084, 0x02302e27, 0xe5d9fecf,
+	  0x17703406, 0x113e8471, 0x546d8faf, 0x4275aae2,},
+	 {0x49864348, 0x315f5b02, 0x77088381, 0x3ed6b369,
+	  0x6a8deb95, 0xa3a07555, 0x29d5c77f, 0x18ab5980,},
+	 {0xfd6089e9, 0xd82b2cc5, 0x3282e4a4, 0x031eb4a1,
+	  0xb51a8622, 0x44311199, 0xb53df948, 0x3dc65522,},},
+	{{0xa2007f6d, 0xbf70c222, 0xb5bcdedb, 0xbf84b39a,
+	  0xfb07ba07, 0x537a0e12, 0xc346f241, 0x234fd7ee,},
+	 {0x327fbf93, 0x506f013b, 0x9b776f6b, 0xaefcebc9,
+	  0xaaad5968, 0x9d12b232, 0x176024a7, 0x0267882d,},
+	 {0x732ea378, 0x5360a119, 0xdf8dd471, 0x2437e6b1,
+	  0x91a7e533, 0xa2ef37f8, 0xaa097863, 0x497ba6fd,},},
+	{{0x13cfeaa0, 0x24cecc03, 0x189c246d, 0x8648c28d,
+	  0xc1f2d4d0, 0x2dbdbdfa, 0xf12de72b, 0x61e22917,},
+	 {0x468ccf0b, 0x040bcd86, 0x2a9910d6, 0xd3829ba4,
+	  0x07b25192, 0x75083008, 0x18d05ebf, 0x43b5cd42,},
+	 {0x9bd0b516, 0x5d9a762f, 0x373fdeee, 0xeb38af4e,
+	  0x93d64270, 0x032e5a7d, 0x0ae4d842, 0x511d6121,},},
+};
+#else
 static const ge_precomp b_window[8] = {
 	{{25967493,-14356035,29566456,3660896,-12694345,
 	  4014787,27544626,-11754271,-6079156,2047605,},
@@ -1905,6 +2348,7 @@ static const ge_precomp b_window[8] = {
 	 {-3099351,10324967,-2241613,7453183,-5446979,
 	  -2735503,-13812022,-16236442,-32461234,-12290683,},},
 };
+#endif
 
 // Incremental sliding windows (left to right)
 // Based on Roberto Maria Avanzi[2005]
@@ -1961,6 +2405,18 @@ static int slide_step(slide_ctx *ctx, int width, int i, const u8 scalar[32])
 	return i == ctx->next_index ? ctx->next_digit: 0;
 }
 
+// lut[i] = [2i+1]p
+static void lut_init(ge_cached *lut, ge *p, int size)
+{
+	ge p2, tmp;
+	ge_double(&p2, p, &tmp);
+	ge_cache(&lut[0], p);
+	FOR_T(int, i, 1, size) {
+		ge_add(&tmp, &p2, &lut[i-1]);
+		ge_cache(&lut[i], &tmp);
+	}
+}
+
 #define P_W_WIDTH 3 // Affects the size of the stack
 #define B_W_WIDTH 5 // Affects the size of the binary
 #define P_W_SIZE  (1<<(P_W_WIDTH-2))
@@ -1987,15 +2443,7 @@ int crypto_eddsa_check_equation(const u8 signature[64], const u8 public_key[32],
 
 	// look-up table for minus_A
 	ge_cached lutA[P_W_SIZE];
-	{
-		ge minus_A2, tmp;
-		ge_double(&minus_A2, &minus_A, &tmp);
-		ge_cache(&lutA[0], &minus_A);
-		FOR (i, 1, P_W_SIZE) {
-			ge_add(&tmp, &minus_A2, &lutA[i-1]);
-			ge_cache(&lutA[i], &tmp);
-		}
-	}
+	lut_init(lutA, &minus_A, P_W_SIZE);
 
 	// sum = [s]B - [h]A
 	// Merged double and add ladder, fused with sliding
@@ -2033,6 +2481,58 @@ int crypto_eddsa_check_equation(const u8 signature[64], const u8 public_key[32],
 }
 
 // 5-bit signed comb in cached format (Niels coordinates, Z=1)
+#ifdef TKEY_FE_RV32
+static const ge_precomp b_comb_low[8] = {
+	{{0x0397fca7, 0x2a577225, 0x3cb9753e, 0x44b94080,
+	  0xf87fc4e9, 0xaf026228, 0x4f35b0f1, 0x22a820ae,},
+	 {0xc09d4311, 0x82a8189c, 0x5ff54713, 0x2048f392,
+	  0xed80835b, 0xa1764b6c, 0x153b66fe, 0x0ac08019,},
+	 {0x9ea59a31, 0x9c1f3c0f, 0x6a717967, 0xc1b84fba,
+	  0xdb2a2097, 0xb7898aec, 0x9a18b015, 0x76da4ecb,},},
+	{{0x3744966a, 0xfce65368, 0x27bb44ba, 0x855dfd3a,
+	  0xe82cacad, 0xf3caab5c, 0x980e68ea, 0x3e91b142,},
+	 {0x3f91929f, 0xe00edf51, 0x8df02147, 0xa3857b73,
+	  0x8d0cc58c, 0x1937419d, 0x950b56b7, 0x2ea59749,},
+	 {0xfa2eac89, 0x8a94ed06, 0xc0399aad, 0xd41f2006,
+	  0xe4fba43b, 0x37ecbf45, 0x106588d5, 0x43370239,},},
+	{{0x650d54db, 0xf820238a, 0xa453df96, 0xd1f20eff,
+	  0x055cfc00, 0x267d92e5, 0x5e07376b, 0x6cda92a2,},
+	 {0x17a01e90, 0x69c77612, 0x3a67ddc5, 0xf06699f7,
+	  0x42bdc0e7, 0x6cd44576, 0xf762f081, 0x27fb1585,},
+	 {0xef2c584e, 0x30a07bac, 0xc553558b, 0xf6d1bdfa,
+	  0xfb856553, 0x97e0e078, 0xb406a780, 0x1c919aa9,},},
+	{{0x9069080c, 0xa7582a6d, 0x65154b0f, 0x8078ea92,
+	  0x64ad4287, 0xd2c5998a, 0x1e85f30b, 0x5f9b1c78,},
+	 {0xa38a42b2, 0x370cc196, 0x25c4b97e, 0xb5e0d05c,
+	  0xd71b9deb, 0xf1513c25, 0x14b64ab9, 0x2e176aab,},
+	 {0xd754498c, 0x69fc32db, 0x53dca4ca, 0x5ec290ca,
+	  0x547b65a7, 0xad9733b1, 0x1bd844b4, 0x421b7b4f,},},
+	{{0x2c9315d4, 0x5cf2d0e2, 0x3931348d, 0x0eed3a2e,
+	  0x39699841, 0x94e81e66, 0x7e76dbd6, 0x4a392977,},
+	 {0x506e9bd0, 0xaae37317, 0x398cac07, 0x36ba18af,
+	  0x967d8016, 0x6668c2f5, 0x2b279c93, 0x5ebb9c46,},
+	 {0xdcecb61b, 0x4793ae53, 0xa0564380, 0x44af4b6c,
+	  0xfd91224f, 0x450042b7, 0x53347254, 0x1b38894a,},},
+	{{0xff2742b2, 0x62914355, 0x8be73d34, 0x6b2d56b4,
+	  0x9440a345, 0x175e4e8c, 0xf65150ef, 0x0ea336af,},
+	 {0xc7abe7ef, 0x2844dbc0, 0x892111e4, 0x3a768f97,
+	  0xfd0cafd6, 0x0adef30a, 0x4ce0e548, 0x7198392d,},
+	 {0x50b2f4a0, 0xdc1a4a21, 0xe1eb1dc9, 0xe223b635,
+	  0xbe299453, 0x148bb940, 0x116f7802, 0x3874e6f9,},},
+	{{0xee47e550, 0x4db12772, 0xa3edfa41, 0xfa7c69ee,
+	  0x7405d3d0, 0xfc144ea7, 0x3b12b81e, 0x30d2a5c1,},
+	 {0xb99fc163, 0xad0d8a0f, 0x4eac070d, 0x1439cd64,
+	  0x737a8b58, 0x73d7981e, 0x31422e05, 0x2901a426,},
+	 {0x81863404, 0xd9968149, 0x9706f8ad, 0x045f6d1e,
+	  0xe4007dc6, 0x1e6accc4, 0x91d4b492, 0x7a96f9d7,},},
+	{{0x312eced9, 0x9ea81138, 0xfd0e579d, 0x85e9d4d4,
+	  0x23d68e7c, 0x2308ba50, 0xf6983f2f, 0x36b2632b,},
+	 {0xf87a7d71, 0x19a9f3f1, 0x78b0d72d, 0x60077d68,
+	  0x01a59bbf, 0x8921d761, 0xf8407391, 0x262e84e2,},
+	 {0xd3285253, 0xcdc70136, 0x014124e2, 0x7fff27a4,
+	  0xdb2a2df9, 0xe29ac913, 0x66338730, 0x1d3bdc38,},},
+};
+#else
 static const ge_precomp b_comb_low[8] = {
 	{{-6816601,-2324159,-22559413,124364,18015490,
 	  8373481,19993724,1979872,-18549925,9085059,},
@@ -2083,7 +2583,60 @@ static const ge_precomp b_comb_low[8] = {
 	 {-14134701,-4174411,10246585,-14677495,33553567,
 	  -14012935,23366126,15080531,-7969992,7663473,},},
 };
+#endif
 
+#ifdef TKEY_FE_RV32
+static const ge_precomp b_comb_high[8] = {
+	{{0x8df8647c, 0x4e26f181, 0xb11a9fc0, 0x03a11ccc,
+	  0x27a061a0, 0xf4e76296, 0xda43e355, 0x655a7d3a,},
+	 {0xdc3d3fdb, 0xdb81a93c, 0x8d983a49, 0x1e867147,
+	  0x884e483e, 0x1d6fbe3d, 0x869c2f18, 0x424d19e1,},
+	 {0xb0f8498d, 0x64cdcdaf, 0x652bcb58, 0x9d8c92c1,
+	  0xefc9e2e3, 0x04d0d488, 0x77d50dba, 0x2657314a,},},
+	{{0x2426a68f, 0x363efa41, 0x5f765455, 0xccb12f28,
+	  0x1adde5c7, 0xfcf988f4, 0x5ea7469f, 0x20c95a0e,},
+	 {0xed324c1d, 0x66753a8c, 0xf9d0c182, 0x324f7fe6,
+	  0x654fe7f0, 0x2a86b7e4, 0x37d49992, 0x0861cbdc,},
+	 {0x33ef754e, 0x4daad226, 0xd29082e0, 0x3842c31a,
+	  0x3f837d26, 0x6a9d879f, 0xea602599, 0x3234bc1d,},},
+	{{0x2c1f4959, 0x43f675dc, 0x0ee2074e, 0x6136e50a,
+	  0xc801e6ae, 0xa2c5d4f5, 0x9e4dac9d, 0x484981f9,},
+	 {0x2497a514, 0x48308403, 0xbc6dfd10, 0x1052a4fc,
+	  0xffd8597d, 0xf05d4630, 0xcdb9fc94, 0x2ccf0128,},
+	 {0xeea5c048, 0x35649923, 0xe5b3a2d8, 0x4dfc8b51,
+	  0x6e5953f0, 0x526b5e24, 0xaa371f57, 0x34544e75,},},
+	{{0xa77e5e56, 0xa2a3e7e4, 0x847fa48d, 0xeedd7736,
+	  0xdfc4753c, 0x8908bcaa, 0x64ff09e1, 0x27a7c419,},
+	 {0x65a10218, 0xdd9c385d, 0xa090c3ad, 0xdcd87890,
+	  0xd320b5f7, 0x0e137477, 0x0822bd4c, 0x00ec7904,},
+	 {0x9f355d39, 0x4c7e1884, 0xb7867c9d, 0x97f2aa90,
+	  0xa62f408e, 0x1e6b89b6, 0xb9c94ba4, 0x2af97683,},},
+	{{0xe0b5dbba, 0x5babbd6a, 0x9acd7788, 0x96e8b62a,
+	  0x8a4a0dac, 0xf9f4c2df, 0x8db8d33e, 0x7be577c6,},
+	 {0x0a45747b, 0x73e35589, 0xd313b312, 0x6b3897ba,
+	  0xeb3592e5, 0xd490bbd6, 0x5ff27733, 0x63565103,},
+	 {0xe4d73276, 0x815aada9, 0xb32d302f, 0x764f4211,
+	  0x404225f2, 0x6b37c837, 0x50689230, 0x30c8000d,},},
+	{{0x9c166abb, 0x9abc0264, 0x98050fee, 0x1edee39a,
+	  0xed7a0e10, 0x848eab44, 0x7a6d00af, 0x75588195,},
+	 {0x21de6781, 0x49deda95, 0x8ec9d3ec, 0x2fd79f87,
+	  0xc570929d, 0x448cbb08, 0x462933cc, 0x152369a9,},
+	 {0x22775c38, 0x40be5d00, 0xcc146b5f, 0xdd1b0985,
+	  0x565be69f, 0xbdc4bb28, 0x232db50c, 0x79f47698,},},
+	{{0xcea1ca1d, 0x32493429, 0xa3128ed9, 0xb573943f,
+	  0x3df67179, 0x6255ea5c, 0x05a0e820, 0x4e7732ee,},
+	 {0x676c3853, 0xa083801a, 0xb8716e89, 0xd6b01cce,
+	  0xea92f320, 0x6ac39c64, 0x7d22dafa, 0x4b4ee9a5,},
+	 {0x4c58ecfb, 0x1d8bd67d, 0x11935451, 0x1c483517,
+	  0x9eaeab2f, 0x01eb583f, 0x981eaf25, 0x10a123f2,},},
+	{{0xf191a8dc, 0x26788efa, 0xe7263590, 0xe8dfccfc,
+	  0xaa2026d1, 0x157c9362, 0x4a5d144f, 0x4e32caad,},
+	 {0x563adb50, 0xec9b891d, 0x1f671dce, 0x8d78b1db,
+	  0x282d197c, 0x69617115, 0x5573a978, 0x1ae2643a,},
+	 {0x4fcf2434, 0x09636fb7, 0xaf995a40, 0xdd881e20,
+	  0x5f91c2b7, 0xce211a89, 0xfd4900aa, 0x6a50999c,},},
+};
+#else
 static const ge_precomp b_comb_high[8] = {
 	{{33055887,-4431773,-521787,6654165,951411,
 	  -6266464,-5158124,6995613,-5397442,-6985227,},
@@ -2134,14 +2687,26 @@ static const ge_precomp b_comb_high[8] = {
 	 {-3201977,14413268,-12058324,-16417589,-9035655,
 	  -7224648,9258160,1399236,30397584,-5684634,},},
 };
+#endif
 
+#ifdef TKEY_EDDSA_COMB
+// Wide comb, set with crypto_eddsa_comb_use().  16 signed 4-teeth
+// combs with a spacing of 4, comb c covers bits 16c to 16c+15:
+//   comb[c][j] = 2^(16c+12) B
+//              + sum(m = 0..2, (bit m of j ? 1 : -1) * 2^(16c+4m) B)
+// That is 3 doublings instead of 31 for the same 64 additions.
+static const ge_precomp *eddsa_comb = 0;
+#endif
+
+// teeth at i, i + spacing, i + 2*spacing and i + 3*spacing
 static void lookup_add(ge *p, ge_precomp *tmp_c, fe tmp_a, fe tmp_b,
-                       const ge_precomp comb[8], const u8 scalar[32], int i)
+                       const ge_precomp comb[8], const u8 scalar[32], int i,
+                       int spacing)
 {
-	u8 teeth = (u8)((scalar_bit(scalar, i)          ) +
-	                (scalar_bit(scalar, i + 32) << 1) +
-	                (scalar_bit(scalar, i + 64) << 2) +
-	                (scalar_bit(scalar, i + 96) << 3));
+	u8 teeth = (u8)((scalar_bit(scalar, i              )     ) +
+	                (scalar_bit(scalar, i + spacing    ) << 1) +
+	                (scalar_bit(scalar, i + spacing * 2) << 2) +
+	                (scalar_bit(scalar, i + spacing * 3) << 3));
 	u8 high  = teeth >> 3;
 	u8 index = (teeth ^ (high - 1)) & 7;
 	FOR (j, 0, 8) {
@@ -2184,15 +2749,33 @@ static void ge_scalarmult_base(ge *p, const u8 scalar[32])
 	fe_1(tmp_c.Ym);
 	fe_0(tmp_c.T2);
 
-	// Save a double on the first iteration
 	ge_zero(p);
-	lookup_add(p, &tmp_c, tmp_a, tmp_b, b_comb_low , s_scalar, 31);
-	lookup_add(p, &tmp_c, tmp_a, tmp_b, b_comb_high, s_scalar, 31+128);
-	// Regular double & add for the rest
-	for (int i = 30; i >= 0; i--) {
-		ge_double(p, p, &tmp_d);
-		lookup_add(p, &tmp_c, tmp_a, tmp_b, b_comb_low , s_scalar, i);
-		lookup_add(p, &tmp_c, tmp_a, tmp_b, b_comb_high, s_scalar, i+128);
+#ifdef TKEY_EDDSA_COMB
+	if (eddsa_comb != 0) {
+		for (int i = 3; i >= 0; i--) {
+			if (i < 3) {
+				ge_double(p, p, &tmp_d);
+			}
+			FOR_T(int, c, 0, 16) {
+				lookup_add(p, &tmp_c, tmp_a, tmp_b, eddsa_comb + 8*c,
+				           s_scalar, i + 16*c, 4);
+			}
+		}
+	} else
+#endif
+	{
+		// Save a double on the first iteration
+		lookup_add(p, &tmp_c, tmp_a, tmp_b, b_comb_low , s_scalar, 31, 32);
+		lookup_add(p, &tmp_c, tmp_a, tmp_b, b_comb_high, s_scalar, 31+128,
+		           32);
+		// Regular double & add for the rest
+		for (int i = 30; i >= 0; i--) {
+			ge_double(p, p, &tmp_d);
+			lookup_add(p, &tmp_c, tmp_a, tmp_b, b_comb_low , s_scalar, i,
+			           32);
+			lookup_add(p, &tmp_c, tmp_a, tmp_b, b_comb_high, s_scalar,
+			           i+128, 32);
+		}
 	}
 	// Note: we could save one addition at the end if we assumed the
 	// scalar fit in 252 bits.  Which it does in practice if it is
@@ -2205,6 +2788,100 @@ static void ge_scalarmult_base(ge *p, const u8 scalar[32])
 	WIPE_BUFFER(s_scalar);
 }
 
+#ifdef TKEY_EDDSA_COMB
+// Computes the wide comb from the base point.  It is public, so
+// nothing is wiped and the additions are the variable time ones.
+void crypto_eddsa_comb_generate(crypto_eddsa_comb *comb)
+{
+	// Base point, y = 4/5 and x positive
+	static const u8 base_point[32] = {
+		0x58,0x66,0x66,0x66,0x66,0x66,0x66,0x66,
+		0x66,0x66,0x66,0x66,0x66,0x66,0x66,0x66,
+		0x66,0x66,0x66,0x66,0x66,0x66,0x66,0x66,
+		0x66,0x66,0x66,0x66,0x66,0x66,0x66,0x66,
+	};
+	ge_precomp *out = (ge_precomp *)comb->table;
+	ge         teeth[4];   // 2^(16c+4m) B, for m = 0..3
+	ge         entries[8];
+	ge         twice;
+	ge         tmp;
+	ge_cached  cached;
+	fe         z[8], inv, x, y;
+	u8         buf[32];
+
+	// ge_frombytes_neg_vartime() gives -B
+	ge_frombytes_neg_vartime(&teeth[0], base_point);
+	fe_neg(teeth[0].X, teeth[0].X);
+	fe_neg(teeth[0].T, teeth[0].T);
+
+	FOR (c, 0, 16) {
+		FOR (m, 1, 4) {
+			ge_double(&teeth[m], &teeth[m-1], &tmp);
+			FOR (k, 1, 4) {
+				ge_double(&teeth[m], &teeth[m], &tmp);
+			}
+		}
+
+		// All teeth but the last negative, then flip them one by
+		// one by adding twice their value.
+		fe_copy(entries[0].X, teeth[3].X);
+		fe_copy(entries[0].Y, teeth[3].Y);
+		fe_copy(entries[0].Z, teeth[3].Z);
+		fe_copy(entries[0].T, teeth[3].T);
+		FOR (m, 0, 3) {
+			ge_cache(&cached, &teeth[m]);
+			ge_sub(&entries[0], &entries[0], &cached);
+		}
+		FOR (m, 0, 3) {
+			size_t bit = (size_t)1 << m;
+			ge_double(&twice, &teeth[m], &tmp);
+			ge_cache(&cached, &twice);
+			FOR (j, 0, bit) {
+				ge_add(&entries[j | bit], &entries[j], &cached);
+			}
+		}
+
+		// Batch inversion of Z
+		fe_copy(z[0], entries[0].Z);
+		FOR (j, 1, 8) {
+			fe_mul(z[j], z[j-1], entries[j].Z);
+		}
+		fe_invert(inv, z[7]);
+		for (int j = 7; j > 0; j--) {
+			fe_mul(z[j], inv, z[j-1]);
+			fe_mul(inv , inv, entries[j].Z);
+		}
+		fe_copy(z[0], inv);
+
+		// Niels coordinates, fully reduced so the table only has
+		// one representation.
+		FOR (j, 0, 8) {
+			ge_precomp *e = &out[8*c + j];
+			fe_mul(x, entries[j].X, z[j]);
+			fe_mul(y, entries[j].Y, z[j]);
+			fe_add(e->Yp, y, x);
+			fe_sub(e->Ym, y, x);
+			fe_mul(e->T2, x, y);
+			fe_mul(e->T2, e->T2, D2);
+			fe_tobytes(buf, e->Yp);  fe_frombytes(e->Yp, buf);
+			fe_tobytes(buf, e->Ym);  fe_frombytes(e->Ym, buf);
+			fe_tobytes(buf, e->T2);  fe_frombytes(e->T2, buf);
+		}
+
+		// First tooth of the next comb
+		ge_double(&teeth[0], &teeth[3], &tmp);
+		FOR (k, 1, 4) {
+			ge_double(&teeth[0], &teeth[0], &tmp);
+		}
+	}
+}
+
+void crypto_eddsa_comb_use(const crypto_eddsa_comb *comb)
+{
+	eddsa_comb = comb == 0 ? 0 : (const ge_precomp *)comb->table;
+}
+#endif
+
 void crypto_eddsa_scalarbase(u8 point[32], const u8 scalar[32])
 {
 	ge P;
@@ -2336,6 +3013,162 @@ int crypto_eddsa_check(const u8  signature[64], const u8 public_key[32],
 	return crypto_eddsa_check_equation(signature, public_key, h);
 }
 
+// TKey: batch verification
+//
+// With random 128-bit z_i, all signatures are valid if
+//
+//   [8]([sum(z_i * s_i)]B - sum([z_i * h_i]A_i) - sum([z_i]R_i)) == 0
+//
+// and one that isn't makes it fail except with negligible
+// probability.  Like crypto_eddsa_check_equation(), this accepts the
+// same signatures, since both multiply by 8.  All the scalar
+// multiplications share the same doublings (Straus), so each
+// signature only costs its decoding and additions.  If the sum fails,
+// every signature in the batch is checked on its own to tell which.
+#define BATCH_SIZE 8 // Affects the size of the stack
+#define A_W_WIDTH  4 // Affects the size of the stack
+#define A_W_SIZE   (1<<(A_W_WIDTH-2))
+
+static void lut_add(ge *sum, const ge_cached *lut, int digit)
+{
+	if (digit > 0) { ge_add(sum, sum, &lut[ digit / 2]); }
+	if (digit < 0) { ge_sub(sum, sum, &lut[-digit / 2]); }
+}
+
+// Checks up to BATCH_SIZE signatures, from index 'first' in the arrays
+static int check_batch(int *status,
+                       const u8 *const signatures [],
+                       const u8 *const public_keys[],
+                       const u8 *const messages   [],
+                       const size_t    message_sizes[],
+                       size_t nb, size_t first, const u8 random[32])
+{
+	ge_cached lutA[BATCH_SIZE][A_W_SIZE]; // -A_i
+	ge_cached lutR[BATCH_SIZE][P_W_SIZE]; // -R_i
+	slide_ctx a_slide[BATCH_SIZE];
+	slide_ctx r_slide[BATCH_SIZE];
+	size_t    index[BATCH_SIZE]; // of the signatures in the sum
+	u8        h [BATCH_SIZE][32];
+	u8        z [BATCH_SIZE][32];
+	u8        zh[BATCH_SIZE][32];
+	u8        zs[32] = {0};
+	static const u8 zero[32] = {0};
+	size_t    n      = 0;
+	int       result = 0;
+
+	if (nb == 1) { // nothing to share
+		result = crypto_eddsa_check(signatures[first], public_keys[first],
+		                            messages[first], message_sizes[first]);
+		if (status) { status[first] = result; }
+		return result;
+	}
+
+	FOR (k, 0, nb) {
+		const u8 *sig = signatures [first + k];
+		const u8 *pk  = public_keys[first + k];
+		hash_reduce(h[n], sig, 32, pk, 32,
+		            messages[first + k], message_sizes[first + k]);
+
+		// Same checks as crypto_eddsa_check_equation()
+		ge  minus_A, minus_R;
+		u32 s32[8];
+		load32_le_buf(s32, sig + 32, 8);
+		if (ge_frombytes_neg_vartime(&minus_A, pk ) ||
+		    ge_frombytes_neg_vartime(&minus_R, sig) ||
+		    is_above_l(s32)) {
+			result = -1;
+			if (status) { status[first + k] = -1; }
+			continue;
+		}
+		lut_init(lutA[n], &minus_A, A_W_SIZE);
+		lut_init(lutR[n], &minus_R, P_W_SIZE);
+
+		// z = HASH(random, index, signature, h), 128 bits
+		u8 counter[8];
+		crypto_blake2b_ctx ctx;
+		store64_le(counter, first + k);
+		crypto_blake2b_keyed_init(&ctx, 16, random, 32);
+		crypto_blake2b_update(&ctx, counter, 8);
+		crypto_blake2b_update(&ctx, sig, 64);
+		crypto_blake2b_update(&ctx, h[n], 32);
+		crypto_blake2b_final(&ctx, z[n]);
+		ZERO(z[n] + 16, 16);
+
+		crypto_eddsa_mul_add(zh[n], z[n], h[n], zero);
+		crypto_eddsa_mul_add(zs   , z[n], sig + 32, zs);
+		slide_init(&a_slide[n], zh[n]);
+		slide_init(&r_slide[n], z [n]);
+		index[n] = first + k;
+		n++;
+	}
+	if (n == 0) {
+		return result;
+	}
+
+	// sum = [zs]B - sum([zh_i]A_i) - sum([z_i]R_i)
+	slide_ctx s_slide;  slide_init(&s_slide, zs);
+	int i = s_slide.next_check;
+	FOR (k, 0, n) {
+		i = MAX(i, MAX(a_slide[k].next_check, r_slide[k].next_check));
+	}
+	ge sum, tmp;
+	ge_zero(&sum);
+	while (i >= 0) {
+		ge_double(&sum, &sum, &tmp);
+		FOR (k, 0, n) {
+			int a_digit = slide_step(&a_slide[k], A_W_WIDTH, i, zh[k]);
+			int r_digit = slide_step(&r_slide[k], P_W_WIDTH, i, z [k]);
+			lut_add(&sum, lutA[k], a_digit);
+			lut_add(&sum, lutR[k], r_digit);
+		}
+		int s_digit = slide_step(&s_slide, B_W_WIDTH, i, zs);
+		fe t1, t2;
+		if (s_digit > 0) { ge_madd(&sum, &sum, b_window +  s_digit/2, t1, t2); }
+		if (s_digit < 0) { ge_msub(&sum, &sum, b_window + -s_digit/2, t1, t2); }
+		i--;
+	}
+
+	// Compare [8]sum and the zero point
+	u8 check[32];
+	static const u8 zero_point[32] = {1}; // Point of order 1
+	ge_double(&sum, &sum, &tmp);
+	ge_double(&sum, &sum, &tmp);
+	ge_double(&sum, &sum, &tmp);
+	ge_tobytes(check, &sum);
+	if (crypto_verify32(check, zero_point) == 0) {
+		FOR (k, 0, n) {
+			if (status) { status[index[k]] = 0; }
+		}
+		return result;
+	}
+
+	// Fall back to checking one by one
+	FOR (k, 0, n) {
+		size_t j = index[k];
+		int    r = crypto_eddsa_check_equation(signatures[j],
+		                                       public_keys[j], h[k]);
+		if (status) { status[j] = r; }
+		result |= r;
+	}
+	return result;
+}
+
+int crypto_eddsa_check_batch(int            *status,
+                             const u8 *const signatures [],
+                             const u8 *const public_keys[],
+                             const u8 *const messages   [],
+                             const size_t    message_sizes[],
+                             size_t nb, const u8 random[32])
+{
+	int result = 0;
+	for (size_t first = 0; first < nb; first += BATCH_SIZE) {
+		result |= check_batch(status, signatures, public_keys, messages,
+		                      message_sizes, MIN(nb - first, BATCH_SIZE),
+		                      first, random);
+	}
+	return result;
+}
+
 /////////////////////////
 /// EdDSA <--> X25519 ///
 /////////////////////////
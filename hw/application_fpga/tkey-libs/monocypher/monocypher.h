@@ -226,6 +226,19 @@ int crypto_eddsa_check(const uint8_t  signature [64],
                        const uint8_t  public_key[32],
                        const uint8_t *message, size_t message_size);
 
+// TKey: batch verification
+// Returns 0 if all nb signatures are valid, -1 otherwise.  status[i]
+// is set to what crypto_eddsa_check() returns for signature i, unless
+// status is NULL.  random must be 32 unpredictable bytes, new for each
+// call.  Costs less than half of checking one by one from 8
+// signatures.
+int crypto_eddsa_check_batch(int           *status,
+                             const uint8_t *const signatures   [],
+                             const uint8_t *const public_keys  [],
+                             const uint8_t *const messages     [],
+                             const size_t         message_sizes[],
+                             size_t nb, const uint8_t random[32]);
+
 // Conversion to X25519
 void crypto_eddsa_to_x25519(uint8_t x25519[32], const uint8_t eddsa[32]);
 
@@ -241,6 +254,16 @@ int crypto_eddsa_check_equation(const uint8_t signature[64],
                                 const uint8_t public_key[32],
                                 const uint8_t h_ram[32]);
 
+// TKey: wide fixed base comb, only with TKEY_EDDSA_COMB
+// Makes crypto_eddsa_scalarbase(), and thus key pairs and signatures,
+// faster for 12 KiB of RAM.  The table is public, and the same for
+// everyone.  It stays in use until crypto_eddsa_comb_use(NULL).
+typedef struct {
+	uint32_t table[3072];
+} crypto_eddsa_comb;
+void crypto_eddsa_comb_generate(crypto_eddsa_comb *comb);
+void crypto_eddsa_comb_use(const crypto_eddsa_comb *comb);
+
 
 // Chacha20
 // --------
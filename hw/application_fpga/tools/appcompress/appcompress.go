@@ -0,0 +1,230 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+// appcompress compresses a device app binary into the LZ4 block
+// format the firmware decompresses when loading with
+// LOAD_APP_FLAG_COMPRESSED.
+package main
+
+import (
+	"encoding/binary"
+	"errors"
+	"flag"
+	"fmt"
+	"os"
+)
+
+const (
+	minMatch   = 4
+	maxOffset  = 65535
+	hashBits   = 14
+	lastLits   = 5  // The last bytes are always literals
+	matchLimit = 12 // No match may start this close to the end
+)
+
+func usage() {
+	fmt.Printf("Usage: %s [-d] -i infile -o outfile\n", os.Args[0])
+}
+
+func hash(v uint32) uint32 {
+	return (v * 2654435761) >> (32 - hashBits)
+}
+
+func putLen(out []byte, n int) []byte {
+	for n >= 255 {
+		out = append(out, 255)
+		n -= 255
+	}
+
+	return append(out, byte(n))
+}
+
+func putSequence(out []byte, lits []byte, offset int, matchLen int) []byte {
+	token := byte(0)
+
+	if len(lits) >= 15 {
+		token = 15 << 4
+	} else {
+		token = byte(len(lits)) << 4
+	}
+
+	ml := matchLen - minMatch
+	if matchLen > 0 {
+		if ml >= 15 {
+			token |= 15
+		} else {
+			token |= byte(ml)
+		}
+	}
+
+	out = append(out, token)
+	if len(lits) >= 15 {
+		out = putLen(out, len(lits)-15)
+	}
+	out = append(out, lits...)
+
+	if matchLen == 0 {
+		// Last sequence, literals only
+		return out
+	}
+
+	out = append(out, byte(offset), byte(offset>>8))
+	if ml >= 15 {
+		out = putLen(out, ml-15)
+	}
+
+	return out
+}
+
+// compress does a greedy LZ4 block compression of in.
+func compress(in []byte) []byte {
+	var table [1 << hashBits]int
+	out := []byte{}
+	anchor := 0
+
+	for i := range table {
+		table[i] = -1
+	}
+
+	for i := 0; i+matchLimit <= len(in); {
+		v := binary.LittleEndian.Uint32(in[i:])
+		h := hash(v)
+		ref := table[h]
+		table[h] = i
+
+		if ref < 0 || i-ref > maxOffset || binary.LittleEndian.Uint32(in[ref:]) != v {
+			i++
+			continue
+		}
+
+		n := minMatch
+		for i+n < len(in)-lastLits && in[ref+n] == in[i+n] {
+			n++
+		}
+
+		out = putSequence(out, in[anchor:i], i-ref, n)
+		i += n
+		anchor = i
+	}
+
+	return putSequence(out, in[anchor:], 0, 0)
+}
+
+func getLen(in []byte, i *int, n int) (int, error) {
+	for {
+		if *i >= len(in) {
+			return 0, errors.New("truncated length")
+		}
+		b := in[*i]
+		*i++
+		n += int(b)
+		if b != 255 {
+			return n, nil
+		}
+	}
+}
+
+// decompress is the same algorithm as firmware's, used to verify the
+// output.
+func decompress(in []byte) ([]byte, error) {
+	out := []byte{}
+	var err error
+
+	for i := 0; i < len(in); {
+		token := in[i]
+		i++
+
+		lits := int(token >> 4)
+		if lits == 15 {
+			if lits, err = getLen(in, &i, lits); err != nil {
+				return nil, err
+			}
+		}
+
+		if i+lits > len(in) {
+			return nil, errors.New("truncated literals")
+		}
+		out = append(out, in[i:i+lits]...)
+		i += lits
+
+		if i == len(in) {
+			break
+		}
+
+		if i+2 > len(in) {
+			return nil, errors.New("truncated offset")
+		}
+		offset := int(in[i]) | int(in[i+1])<<8
+		i += 2
+
+		ml := int(token & 0x0f)
+		if ml == 15 {
+			if ml, err = getLen(in, &i, ml); err != nil {
+				return nil, err
+			}
+		}
+		ml += minMatch
+
+		if offset == 0 || offset > len(out) {
+			return nil, errors.New("bad offset")
+		}
+
+		from := len(out) - offset
+		for j := 0; j < ml; j++ {
+			out = append(out, out[from+j])
+		}
+	}
+
+	return out, nil
+}
+
+func main() {
+	var inFile string
+	var outFile string
+	var decomp bool
+
+	flag.StringVar(&inFile, "i", "", "Input file.")
+	flag.StringVar(&outFile, "o", "", "Output file.")
+	flag.BoolVar(&decomp, "d", false, "Decompress instead.")
+
+	flag.Usage = usage
+	flag.Parse()
+
+	if inFile == "" || outFile == "" {
+		usage()
+		os.Exit(0)
+	}
+
+	in, err := os.ReadFile(inFile)
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "%v\n", err)
+		os.Exit(1)
+	}
+
+	var out []byte
+	if decomp {
+		out, err = decompress(in)
+		if err != nil {
+			fmt.Fprintf(os.Stderr, "%v\n", err)
+			os.Exit(1)
+		}
+	} else {
+		out = compress(in)
+
+		// Never hand out anything firmware can't restore.
+		check, err := decompress(out)
+		if err != nil || string(check) != string(in) {
+			fmt.Fprintf(os.Stderr, "compression failed to round trip\n")
+			os.Exit(1)
+		}
+
+		fmt.Printf("%v: %d -> %d bytes\n", inFile, len(in), len(out))
+	}
+
+	if err := os.WriteFile(outFile, out, 0o644); err != nil {
+		fmt.Fprintf(os.Stderr, "%v\n", err)
+		os.Exit(1)
+	}
+
+	os.Exit(0)
+}
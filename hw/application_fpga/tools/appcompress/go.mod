@@ -0,0 +1,3 @@
+module appcompress
+
+go 1.23.0
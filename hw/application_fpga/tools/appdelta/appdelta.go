@@ -0,0 +1,219 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+// appdelta creates a delta between the device app already in flash
+// slot 1 and a new version of it, for the firmware to rebuild the new
+// app from when loading with LOAD_APP_FLAG_DELTA.
+package main
+
+import (
+	"encoding/binary"
+	"errors"
+	"flag"
+	"fmt"
+	"os"
+)
+
+const (
+	opLiteral = 0x00
+	opCopy    = 0x01
+
+	keyLen   = 8  // Bytes indexed in base
+	minCopy  = 16 // Shorter matches are sent as literals
+	maxCands = 8  // Positions in base kept per key
+	maxOpLen = 1<<24 - 1
+)
+
+func usage() {
+	fmt.Printf("Usage: %s [-a] -b base -i infile -o outfile\n", os.Args[0])
+}
+
+func put24(out []byte, n int) []byte {
+	return append(out, byte(n), byte(n>>8), byte(n>>16))
+}
+
+func putLiterals(out []byte, lits []byte) []byte {
+	for len(lits) > 0 {
+		n := min(len(lits), maxOpLen)
+		out = append(out, opLiteral)
+		out = put24(out, n)
+		out = append(out, lits[:n]...)
+		lits = lits[n:]
+	}
+
+	return out
+}
+
+func putCopy(out []byte, offset int, n int) []byte {
+	out = append(out, opCopy)
+	out = put24(out, n)
+
+	return put24(out, offset)
+}
+
+func matchLen(base []byte, off int, in []byte, i int) int {
+	n := 0
+	for off+n < len(base) && i+n < len(in) && n < maxOpLen &&
+		base[off+n] == in[i+n] {
+		n++
+	}
+
+	return n
+}
+
+// diff greedily encodes in as copies from base and literals.
+func diff(base []byte, in []byte) []byte {
+	index := map[uint64][]int{}
+
+	for i := 0; i+keyLen <= len(base); i++ {
+		k := binary.LittleEndian.Uint64(base[i:])
+		if len(index[k]) < maxCands {
+			index[k] = append(index[k], i)
+		}
+	}
+
+	var out []byte
+	litStart := 0
+	// Where in base the last copy ended. Small edits in the new
+	// app usually leave the rest of it lined up with base.
+	next := -1
+
+	for i := 0; i < len(in); {
+		bestOff, bestLen := 0, 0
+
+		if next >= 0 && next < len(base) {
+			if n := matchLen(base, next, in, i); n > bestLen {
+				bestOff, bestLen = next, n
+			}
+		}
+
+		if i+keyLen <= len(in) {
+			k := binary.LittleEndian.Uint64(in[i:])
+			for _, off := range index[k] {
+				if n := matchLen(base, off, in, i); n > bestLen {
+					bestOff, bestLen = off, n
+				}
+			}
+		}
+
+		if bestLen < minCopy {
+			i++
+			if next >= 0 {
+				next++
+			}
+			continue
+		}
+
+		out = putLiterals(out, in[litStart:i])
+		out = putCopy(out, bestOff, bestLen)
+		i += bestLen
+		litStart = i
+		next = bestOff + bestLen
+	}
+
+	return putLiterals(out, in[litStart:])
+}
+
+// apply rebuilds the new app from base and delta, like the firmware.
+func apply(base []byte, delta []byte) ([]byte, error) {
+	var out []byte
+
+	for i := 0; i < len(delta); {
+		if len(delta)-i < 4 {
+			return nil, errors.New("truncated operation")
+		}
+
+		op := delta[i]
+		n := int(delta[i+1]) | int(delta[i+2])<<8 | int(delta[i+3])<<16
+		i += 4
+
+		if n == 0 {
+			return nil, errors.New("empty operation")
+		}
+
+		switch op {
+		case opLiteral:
+			if len(delta)-i < n {
+				return nil, errors.New("truncated literal")
+			}
+			out = append(out, delta[i:i+n]...)
+			i += n
+
+		case opCopy:
+			if len(delta)-i < 3 {
+				return nil, errors.New("truncated copy")
+			}
+			off := int(delta[i]) | int(delta[i+1])<<8 | int(delta[i+2])<<16
+			i += 3
+
+			if off > len(base) || n > len(base)-off {
+				return nil, errors.New("copy outside of base")
+			}
+			out = append(out, base[off:off+n]...)
+
+		default:
+			return nil, fmt.Errorf("unknown operation 0x%02x", op)
+		}
+	}
+
+	return out, nil
+}
+
+func main() {
+	var baseFile string
+	var inFile string
+	var outFile string
+	var doApply bool
+
+	flag.StringVar(&baseFile, "b", "", "Base app, the one in flash slot 1.")
+	flag.StringVar(&inFile, "i", "", "Input file.")
+	flag.StringVar(&outFile, "o", "", "Output file.")
+	flag.BoolVar(&doApply, "a", false, "Apply a delta instead.")
+
+	flag.Usage = usage
+	flag.Parse()
+
+	if baseFile == "" || inFile == "" || outFile == "" {
+		usage()
+		os.Exit(0)
+	}
+
+	base, err := os.ReadFile(baseFile)
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "%v\n", err)
+		os.Exit(1)
+	}
+
+	in, err := os.ReadFile(inFile)
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "%v\n", err)
+		os.Exit(1)
+	}
+
+	var out []byte
+	if doApply {
+		out, err = apply(base, in)
+		if err != nil {
+			fmt.Fprintf(os.Stderr, "%v\n", err)
+			os.Exit(1)
+		}
+	} else {
+		out = diff(base, in)
+
+		// Never hand out anything firmware can't restore.
+		check, err := apply(base, out)
+		if err != nil || string(check) != string(in) {
+			fmt.Fprintf(os.Stderr, "delta failed to round trip\n")
+			os.Exit(1)
+		}
+
+		fmt.Printf("%v: %d -> %d bytes\n", inFile, len(in), len(out))
+	}
+
+	if err := os.WriteFile(outFile, out, 0o644); err != nil {
+		fmt.Fprintf(os.Stderr, "%v\n", err)
+		os.Exit(1)
+	}
+
+	os.Exit(0)
+}
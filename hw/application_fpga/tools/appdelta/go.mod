@@ -0,0 +1,3 @@
+module appdelta
+
+go 1.23.0
@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+// Load an app into a TKey, or the Verilator simulation, with
+// tkeyclient and report how long it took.
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tkeyclient.h"
+
+#define APP_MAX 0x20000
+
+static void usage(const char *name)
+{
+	fprintf(stderr,
+		"Usage: %s [-s] [-w] [-c | -d] [-n size] [-u uss] "
+		"[-t timeout_ms] device app\n"
+		"\n"
+		"  -s  Talk to the Verilator simulation pty\n"
+		"  -w  Use windowed loading\n"
+		"  -c  app is LZ4 compressed, needs -n\n"
+		"  -d  app is a delta against flash slot 1, needs -n\n"
+		"  -n  Size of the app in RAM\n"
+		"  -u  File with a 32 byte User Supplied Secret\n"
+		"  -t  Timeout waiting for the TKey, default 1000 ms\n",
+		name);
+}
+
+static size_t readfile(const char *fname, uint8_t *buf, size_t bufsize)
+{
+	FILE *fp = fopen(fname, "rb");
+	size_t n = 0;
+
+	if (fp == NULL) {
+		perror(fname);
+		exit(1);
+	}
+
+	n = fread(buf, 1, bufsize, fp);
+	fclose(fp);
+
+	return n;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv)
+{
+	static uint8_t data[APP_MAX];
+	uint8_t uss[32] = {0};
+	uint8_t digest[32] = {0};
+	struct tkey_app app = {0};
+	struct tkey t;
+	char name0[5], name1[5];
+	uint32_t version = 0;
+	bool windowed = false;
+	int opts = 0;
+	int timeout_ms = 1000;
+	int c = 0;
+
+	while ((c = getopt(argc, argv, "swcdn:u:t:h")) != -1) {
+		switch (c) {
+		case 's':
+			opts |= TKEY_USBMODE;
+			break;
+		case 'w':
+			windowed = true;
+			break;
+		case 'c':
+			app.flags |= TKEY_LOAD_APP_FLAG_COMPRESSED;
+			break;
+		case 'd':
+			app.flags |= TKEY_LOAD_APP_FLAG_DELTA;
+			break;
+		case 'n':
+			app.size = strtoul(optarg, NULL, 0);
+			break;
+		case 'u':
+			if (readfile(optarg, uss, sizeof(uss)) != sizeof(uss)) {
+				fprintf(stderr, "%s: USS must be 32 bytes\n",
+					optarg);
+				return 1;
+			}
+			app.uss = uss;
+			break;
+		case 't':
+			timeout_ms = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return 2;
+		}
+	}
+
+	if (argc - optind != 2) {
+		usage(argv[0]);
+		return 2;
+	}
+
+	app.data = data;
+	app.len = readfile(argv[optind + 1], data, sizeof(data));
+	if (app.flags == 0) {
+		app.size = app.len;
+	} else if (app.size == 0) {
+		fprintf(stderr, "Compressed apps and deltas need -n\n");
+		return 2;
+	}
+
+	if (tkey_open(&t, argv[optind], opts) < 0) {
+		perror(argv[optind]);
+		return 1;
+	}
+	t.timeout_ms = timeout_ms;
+
+	if (tkey_name_version(&t, name0, name1, &version) < 0) {
+		fprintf(stderr, "name/version: %s\n", strerror(errno));
+		return 1;
+	}
+	printf("firmware: %s%s %u\n", name0, name1, version);
+
+	double start = now();
+
+	if (tkey_load_app(&t, &app, windowed, digest) < 0) {
+		fprintf(stderr, "load app: %s\n", strerror(errno));
+		return 1;
+	}
+
+	double secs = now() - start;
+
+	printf("loaded %zu bytes in %.3f s, %.0f bytes/s sent\n", app.len,
+	       secs, app.len / secs);
+	printf("digest: ");
+	for (int i = 0; i < 32; i++) {
+		printf("%02x", digest[i]);
+	}
+	printf("\n");
+
+	tkey_close(&t);
+
+	return 0;
+}
@@ -0,0 +1,561 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+// Host side of the TKey framing protocol, for Linux.
+//
+// Requests are queued with tkey_submit() and written out and matched
+// with their responses by endpoint and frame ID in tkey_poll(), so up
+// to TKEY_IDS requests per endpoint can be in flight at the same time.
+
+#include <asm/termbits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tkeyclient.h"
+
+// The TKey serial port speed
+#define TKEY_SPEED 62500
+
+// USB Mode Protocol modes, see tkey-libs/include/tkey/io.h
+#define MODE_CDC 0x08
+
+size_t tkey_bytelen(enum tkey_cmdlen len)
+{
+	static const size_t bytelen[] = {1, 4, 32, 128};
+
+	return bytelen[len & 3];
+}
+
+static int setup_tty(int fd)
+{
+	struct termios2 tty;
+
+	if (ioctl(fd, TCGETS2, &tty) < 0) {
+		// Not a tty, for instance a socket. Use as is.
+		return errno == ENOTTY ? 0 : -1;
+	}
+
+	// Raw, 8N1, no flow control in software
+	tty.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR |
+			 ICRNL | IXON | IXOFF);
+	tty.c_oflag &= ~OPOST;
+	tty.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+	tty.c_cflag &= ~(CSIZE | PARENB | CBAUD);
+	tty.c_cflag |= CS8 | CLOCAL | CREAD | BOTHER;
+	tty.c_ispeed = TKEY_SPEED;
+	tty.c_ospeed = TKEY_SPEED;
+	tty.c_cc[VMIN] = 0;
+	tty.c_cc[VTIME] = 0;
+
+	return ioctl(fd, TCSETS2, &tty);
+}
+
+// tkey_open opens the TKey at path, a tty like /dev/ttyACM0 or the
+// pty printed by the Verilator simulation. The simulation doesn't
+// have a CH552, so use TKEY_USBMODE in opts to speak the USB Mode
+// Protocol to it directly.
+//
+// Returns 0 on success or -1 with errno set.
+int tkey_open(struct tkey *t, const char *path, int opts)
+{
+	memset(t, 0, sizeof(*t));
+
+	t->fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (t->fd < 0) {
+		return -1;
+	}
+
+	if (setup_tty(t->fd) < 0) {
+		int err = errno;
+
+		close(t->fd);
+		errno = err;
+
+		return -1;
+	}
+
+	t->opts = opts;
+	t->timeout_ms = 1000;
+	t->rx_mode_hdr = (opts & TKEY_USBMODE) ? 2 : 0;
+
+	return 0;
+}
+
+void tkey_close(struct tkey *t)
+{
+	if (t->fd >= 0) {
+		close(t->fd);
+	}
+
+	t->fd = -1;
+}
+
+static int fail(struct tkey *t, int err)
+{
+	t->err = err;
+	errno = err;
+
+	return -1;
+}
+
+// Write as much of the queue as the tty takes without blocking.
+static int txwrite(struct tkey *t)
+{
+	while (t->txstart < t->txend) {
+		ssize_t n =
+		    write(t->fd, &t->tx[t->txstart], t->txend - t->txstart);
+
+		if (n < 0) {
+			if (errno == EAGAIN || errno == EINTR) {
+				return 0;
+			}
+
+			return fail(t, errno);
+		}
+
+		t->txstart += n;
+	}
+
+	t->txstart = 0;
+	t->txend = 0;
+
+	return 0;
+}
+
+// tkey_submit queues req and assigns it the next frame ID on its
+// endpoint. IDs are handed out in order, 0 to 3, so a request can't
+// be submitted until the one sent TKEY_IDS requests ago on the same
+// endpoint is done.
+//
+// A request with noreply set is done directly and its done function
+// isn't called.
+//
+// Returns 0 when queued or -1 with errno EAGAIN if the ID or queue
+// space isn't free yet. Call tkey_poll() and try again.
+int tkey_submit(struct tkey *t, struct tkey_req *req)
+{
+	size_t need = 0;
+	uint8_t id = 0;
+
+	if (t->err != 0) {
+		errno = t->err;
+		return -1;
+	}
+
+	if (req->endpoint >= TKEY_ENDPOINTS || req->len > TKEY_LEN_128) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	id = t->next_id[req->endpoint];
+	if (t->inflight[req->endpoint][id] != NULL) {
+		errno = EAGAIN;
+		return -1;
+	}
+
+	need = 1 + tkey_bytelen(req->len);
+	if (t->opts & TKEY_USBMODE) {
+		need += 2;
+	}
+
+	if (sizeof(t->tx) - t->txend < need) {
+		// Make room at the end
+		memmove(t->tx, &t->tx[t->txstart], t->txend - t->txstart);
+		t->txend -= t->txstart;
+		t->txstart = 0;
+
+		if (sizeof(t->tx) - t->txend < need) {
+			errno = EAGAIN;
+			return -1;
+		}
+	}
+
+	if (t->opts & TKEY_USBMODE) {
+		t->tx[t->txend++] = MODE_CDC;
+		t->tx[t->txend++] = need - 2;
+	}
+
+	// Frame header: id, endpoint, status (unused), length
+	t->tx[t->txend++] = (id << 5) | (req->endpoint << 3) | req->len;
+	memcpy(&t->tx[t->txend], req->cmd, tkey_bytelen(req->len));
+	t->txend += tkey_bytelen(req->len);
+
+	t->next_id[req->endpoint] = (id + 1) % TKEY_IDS;
+
+	req->id = id;
+	req->bad = false;
+	req->rsplen = 0;
+	req->finished = req->noreply;
+
+	if (!req->noreply) {
+		t->inflight[req->endpoint][id] = req;
+	}
+
+	return txwrite(t);
+}
+
+static int dispatch(struct tkey *t)
+{
+	uint8_t hdr = t->frame[0];
+	enum tkey_endpoint endpoint = (hdr >> 3) & 3;
+	uint8_t id = hdr >> 5;
+	struct tkey_req *req = t->inflight[endpoint][id];
+
+	if (req == NULL) {
+		// Response to nothing we sent
+		return fail(t, EPROTO);
+	}
+
+	t->inflight[endpoint][id] = NULL;
+
+	req->bad = (hdr >> 2) & 1;
+	req->rsplen = t->frame_len - 1;
+	memcpy(req->rsp, &t->frame[1], req->rsplen);
+	req->finished = true;
+
+	if (req->done != NULL) {
+		req->done(t, req);
+	}
+
+	return 1;
+}
+
+// Feed one received byte. Returns 1 if a request is done, 0 if not or
+// -1 on error.
+static int rxbyte(struct tkey *t, uint8_t b)
+{
+	if (t->opts & TKEY_USBMODE) {
+		if (t->rx_mode_hdr == 2) {
+			t->rx_mode = b;
+			t->rx_mode_hdr--;
+			return 0;
+		}
+
+		if (t->rx_mode_hdr == 1) {
+			t->rx_left = b;
+			t->rx_mode_hdr = b == 0 ? 2 : 0;
+			return 0;
+		}
+
+		if (--t->rx_left == 0) {
+			t->rx_mode_hdr = 2;
+		}
+
+		if (t->rx_mode != MODE_CDC) {
+			// For instance the firmware setting up the
+			// CH552 endpoints
+			return 0;
+		}
+	}
+
+	if (t->frame_len == 0) {
+		t->frame_need = 1 + tkey_bytelen(b & 3);
+	}
+
+	t->frame[t->frame_len++] = b;
+	if (t->frame_len < t->frame_need) {
+		return 0;
+	}
+
+	int rc = dispatch(t);
+	t->frame_len = 0;
+
+	return rc;
+}
+
+// tkey_poll writes queued requests and reads responses, waiting at
+// most timeout_ms for anything to happen. The done function of every
+// finished request is called from here.
+//
+// Returns the number of requests done, 0 on timeout or -1 on error.
+int tkey_poll(struct tkey *t, int timeout_ms)
+{
+	struct pollfd pfd = {t->fd, POLLIN, 0};
+	uint8_t buf[512];
+	int ndone = 0;
+
+	if (t->err != 0) {
+		errno = t->err;
+		return -1;
+	}
+
+	if (t->txstart < t->txend) {
+		pfd.events |= POLLOUT;
+	}
+
+	int rc = poll(&pfd, 1, timeout_ms);
+	if (rc < 0) {
+		return errno == EINTR ? 0 : fail(t, errno);
+	}
+
+	if (pfd.revents & (POLLERR | POLLNVAL)) {
+		return fail(t, EIO);
+	}
+
+	if ((pfd.revents & POLLOUT) && txwrite(t) < 0) {
+		return -1;
+	}
+
+	if (pfd.revents & (POLLIN | POLLHUP)) {
+		ssize_t n = read(t->fd, buf, sizeof(buf));
+
+		if (n < 0 && errno != EAGAIN && errno != EINTR) {
+			return fail(t, errno);
+		}
+
+		if (n == 0 && (pfd.revents & POLLHUP)) {
+			// The other end is gone
+			return fail(t, EIO);
+		}
+
+		for (ssize_t i = 0; i < n; i++) {
+			rc = rxbyte(t, buf[i]);
+			if (rc < 0) {
+				return -1;
+			}
+			ndone += rc;
+		}
+	}
+
+	return ndone;
+}
+
+static long now_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// tkey_wait polls until req is done or timeout_ms has passed. Other
+// requests finishing meanwhile get their done functions called.
+//
+// Returns 0 when done or -1 with errno ETIMEDOUT or another error.
+int tkey_wait(struct tkey *t, struct tkey_req *req, int timeout_ms)
+{
+	long deadline = now_ms() + timeout_ms;
+
+	while (!req->finished) {
+		long left = deadline - now_ms();
+
+		if (left <= 0) {
+			errno = ETIMEDOUT;
+			return -1;
+		}
+
+		if (tkey_poll(t, left) < 0) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+// tkey_call submits req and waits for its response.
+int tkey_call(struct tkey *t, struct tkey_req *req, int timeout_ms)
+{
+	long deadline = now_ms() + timeout_ms;
+
+	while (tkey_submit(t, req) < 0) {
+		if (errno != EAGAIN) {
+			return -1;
+		}
+
+		if (now_ms() >= deadline) {
+			errno = ETIMEDOUT;
+			return -1;
+		}
+
+		if (tkey_poll(t, deadline - now_ms()) < 0) {
+			return -1;
+		}
+	}
+
+	return tkey_wait(t, req, deadline - now_ms());
+}
+
+// tkey_name_version asks firmware for its name and version.
+int tkey_name_version(struct tkey *t, char name0[5], char name1[5],
+		      uint32_t *version)
+{
+	struct tkey_req req = {0};
+
+	req.endpoint = TKEY_DST_FW;
+	req.len = TKEY_LEN_1;
+	req.cmd[0] = TKEY_FW_CMD_NAME_VERSION;
+
+	if (tkey_call(t, &req, t->timeout_ms) < 0) {
+		return -1;
+	}
+
+	if (req.rsp[0] != TKEY_FW_RSP_NAME_VERSION) {
+		errno = EPROTO;
+		return -1;
+	}
+
+	memcpy(name0, &req.rsp[1], 4);
+	name0[4] = '\0';
+	memcpy(name1, &req.rsp[5], 4);
+	name1[4] = '\0';
+	*version = req.rsp[9] | (req.rsp[10] << 8) | (req.rsp[11] << 16) |
+		   ((uint32_t)req.rsp[12] << 24);
+
+	return 0;
+}
+
+struct load {
+	bool ready;
+	bool bad;
+	uint8_t *digest;
+};
+
+static void load_done(struct tkey *t, struct tkey_req *req)
+{
+	struct load *l = req->arg;
+
+	(void)t;
+
+	if (req->bad || req->rsp[1] != 0) {
+		l->bad = true;
+		return;
+	}
+
+	if (req->rsp[0] == TKEY_FW_RSP_LOAD_APP_DATA_READY) {
+		memcpy(l->digest, &req->rsp[2], 32);
+		l->ready = true;
+	}
+}
+
+// tkey_load_app loads app into firmware waiting for a command and
+// returns the digest firmware computed over it.
+//
+// The data frames are streamed as fast as the TKey takes them: with
+// windowed set, using FW_CMD_LOAD_APP_DATA_WIN which only has every
+// TKEY_LOAD_WINDOW:th frame acknowledged, otherwise using
+// FW_CMD_LOAD_APP_DATA with TKEY_IDS frames in flight.
+//
+// Returns 0 on success or -1 with errno set.
+int tkey_load_app(struct tkey *t, const struct tkey_app *app, bool windowed,
+		  uint8_t digest[32])
+{
+	struct tkey_req reqs[TKEY_IDS] = {0};
+	struct tkey_req req = {0};
+	struct load l = {0};
+	size_t nframes = 0;
+	size_t seq = 0;
+	long progress = 0;
+
+	if (app->len == 0 || app->size == 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	req.endpoint = TKEY_DST_FW;
+	req.len = TKEY_LEN_128;
+	req.cmd[0] = TKEY_FW_CMD_LOAD_APP;
+	req.cmd[1] = app->size;
+	req.cmd[2] = app->size >> 8;
+	req.cmd[3] = app->size >> 16;
+	req.cmd[4] = app->size >> 24;
+	if (app->uss != NULL) {
+		req.cmd[5] = 1;
+		memcpy(&req.cmd[6], app->uss, 32);
+	}
+	req.cmd[38] = app->flags;
+
+	if (tkey_call(t, &req, t->timeout_ms) < 0) {
+		return -1;
+	}
+
+	if (req.rsp[0] != TKEY_FW_RSP_LOAD_APP || req.rsp[1] != 0) {
+		errno = EPROTO;
+		return -1;
+	}
+
+	// Windowed frames use the frame ID as a sequence number
+	// starting from 0.
+	for (int i = 0; i < TKEY_IDS; i++) {
+		if (t->inflight[TKEY_DST_FW][i] != NULL) {
+			errno = EBUSY;
+			return -1;
+		}
+	}
+	t->next_id[TKEY_DST_FW] = 0;
+
+	nframes = (app->len + TKEY_CMD_MAX - 2) / (TKEY_CMD_MAX - 1);
+	l.digest = digest;
+
+	for (int i = 0; i < TKEY_IDS; i++) {
+		reqs[i].finished = true;
+	}
+
+	progress = now_ms();
+
+	while (!l.ready) {
+		if (l.bad) {
+			errno = EPROTO;
+			return -1;
+		}
+
+		if (seq < nframes) {
+			struct tkey_req *r = &reqs[seq % TKEY_IDS];
+			size_t off = seq * (TKEY_CMD_MAX - 1);
+			size_t n = app->len - off;
+			bool last = seq == nframes - 1;
+
+			if (n > TKEY_CMD_MAX - 1) {
+				n = TKEY_CMD_MAX - 1;
+			}
+
+			if (r->finished) {
+				memset(r, 0, sizeof(*r));
+				r->endpoint = TKEY_DST_FW;
+				r->len = TKEY_LEN_128;
+				r->cmd[0] = windowed
+						? TKEY_FW_CMD_LOAD_APP_DATA_WIN
+						: TKEY_FW_CMD_LOAD_APP_DATA;
+				memcpy(&r->cmd[1], &app->data[off], n);
+				r->noreply = windowed && !last &&
+					     (seq % TKEY_LOAD_WINDOW) !=
+						 TKEY_LOAD_WINDOW - 1;
+				r->done = load_done;
+				r->arg = &l;
+
+				if (tkey_submit(t, r) == 0) {
+					seq++;
+					progress = now_ms();
+					continue;
+				}
+
+				if (errno != EAGAIN) {
+					return -1;
+				}
+
+				// Try again after polling. r is
+				// rebuilt, so mark it free.
+				r->finished = true;
+			}
+		}
+
+		int rc = tkey_poll(t, t->timeout_ms);
+		if (rc < 0) {
+			return -1;
+		}
+
+		if (rc > 0) {
+			progress = now_ms();
+		} else if (now_ms() - progress > t->timeout_ms) {
+			errno = ETIMEDOUT;
+			return -1;
+		}
+	}
+
+	return 0;
+}
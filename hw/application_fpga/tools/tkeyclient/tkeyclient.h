@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2025 Tillitis AB <tillitis.se>
+// SPDX-License-Identifier: BSD-2-Clause
+
+#ifndef TKEYCLIENT_H
+#define TKEYCLIENT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Framing protocol, needs to be held synchronized with fw/tk1/proto.h
+// and tkey-libs/include/tkey/proto.h.
+enum tkey_endpoint {
+	TKEY_DST_HW_IFPGA,
+	TKEY_DST_HW_AFPGA,
+	TKEY_DST_FW,
+	TKEY_DST_SW,
+	TKEY_ENDPOINTS,
+};
+
+enum tkey_cmdlen {
+	TKEY_LEN_1,
+	TKEY_LEN_4,
+	TKEY_LEN_32,
+	TKEY_LEN_128,
+};
+
+// Frames in flight per endpoint, one for every value of the 2 bit
+// frame ID.
+#define TKEY_IDS 4
+#define TKEY_CMD_MAX 128
+
+// Firmware commands used here, see fw/tk1/proto.h.
+// clang-format off
+enum tkey_fwcmd {
+	TKEY_FW_CMD_NAME_VERSION	= 0x01,
+	TKEY_FW_RSP_NAME_VERSION	= 0x02,
+	TKEY_FW_CMD_LOAD_APP		= 0x03,
+	TKEY_FW_RSP_LOAD_APP		= 0x04,
+	TKEY_FW_CMD_LOAD_APP_DATA	= 0x05,
+	TKEY_FW_RSP_LOAD_APP_DATA	= 0x06,
+	TKEY_FW_RSP_LOAD_APP_DATA_READY	= 0x07,
+	TKEY_FW_CMD_LOAD_APP_DATA_WIN	= 0x0a,
+	TKEY_FW_RSP_LOAD_APP_DATA_WIN	= 0x0b,
+};
+// clang-format on
+
+#define TKEY_LOAD_WINDOW 4
+#define TKEY_LOAD_APP_FLAG_COMPRESSED 0x01
+#define TKEY_LOAD_APP_FLAG_DELTA 0x02
+
+// Options for tkey_open()
+#define TKEY_USBMODE 0x01 // Speak USB Mode Protocol, like the CH552
+
+struct tkey;
+struct tkey_req;
+
+typedef void (*tkey_done_fn)(struct tkey *t, struct tkey_req *req);
+
+// A request to the TKey. Owned by the caller and must be kept until
+// it is done.
+struct tkey_req {
+	enum tkey_endpoint endpoint;
+	enum tkey_cmdlen len;
+	uint8_t cmd[TKEY_CMD_MAX];
+	// Don't wait for a response, done as soon as it is queued
+	bool noreply;
+	// Called from tkey_poll() when done, may be NULL
+	tkey_done_fn done;
+	void *arg;
+
+	// Filled in by the library
+	uint8_t id;
+	bool finished;
+	// Status bit of the response was set
+	bool bad;
+	size_t rsplen;
+	uint8_t rsp[TKEY_CMD_MAX];
+};
+
+struct tkey {
+	int fd;
+	int opts;
+	int err;
+	// Longest wait for the TKey in the calls doing several
+	// requests. Defaults to a second, raise it for the simulation.
+	int timeout_ms;
+
+	struct tkey_req *inflight[TKEY_ENDPOINTS][TKEY_IDS];
+	uint8_t next_id[TKEY_ENDPOINTS];
+
+	// Queued for writing
+	uint8_t tx[4096];
+	size_t txstart;
+	size_t txend;
+
+	// USB Mode Protocol header bytes left to read, and the
+	// current mode and bytes left of it
+	int rx_mode_hdr;
+	uint8_t rx_mode;
+	uint8_t rx_left;
+
+	uint8_t frame[1 + TKEY_CMD_MAX];
+	size_t frame_len;
+	size_t frame_need;
+};
+
+// The app to send with tkey_load_app()
+struct tkey_app {
+	// What is sent, the app or a compressed stream or delta
+	const uint8_t *data;
+	size_t len;
+	// Size of the app in RAM
+	size_t size;
+	// TKEY_LOAD_APP_FLAG_*
+	uint8_t flags;
+	// User Supplied Secret, NULL if none
+	const uint8_t *uss;
+};
+
+int tkey_open(struct tkey *t, const char *path, int opts);
+void tkey_close(struct tkey *t);
+int tkey_submit(struct tkey *t, struct tkey_req *req);
+int tkey_poll(struct tkey *t, int timeout_ms);
+int tkey_wait(struct tkey *t, struct tkey_req *req, int timeout_ms);
+int tkey_call(struct tkey *t, struct tkey_req *req, int timeout_ms);
+size_t tkey_bytelen(enum tkey_cmdlen len);
+
+int tkey_name_version(struct tkey *t, char name0[5], char name1[5],
+		      uint32_t *version);
+int tkey_load_app(struct tkey *t, const struct tkey_app *app, bool windowed,
+		  uint8_t digest[32]);
+
+#endif